@@ -0,0 +1,255 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "CallGraph.h"
+
+#include <algorithm>
+
+#include <boost/foreach.hpp>
+
+#include "Function.h"
+#include "controlflowgraph/statements/FunctionCall.h"
+
+CallGraph::CallGraph()
+{
+	m_callee_offsets.push_back(0);
+	m_caller_offsets.push_back(0);
+	m_scc_first.push_back(0);
+}
+
+CallGraph::~CallGraph()
+{
+}
+
+void CallGraph::Build(const std::vector<Function*> &functions, const T_ID_TO_FUNCTION_PTR_MAP &function_map,
+		T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP *unresolved_function_calls)
+{
+	const long n = functions.size();
+
+	m_functions = functions;
+	m_function_index.clear();
+	for(long i = 0; i < n; ++i)
+	{
+		m_function_index[m_functions[i]] = i;
+	}
+
+	// Collect the edges, one caller at a time so that they come out sorted by caller.
+	m_edges.clear();
+	m_callee_offsets.assign(n+1, 0);
+	for(long caller = 0; caller < n; ++caller)
+	{
+		m_callee_offsets[caller] = m_edges.size();
+
+		// The edge to each callee, local to this caller.
+		std::map<function_index_type, edge_index_type> edge_to;
+
+		BOOST_FOREACH(FunctionCall *fc, m_functions[caller]->GetUnlinkedFunctionCalls())
+		{
+			T_ID_TO_FUNCTION_PTR_MAP::const_iterator it = function_map.find(fc->GetIdentifier());
+			function_index_type callee = NO_FUNCTION;
+
+			if(it != function_map.end())
+			{
+				callee = GetFunctionIndex(it->second);
+			}
+
+			if(callee == NO_FUNCTION)
+			{
+				// Couldn't resolve it.  Add it to the unresolved call list.
+				unresolved_function_calls->insert(T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP::value_type(fc->GetIdentifier(), fc));
+				continue;
+			}
+
+			std::map<function_index_type, edge_index_type>::iterator eit = edge_to.find(callee);
+			if(eit == edge_to.end())
+			{
+				// First call from caller to callee.
+				eit = edge_to.insert(std::make_pair(callee, (edge_index_type)m_edges.size())).first;
+				m_edges.push_back(CallEdge());
+				m_edges.back().m_caller = caller;
+				m_edges.back().m_callee = callee;
+			}
+
+			m_edges[eit->second].m_call_sites.push_back(fc);
+		}
+	}
+	m_callee_offsets[n] = m_edges.size();
+
+	// Build the caller adjacency by counting the in edges of each Function.
+	m_caller_offsets.assign(n+1, 0);
+	m_caller_edges.resize(m_edges.size());
+	BOOST_FOREACH(const CallEdge &edge, m_edges)
+	{
+		m_caller_offsets[edge.m_callee+1]++;
+	}
+	for(long i = 0; i < n; ++i)
+	{
+		m_caller_offsets[i+1] += m_caller_offsets[i];
+	}
+	std::vector<std::size_t> fill(m_caller_offsets.begin(), m_caller_offsets.end()-1);
+	for(std::size_t e = 0; e < m_edges.size(); ++e)
+	{
+		m_caller_edges[fill[m_edges[e].m_callee]++] = e;
+	}
+
+	FindSCCs();
+}
+
+CallGraph::function_index_type CallGraph::GetFunctionIndex(Function *f) const
+{
+	std::map<Function*, function_index_type>::const_iterator it = m_function_index.find(f);
+
+	if(it == m_function_index.end())
+	{
+		return NO_FUNCTION;
+	}
+
+	return it->second;
+}
+
+void CallGraph::GetCallees(function_index_type f, std::vector<function_index_type> *callees) const
+{
+	for(std::size_t i = m_callee_offsets[f]; i < m_callee_offsets[f+1]; ++i)
+	{
+		callees->push_back(m_edges[GetCalleeEdge(i)].m_callee);
+	}
+}
+
+void CallGraph::GetCallers(function_index_type f, std::vector<function_index_type> *callers) const
+{
+	for(std::size_t i = m_caller_offsets[f]; i < m_caller_offsets[f+1]; ++i)
+	{
+		callers->push_back(m_edges[GetCallerEdge(i)].m_caller);
+	}
+}
+
+void CallGraph::GetSCCMembers(scc_index_type scc, std::vector<function_index_type> *members) const
+{
+	members->insert(members->end(), m_scc_members.begin()+m_scc_first[scc], m_scc_members.begin()+m_scc_first[scc+1]);
+}
+
+bool CallGraph::IsRecursive(function_index_type f) const
+{
+	scc_index_type scc = m_scc_of[f];
+
+	if(m_scc_first[scc+1] - m_scc_first[scc] > 1)
+	{
+		// Part of a cycle of calls through other Functions.
+		return true;
+	}
+
+	// Alone in its component, so only recursive if it calls itself.
+	for(std::size_t i = m_callee_offsets[f]; i < m_callee_offsets[f+1]; ++i)
+	{
+		if(m_edges[GetCalleeEdge(i)].m_callee == f)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void CallGraph::FindSCCs()
+{
+	const long n = m_functions.size();
+
+	m_scc_of.assign(n, -1);
+	m_scc_first.assign(1, 0);
+	m_scc_members.clear();
+
+	// Tarjan's algorithm, with an explicit stack so deep call chains don't overflow ours.
+	std::vector<long> number(n, -1);
+	std::vector<long> lowlink(n, 0);
+	std::vector<char> on_stack(n, 0);
+	std::vector<function_index_type> component_stack;
+	std::vector< std::pair<function_index_type, std::size_t> > search_stack;
+	long next_number = 0;
+
+	for(function_index_type root = 0; root < n; ++root)
+	{
+		if(number[root] != -1)
+		{
+			continue;
+		}
+
+		number[root] = lowlink[root] = next_number++;
+		component_stack.push_back(root);
+		on_stack[root] = 1;
+		search_stack.push_back(std::make_pair(root, m_callee_offsets[root]));
+
+		while(!search_stack.empty())
+		{
+			function_index_type v = search_stack.back().first;
+			std::size_t i = search_stack.back().second;
+
+			if(i < m_callee_offsets[v+1])
+			{
+				// Follow the next edge.
+				search_stack.back().second++;
+				function_index_type w = m_edges[GetCalleeEdge(i)].m_callee;
+				if(number[w] == -1)
+				{
+					number[w] = lowlink[w] = next_number++;
+					component_stack.push_back(w);
+					on_stack[w] = 1;
+					search_stack.push_back(std::make_pair(w, m_callee_offsets[w]));
+				}
+				else if(on_stack[w])
+				{
+					lowlink[v] = std::min(lowlink[v], number[w]);
+				}
+				continue;
+			}
+
+			// Finished with v.
+			search_stack.pop_back();
+			if(!search_stack.empty())
+			{
+				function_index_type parent = search_stack.back().first;
+				lowlink[parent] = std::min(lowlink[parent], lowlink[v]);
+			}
+
+			if(lowlink[v] == number[v])
+			{
+				// v is the root of a component.  Its members are on the component stack above it.
+				scc_index_type scc = m_scc_first.size() - 1;
+				function_index_type w;
+				do
+				{
+					w = component_stack.back();
+					component_stack.pop_back();
+					on_stack[w] = 0;
+					m_scc_of[w] = scc;
+					m_scc_members.push_back(w);
+				} while(w != v);
+				m_scc_first.push_back(m_scc_members.size());
+			}
+		}
+	}
+
+	// Tarjan's algorithm finishes each component after all the components it can reach, so the components come out
+	// in reverse topological order.
+	const long num_sccs = NumSCCs();
+	m_scc_topological_order.resize(num_sccs);
+	for(long c = 0; c < num_sccs; ++c)
+	{
+		m_scc_topological_order[c] = num_sccs - 1 - c;
+	}
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#ifndef CALLGRAPH_H_
+#define CALLGRAPH_H_
+
+#include <string>
+#include <vector>
+#include <map>
+
+class Function;
+class FunctionCall;
+
+/// Map of identifiers to pointers to the Function objects the correspond to.
+typedef std::map< std::string, Function* > T_ID_TO_FUNCTION_PTR_MAP;
+
+/// Map of function call identifiers to unresolved FunctionCall instances.
+typedef std::multimap< std::string, FunctionCall*> T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP;
+
+/**
+ * The function-level call graph of a Program.
+ *
+ * There's one vertex per Function definition and one edge per distinct caller/callee pair, with the list of call
+ * sites making up each edge.  The graph is built from the unresolved FunctionCall statements of the Functions'
+ * statement lists, so it's available before any control flow graphs have been built.
+ *
+ * Functions are identified by a dense index, in the order they were passed to Build().  The caller and callee
+ * adjacency lists are kept in compact offset/edge arrays, and the strongly connected components are found with
+ * Tarjan's algorithm.
+ */
+class CallGraph
+{
+public:
+
+	/// Index of a Function in the call graph.
+	typedef long function_index_type;
+
+	/// Index of an edge in the call graph.
+	typedef long edge_index_type;
+
+	/// Index of a strongly connected component.
+	typedef long scc_index_type;
+
+	/// Function index value meaning "not in the call graph".
+	static const function_index_type NO_FUNCTION = -1;
+
+	/**
+	 * A caller/callee pair.
+	 */
+	struct CallEdge
+	{
+		function_index_type m_caller;
+		function_index_type m_callee;
+
+		/// The statements in the caller which call the callee.  Linking resolves them in place, so these stay
+		/// valid throughout.
+		std::vector<FunctionCall*> m_call_sites;
+	};
+
+	CallGraph();
+	~CallGraph();
+
+	/**
+	 * Build the call graph of @a functions, discarding any previous one.
+	 *
+	 * @param functions  The Functions of the Program.  Each must have had its statement list set.
+	 * @param function_map  The identifier->Function map used to resolve the calls.
+	 * @param[out] unresolved_function_calls  The calls which couldn't be resolved are added to this list.
+	 */
+	void Build(const std::vector<Function*> &functions, const T_ID_TO_FUNCTION_PTR_MAP &function_map,
+			T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP *unresolved_function_calls);
+
+	/// @name Functions.
+	//@{
+	std::size_t NumFunctions() const { return m_functions.size(); };
+	Function* GetFunction(function_index_type f) const { return m_functions[f]; };
+
+	/**
+	 * @return The index of @a f, or NO_FUNCTION if it isn't in the call graph.
+	 */
+	function_index_type GetFunctionIndex(Function *f) const;
+	//@}
+
+	/// @name Edges.
+	//@{
+	std::size_t NumEdges() const { return m_edges.size(); };
+	const CallEdge& GetEdge(edge_index_type e) const { return m_edges[e]; };
+
+	/**
+	 * Get the out edges of Function @a f, i.e. the calls it makes.  Pass each position in [*first, *last) to
+	 * GetCalleeEdge() to get the edge index.
+	 *
+	 * @param f  The calling Function.
+	 * @param[out] first  Set to the first position.
+	 * @param[out] last  Set to one past the last position.
+	 */
+	void GetCalleeEdges(function_index_type f, std::size_t *first, std::size_t *last) const
+	{
+		*first = m_callee_offsets[f];
+		*last = m_callee_offsets[f+1];
+	};
+
+	/**
+	 * Get the in edges of Function @a f, i.e. the calls made to it.  Pass each position in [*first, *last) to
+	 * GetCallerEdge() to get the edge index.
+	 */
+	void GetCallerEdges(function_index_type f, std::size_t *first, std::size_t *last) const
+	{
+		*first = m_caller_offsets[f];
+		*last = m_caller_offsets[f+1];
+	};
+
+	/// The edge indices referred to by GetCalleeEdges().  Since the edges are sorted by caller, this is the identity.
+	edge_index_type GetCalleeEdge(std::size_t i) const { return i; };
+
+	/// The edge indices referred to by GetCallerEdges().
+	edge_index_type GetCallerEdge(std::size_t i) const { return m_caller_edges[i]; };
+
+	/**
+	 * Collect the distinct Functions called by @a f.
+	 */
+	void GetCallees(function_index_type f, std::vector<function_index_type> *callees) const;
+
+	/**
+	 * Collect the distinct Functions which call @a f.
+	 */
+	void GetCallers(function_index_type f, std::vector<function_index_type> *callers) const;
+	//@}
+
+	/// @name Strongly connected components.
+	//@{
+	std::size_t NumSCCs() const { return m_scc_first.size() - 1; };
+
+	/**
+	 * @return The strongly connected component containing @a f.
+	 */
+	scc_index_type GetSCC(function_index_type f) const { return m_scc_of[f]; };
+
+	/**
+	 * Collect the Functions of component @a scc.
+	 */
+	void GetSCCMembers(scc_index_type scc, std::vector<function_index_type> *members) const;
+
+	/**
+	 * @return true if @a f can call itself, directly or through other Functions.
+	 */
+	bool IsRecursive(function_index_type f) const;
+
+	/**
+	 * @return The components in topological order: every component comes before the components it calls.
+	 * Walk it backwards to visit callees before their callers, e.g. to compute bottom-up Function summaries.
+	 */
+	const std::vector<scc_index_type>& GetSCCTopologicalOrder() const { return m_scc_topological_order; };
+	//@}
+
+private:
+
+	/**
+	 * Find the strongly connected components and their topological order.
+	 */
+	void FindSCCs();
+
+	/// The Functions, indexed by function_index_type.
+	std::vector<Function*> m_functions;
+
+	/// Index of each Function in m_functions.
+	std::map<Function*, function_index_type> m_function_index;
+
+	/// The edges, sorted by caller.
+	std::vector<CallEdge> m_edges;
+
+	/// @name Compact adjacency.  The edges of Function f are at positions [offsets[f], offsets[f+1]).
+	//@{
+	std::vector<std::size_t> m_callee_offsets;
+	std::vector<std::size_t> m_caller_offsets;
+	std::vector<edge_index_type> m_caller_edges;
+	//@}
+
+	/// The component of each Function.
+	std::vector<scc_index_type> m_scc_of;
+
+	/// The members of each component are at positions [m_scc_first[c], m_scc_first[c+1]) of m_scc_members.
+	std::vector<std::size_t> m_scc_first;
+	std::vector<function_index_type> m_scc_members;
+
+	std::vector<scc_index_type> m_scc_topological_order;
+};
+
+#endif /* CALLGRAPH_H_ */
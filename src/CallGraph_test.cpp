@@ -0,0 +1,223 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <boost/foreach.hpp>
+
+#include "CallGraph.h"
+#include "Function.h"
+#include "controlflowgraph/statements/FunctionCall.h"
+#include "Location.h"
+
+/**
+ * Test fixture for the CallGraph class.
+ *
+ * The program is:
+ *  - main() calls a() and d().
+ *  - a() calls b(), and b() calls a() back, so they're mutually recursive.  b() also calls c() from two places.
+ *  - c() calls nothing.
+ *  - d() calls itself, and printf(), which isn't defined.
+ *  - e() calls nothing and isn't called.
+ */
+class CallGraphTest : public ::testing::Test
+{
+protected:
+	CallGraphTest() {};
+	virtual ~CallGraphTest() {};
+
+	virtual void SetUp()
+	{
+		const char *names[] = { "main", "a", "b", "c", "d", "e" };
+
+		for(long i = 0; i < NUM_FUNCTIONS; ++i)
+		{
+			m_functions.push_back(new Function(NULL, names[i]));
+			m_function_map[names[i]] = m_functions.back();
+		}
+
+		AddCall(MAIN, "a");
+		AddCall(MAIN, "d");
+		AddCall(A, "b");
+		AddCall(B, "a");
+		AddCall(B, "c");
+		AddCall(B, "c");
+		AddCall(D, "d");
+		AddCall(D, "printf");
+
+		for(long i = 0; i < NUM_FUNCTIONS; ++i)
+		{
+			m_functions[i]->SetStatementList(&m_statement_lists[i]);
+		}
+
+		m_call_graph.Build(m_functions, m_function_map, &m_unresolved);
+	};
+
+	virtual void TearDown()
+	{
+		for(long i = 0; i < NUM_FUNCTIONS; ++i)
+		{
+			BOOST_FOREACH(StatementBase *sbp, m_statement_lists[i])
+			{
+				delete sbp;
+			}
+			delete m_functions[i];
+		}
+	};
+
+	/// Add a call to @a callee at the end of @a caller's statement list.
+	void AddCall(long caller, const std::string &callee)
+	{
+		m_statement_lists[caller].push_back(new FunctionCall(callee, Location(), ""));
+	};
+
+	/// @return The sorted Functions called by @a f.
+	std::vector<CallGraph::function_index_type> Callees(CallGraph::function_index_type f)
+	{
+		std::vector<CallGraph::function_index_type> callees;
+		m_call_graph.GetCallees(f, &callees);
+		std::sort(callees.begin(), callees.end());
+		return callees;
+	};
+
+	/// @return The sorted Functions which call @a f.
+	std::vector<CallGraph::function_index_type> Callers(CallGraph::function_index_type f)
+	{
+		std::vector<CallGraph::function_index_type> callers;
+		m_call_graph.GetCallers(f, &callers);
+		std::sort(callers.begin(), callers.end());
+		return callers;
+	};
+
+	/// @return The sorted list {@a x, @a y}.
+	static std::vector<CallGraph::function_index_type> Pair(CallGraph::function_index_type x,
+			CallGraph::function_index_type y)
+	{
+		std::vector<CallGraph::function_index_type> pair;
+		pair.push_back(std::min(x, y));
+		pair.push_back(std::max(x, y));
+		return pair;
+	};
+
+	enum { MAIN, A, B, C, D, E, NUM_FUNCTIONS };
+
+	std::vector<Function*> m_functions;
+	std::vector<StatementBase*> m_statement_lists[NUM_FUNCTIONS];
+	T_ID_TO_FUNCTION_PTR_MAP m_function_map;
+	T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP m_unresolved;
+	CallGraph m_call_graph;
+};
+
+TEST_F(CallGraphTest, CallersAndCallees)
+{
+	ASSERT_EQ((std::size_t)NUM_FUNCTIONS, m_call_graph.NumFunctions());
+	for(long i = 0; i < NUM_FUNCTIONS; ++i)
+	{
+		EXPECT_EQ(i, m_call_graph.GetFunctionIndex(m_functions[i]));
+		EXPECT_EQ(m_functions[i], m_call_graph.GetFunction(i));
+	}
+
+	// One edge per distinct caller/callee pair.
+	EXPECT_EQ(6U, m_call_graph.NumEdges());
+
+	EXPECT_EQ(Pair(A, D), Callees(MAIN));
+	EXPECT_EQ(std::vector<CallGraph::function_index_type>(1, B), Callees(A));
+	EXPECT_EQ(Pair(A, C), Callees(B));
+	EXPECT_TRUE(Callees(C).empty());
+	EXPECT_EQ(std::vector<CallGraph::function_index_type>(1, D), Callees(D));
+	EXPECT_TRUE(Callees(E).empty());
+
+	EXPECT_TRUE(Callers(MAIN).empty());
+	EXPECT_EQ(Pair(MAIN, B), Callers(A));
+	EXPECT_EQ(std::vector<CallGraph::function_index_type>(1, A), Callers(B));
+	EXPECT_EQ(std::vector<CallGraph::function_index_type>(1, B), Callers(C));
+	EXPECT_EQ(Pair(MAIN, D), Callers(D));
+	EXPECT_TRUE(Callers(E).empty());
+
+	// Both of b()'s calls to c() are on the one edge, and the caller and callee adjacencies agree on it.
+	std::size_t first, last;
+	m_call_graph.GetCallerEdges(C, &first, &last);
+	ASSERT_EQ(1U, last - first);
+	const CallGraph::CallEdge &edge = m_call_graph.GetEdge(m_call_graph.GetCallerEdge(first));
+	EXPECT_EQ(B, edge.m_caller);
+	EXPECT_EQ(C, edge.m_callee);
+	EXPECT_EQ(2U, edge.m_call_sites.size());
+
+	// The call to printf() isn't in the graph.
+	ASSERT_EQ(1U, m_unresolved.size());
+	EXPECT_EQ("printf", m_unresolved.begin()->first);
+}
+
+TEST_F(CallGraphTest, MutualRecursionAndSelfCalls)
+{
+	// a() and b() share a component, everything else is alone in its own.
+	EXPECT_EQ(5U, m_call_graph.NumSCCs());
+	EXPECT_EQ(m_call_graph.GetSCC(A), m_call_graph.GetSCC(B));
+
+	std::vector<CallGraph::function_index_type> members;
+	m_call_graph.GetSCCMembers(m_call_graph.GetSCC(A), &members);
+	std::sort(members.begin(), members.end());
+	EXPECT_EQ(Pair(A, B), members);
+
+	members.clear();
+	m_call_graph.GetSCCMembers(m_call_graph.GetSCC(D), &members);
+	EXPECT_EQ(std::vector<CallGraph::function_index_type>(1, D), members);
+
+	EXPECT_FALSE(m_call_graph.IsRecursive(MAIN));
+	EXPECT_TRUE(m_call_graph.IsRecursive(A));
+	EXPECT_TRUE(m_call_graph.IsRecursive(B));
+	EXPECT_FALSE(m_call_graph.IsRecursive(C));
+	EXPECT_TRUE(m_call_graph.IsRecursive(D));
+	EXPECT_FALSE(m_call_graph.IsRecursive(E));
+}
+
+TEST_F(CallGraphTest, SCCTopologicalOrder)
+{
+	const std::vector<CallGraph::scc_index_type> &order = m_call_graph.GetSCCTopologicalOrder();
+	std::vector<long> position(m_call_graph.NumSCCs(), -1);
+
+	// Every component appears exactly once.
+	ASSERT_EQ(m_call_graph.NumSCCs(), order.size());
+	for(std::size_t i = 0; i < order.size(); ++i)
+	{
+		ASSERT_EQ(-1, position[order[i]]);
+		position[order[i]] = i;
+	}
+
+	// Every caller's component comes before the components of the Functions it calls.
+	for(std::size_t e = 0; e < m_call_graph.NumEdges(); ++e)
+	{
+		const CallGraph::CallEdge &edge = m_call_graph.GetEdge(e);
+		CallGraph::scc_index_type caller_scc = m_call_graph.GetSCC(edge.m_caller);
+		CallGraph::scc_index_type callee_scc = m_call_graph.GetSCC(edge.m_callee);
+
+		if(caller_scc != callee_scc)
+		{
+			EXPECT_LT(position[caller_scc], position[callee_scc]);
+		}
+	}
+
+	EXPECT_LT(position[m_call_graph.GetSCC(MAIN)], position[m_call_graph.GetSCC(A)]);
+	EXPECT_LT(position[m_call_graph.GetSCC(A)], position[m_call_graph.GetSCC(C)]);
+	EXPECT_LT(position[m_call_graph.GetSCC(MAIN)], position[m_call_graph.GetSCC(D)]);
+}
@@ -22,7 +22,9 @@
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <set>
 #include <queue>
+#include <sstream>
 #include <stack>
 #include <typeinfo>
 #include <cstdlib>
@@ -37,14 +39,16 @@
 #include <boost/graph/filtered_graph.hpp>
 #include <boost/graph/iteration_macros.hpp>
 #include <boost/unordered_set.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "debug_utils/debug_utils.hpp"
+#include "debug_utils/output_sink.hpp"
 
 #include "TranslationUnit.h"
 #include "SuccessorTypes.h"
 
 #include "controlflowgraph/statements/statements.h"
-#include "controlflowgraph/statements/ParseHelpers.h"
+#include "controlflowgraph/statements/LabelMap.h"
 #include "controlflowgraph/edges/edge_types.h"
 #include "controlflowgraph/ControlFlowGraph.h"
 #include "controlflowgraph/algorithms/cfg_algs.h"
@@ -52,6 +56,7 @@
 #include "controlflowgraph/algorithms/topological_visit_kahn.h"
 #include "controlflowgraph/visitors/ControlFlowGraphVisitorBase.h"
 #include "controlflowgraph/algorithms/depth_first_traversal.hpp"
+#include "controlflowgraph/algorithms/layered_layout.h"
 #include "controlflowgraph/visitors/WriteGraphvizDotFileVisitor.h"
 
 // For the use of function_control_flow_graph_visitor
@@ -73,6 +78,15 @@ Function::Function(TranslationUnit *parent_tu, const std::string &function_id)
 
 	// Create a new ControlFlowGraph for this function.
 	m_the_cfg = new ControlFlowGraph;
+
+	// The ControlFlowGraph isn't built until something needs it.
+	m_pending_statement_list = NULL;
+	m_fingerprint = 0;
+	m_cfg_is_built = false;
+	m_entry_vertex_desc = NULL;
+	m_entry_vertex_self_edge = NULL;
+	m_exit_vertex_desc = NULL;
+	m_exit_vertex_self_edge = NULL;
 }
 
 Function::~Function()
@@ -85,193 +99,155 @@ std::string Function::GetDefinitionFilePath() const
 {
 	return m_parent_tu->GetFilePath();
 }
-
-bool Function::IsCalled() const
-{
-	// Determine if this function is ever called.
-	// If the first statement (the ENTRY block) has any in-edges
-	// other than its self-edge, it's called by something.
-	return m_entry_vertex_desc->InDegree() > 1;
-}
 
-void Function::Link(const std::map<std::string, Function*> &function_map,
-		T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP *unresolved_function_calls)
+void Function::SetStatementList(const std::vector< StatementBase* > *statement_list)
 {
-	// Iterate over all the vertices in this CFG, looking for FunctionCallUnresolved's.
+	m_pending_statement_list = statement_list;
+	m_fingerprint = ComputeFingerprint(*statement_list);
 
-	boost::graph_traits<ControlFlowGraph>::vertex_iterator vit, vend;
-	boost::tie(vit, vend) = vertices(*m_the_cfg);
-
-	typedef boost::graph_traits<ControlFlowGraph>::vertex_descriptor T_VERTEX_DESC;
-	typedef std::pair<T_VERTEX_DESC, T_VERTEX_DESC> T_VERTEX_DESCRIPTOR_PAIR;
-	std::vector<T_VERTEX_DESCRIPTOR_PAIR> vertex_replacement_info;
-
-	// Visit all vertices in this Function looking for unresolved function calls.
-	for (; vit != vend; vit++)
+	// Note the function calls now, so that the call graph can be known before any control flow graphs are built.
+	m_unlinked_function_calls.clear();
+	BOOST_FOREACH(StatementBase *sbp, *statement_list)
 	{
-		FunctionCallUnresolved *fcu = dynamic_cast<FunctionCallUnresolved*>(*vit);
-
-		if (fcu != NULL)
+		FunctionCall *fc = dynamic_cast<FunctionCall*>(sbp);
+		if(fc != NULL && !fc->IsResolved())
 		{
-			std::map<std::string, Function*>::const_iterator it;
+			m_unlinked_function_calls.push_back(fc);
+		}
+	}
+}
 
-			// We found an unresolved function call.  Try to resolve it.
-			it = function_map.find(fcu->GetIdentifier());
+std::size_t Function::ComputeFingerprint(const std::vector< StatementBase* > &statement_list)
+{
+	std::size_t seed = 0;
 
-			if (it == function_map.end())
-			{
-				// Couldn't resolve it.  Add it to the unresolved call list.
-				unresolved_function_calls->insert(T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP::value_type(fcu->GetIdentifier(), fcu));
-			}
-			else
-			{
-				// Found it.
+	// Number GCC's labels and temporaries by where they first appear in this body, not by where they happened to
+	// fall in the numbering of the translation unit.
+	StatementBase::CompilerNameMap names;
 
-				// Replace the FunctionCallUnresolved with a FunctionCallResolved.  We can't do the replacement here
-				// because the iterators would be invalidated, so we create the replacement vertex
-				// and add them both to the vertex_replacement_info list, which we'll traverse later and
-				// do the actual replacement.
+	BOOST_FOREACH(StatementBase *sbp, statement_list)
+	{
+		boost::hash_combine(seed, sbp->GetStructuralHash(&names));
+	}
 
-				// Create the replacement vertex.
-				FunctionCallResolved *fcr = new FunctionCallResolved(it->second, fcu);
+	return seed;
+}
 
-				// Add the vertexes to the replacement info list.
-				vertex_replacement_info.push_back(std::make_pair(*vit, fcr));
-			}
-		}
+bool Function::BuildControlFlowGraph()
+{
+	if(m_cfg_is_built)
+	{
+		// Already built.
+		return true;
 	}
 
-	// Now replace the unlinked vertices with the linked ones.
-	BOOST_FOREACH(T_VERTEX_DESCRIPTOR_PAIR p, vertex_replacement_info)
+	if(m_pending_statement_list == NULL)
 	{
-		dlog_cfg << "INFO: Replacing Vertex..." << std::endl;
-		m_the_cfg->ReplaceVertex(p.first, p.second);
-		dlog_cfg << "INFO: Replaced Vertex." << std::endl;
-		dlog_cfg << "INFO: Deleting old Vertex..." << std::endl;
-		delete p.first;
-		dlog_cfg << "INFO: Deleted old Vertex." << std::endl;
-
-		// Now add the FunctionCall and Return edges.
-		FunctionCallResolved *fcr = dynamic_cast<FunctionCallResolved*>(p.second);
-		CFGEdgeTypeFunctionCall *call_edge = new CFGEdgeTypeFunctionCall(fcr);
-		CFGEdgeTypeReturn *return_edge = new CFGEdgeTypeReturn(fcr);
-		CFGEdgeTypeFallthrough *function_calls_fallthrough_edge = fcr->GetFirstOutEdgeOfType<CFGEdgeTypeFallthrough>();
-		m_the_cfg->AddEdge(fcr, fcr->GetCalledFunction()->GetEntryVertexDescriptor(), call_edge);
-		// The return edge goes from the called Function's Exit vertex, which is in a different ControlFlowGraph,
-		// to the next vertex after the FunctionCallResolved vertex.
-		ControlFlowGraph *other_cfg = fcr->GetCalledFunction()->GetCFGPointer();
-		other_cfg->AddEdge(fcr->GetCalledFunction()->GetExitVertexDescriptor(),
-				function_calls_fallthrough_edge->Target(), return_edge);
+		std::cerr << "ERROR: No statements to build the CFG of function " << m_function_id << " from." << std::endl;
+		return false;
 	}
-}
 
-long filtered_in_degree(ControlFlowGraph::vertex_descriptor v, bool only_decision_predecessors = false)
-{
-	StatementBase::in_edge_iterator ieit, ieend;
+	bool retval = CreateControlFlowGraph(*m_pending_statement_list);
+	m_pending_statement_list = NULL;
 
-	v->InEdges(&ieit, &ieend);
+	return retval;
+}
 
-	long i = 0;
-	bool saw_function_call_already = false;
-	for (; ieit != ieend; ++ieit)
-	{
-		if ((*ieit)->IsBackEdge())
-		{
-			// Always skip anything marked as a back edge.
-			continue;
-		}
+bool Function::IsCalled() const
+{
+	// Determine if this function is ever called.
+	// If the first statement (the ENTRY block) has any in-edges
+	// other than its self-edge, it's called by something.
+	return m_entry_vertex_desc->InDegree() > 1;
+}
 
-		if(only_decision_predecessors)
-		{
-			// Is the predecessor a decision statement?
-			if(!(*ieit)->Source()->IsDecisionStatement())
-			{
-				continue;
-			}
-		}
+void Function::Link(const std::map<std::string, Function*> &function_map,
+		T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP *unresolved_function_calls)
+{
+	std::vector< FunctionCall* > resolved_calls;
 
-		// Count up all the incoming edges, with two exceptions:
-		// - Ignore Return edges.  They will always have exactly one matching FunctionCallBypass, which
-		//   is what we'll count instead.
-		// - Ignore all but the first CFGEdgeTypeFunctionCall.  The situation here is that we'd be
-		//   looking at a vertex v that's an ENTRY statement, with a predecessor of type FunctionCallResolved.
-		//   Any particular instance of an ENTRY has at most only one valid FunctionCall edge.
-		//   For our current purposes, we only care about this one.
-		if ((dynamic_cast<CFGEdgeTypeReturn*>(*ieit) == NULL)
-				&& (saw_function_call_already == false))
-		{
-			i++;
-		}
+	ResolveCalls(function_map, &resolved_calls, unresolved_function_calls);
 
-		if (dynamic_cast<CFGEdgeTypeFunctionCall*>(*ieit)
-				!= NULL)
-		{
-			// Multiple incoming function calls only count as one for convergence purposes.
-			saw_function_call_already = true;
-		}
+	// Attach the calls to each callee in one batch.
+	std::map< Function*, std::vector< FunctionCall* > > calls_by_callee;
+	BOOST_FOREACH(FunctionCall *fc, resolved_calls)
+	{
+		calls_by_callee[fc->GetCalledFunction()].push_back(fc);
+	}
+	typedef std::pair< Function* const, std::vector< FunctionCall* > > T_CALLEE_AND_CALLS;
+	BOOST_FOREACH(T_CALLEE_AND_CALLS &p, calls_by_callee)
+	{
+		p.first->AttachCalls(p.second);
 	}
-
-	return i;
 }
 
-
-
-ControlFlowGraph::edge_descriptor first_filtered_out_edge(ControlFlowGraph::vertex_descriptor v)
+void Function::ResolveCalls(const std::map<std::string, Function*> &function_map,
+		std::vector< FunctionCall* > *resolved_calls,
+		T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP *unresolved_function_calls)
 {
-	StatementBase::out_edge_iterator ieit, ieend;
-
-	v->OutEdges(&ieit, &ieend);
+	if(!m_cfg_is_built)
+	{
+		// Nothing to link yet.
+		return;
+	}
 
-	bool saw_function_call_already = false;
-	for (; ieit != ieend; ++ieit)
+	// Visit the unresolved function calls we haven't linked yet.  The ones we can't link now stay on the list.
+	std::vector< FunctionCall* > still_unlinked;
+	BOOST_FOREACH(FunctionCall *fc, m_unlinked_function_calls)
 	{
-		if ((*ieit)->IsBackEdge())
+		std::map<std::string, Function*>::const_iterator it;
+
+		// Try to resolve it.
+		it = function_map.find(fc->GetIdentifier());
+
+		if (it == function_map.end())
 		{
-			// Always skip anything marked as a back edge.
-			continue;
+			// Couldn't resolve it, and never will be able to.  Add it to the unresolved call list.
+			if(unresolved_function_calls != NULL)
+			{
+				unresolved_function_calls->insert(T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP::value_type(fc->GetIdentifier(), fc));
+			}
 		}
-
-		// Count up all the incoming edges, with two exceptions:
-		// - Ignore Return edges.  They will always have exactly one matching FunctionCallBypass, which
-		//   is what we'll count instead.
-		// - Ignore all but the first CFGEdgeTypeFunctionCall.  The situation here is that we'd be
-		//   looking at a vertex v that's an ENTRY statement, with a predecessor of type FunctionCallResolved.
-		//   Any particular instance of an ENTRY has at most only one valid FunctionCall edge.
-		//   For our current purposes, we only care about this one.
-		if ((dynamic_cast<CFGEdgeTypeReturn*>(*ieit) == NULL)
-				&& (saw_function_call_already == false))
+		else if (!it->second->IsControlFlowGraphBuilt())
 		{
-			return *ieit;
+			// The called Function exists, but doesn't have an Entry vertex to link to yet.
+			still_unlinked.push_back(fc);
 		}
-
-		if (dynamic_cast<CFGEdgeTypeFunctionCall*>(*ieit)
-				!= NULL)
+		else
 		{
-			// Multiple incoming function calls only count as one for convergence purposes.
-			saw_function_call_already = true;
+			// Found it.  Resolve the call in place.  It keeps its vertex, edges and basic block, and this only
+			// touches our own statement, so it's safe to do while other Functions are doing the same.
+			fc->Resolve(it->second);
+
+			// The FunctionCall and Return edges also touch the callee, so they're left for AttachCalls().
+			resolved_calls->push_back(fc);
 		}
 	}
-
-	return *ieend;
+	m_unlinked_function_calls.swap(still_unlinked);
 }
 
-static long filtered_out_degree(ControlFlowGraph::vertex_descriptor v)
+void Function::AttachCalls(const std::vector< FunctionCall* > &calls_to_this_function)
 {
-	StatementBase::out_edge_iterator eit, eend;
-
-	v->OutEdges(&eit, &eend);
-
-	long i = 0;
-	for (; eit != eend; ++eit)
+	BOOST_FOREACH(FunctionCall *fc, calls_to_this_function)
 	{
-		if ((*eit)->IsBackEdge())
-		{
-			// Skip anything marked as a back edge.
-			continue;
-		}
-		i++;
+		Function *caller = fc->GetOwningFunction();
+
+		// Add the FunctionCall and Return edges.
+		CFGEdgeTypeFunctionCall *call_edge = new CFGEdgeTypeFunctionCall(fc);
+		CFGEdgeTypeReturn *return_edge = new CFGEdgeTypeReturn(fc);
+		CFGEdgeTypeFallthrough *function_calls_fallthrough_edge = fc->GetFirstOutEdgeOfType<CFGEdgeTypeFallthrough>();
+		caller->GetCFGPointer()->AddEdge(fc, m_entry_vertex_desc, call_edge);
+		// The return edge goes from our Exit vertex to the next vertex after the FunctionCall vertex,
+		// which is in the caller's ControlFlowGraph.
+		m_the_cfg->AddEdge(m_exit_vertex_desc, function_calls_fallthrough_edge->Target(), return_edge);
+
+		// Update the cached degrees of the caller's vertex we just added an edge to.
+		caller->m_filtered_degrees.Update(fc);
 	}
-	return i;
+
+	// Our own Entry and Exit vertices only need updating once for the whole batch.
+	m_filtered_degrees.Update(m_entry_vertex_desc);
+	m_filtered_degrees.Update(m_exit_vertex_desc);
 }
 
 using std::cerr;
@@ -383,28 +359,26 @@ public:
 			//return terminate_search;				
 		}
 
-		if (p->IsType<FunctionCallResolved>())
+		FunctionCall *fc = dynamic_cast<FunctionCall*>(p);
+		if ((fc != NULL) && fc->IsResolved())
 		{
 			// This is a function call which has been resolved (i.e. has a link to the
 			// actual Function that's being called).  Track the call context, and 
 			// check if we're going recursive.
-			FunctionCallResolved *fcr;
-
-			fcr = dynamic_cast<FunctionCallResolved*>(p);
 
 			// Assume we're not.
 			m_last_discovered_vertex_is_recursive = false;
 
-			if(m_call_stack->AreWeRecursing(fcr->m_target_function))
+			if(m_call_stack->AreWeRecursing(fc->GetCalledFunction()))
 			{
-				// We're recursing, we need to treat this vertex as if it were a FunctionCallUnresolved.
-				std::cout << "RECURSION DETECTED: Function \"" << fcr->m_target_function << "\"" << std::endl;
+				// We're recursing, we need to treat this vertex as if it were an unresolved FunctionCall.
+				std::cout << "RECURSION DETECTED: Function \"" << fc->GetCalledFunction() << "\"" << std::endl;
 				m_last_discovered_vertex_is_recursive = true;
 			}
 			else
 			{
 				// We're not recursing, push a normal stack frame and do the call.
-				m_call_stack->PushCallStack(new CallStackFrameBase(fcr, fcr->m_target_function->GetCFGPointer()));
+				m_call_stack->PushCallStack(new CallStackFrameBase(fc, fc->GetCalledFunction()->GetCFGPointer()));
 			}
 		}
 
@@ -469,7 +443,7 @@ public:
 		}
 
 		// Handle recursion.
-		// We deal with recursion by deciding here which path to take out of a FunctionCallResolved vertex.
+		// We deal with recursion by deciding here which path to take out of a resolved FunctionCall vertex.
 		// Note that this is currently the only vertex type which can result in recursion.
 		if ((fcb != NULL) && (m_last_discovered_vertex_is_recursive == false))
 		{
@@ -555,7 +529,10 @@ private:
 
 struct filtered_in_degree_functor
 {
-	const long operator()(ControlFlowGraph::vertex_descriptor vd) const { return filtered_in_degree(vd); };
+	const long operator()(ControlFlowGraph::vertex_descriptor vd) const
+	{
+		return vd->GetOwningFunction()->GetFilteredDegreeCache().InDegree(vd);
+	};
 };
 
 void Function::PrintControlFlowGraph(bool cfg_verbose, bool cfg_vertex_ids)
@@ -567,33 +544,49 @@ void Function::PrintControlFlowGraph(bool cfg_verbose, bool cfg_vertex_ids)
 				filtered_in_degree_functor> T_IN_DEGREE_MAP;
 	T_IN_DEGREE_MAP remaining_in_degree_map;
 
-	// Set up the visitor.
-	FunctionCFGVisitor cfg_visitor(*m_the_cfg, m_exit_vertex_desc, cfg_verbose, cfg_vertex_ids);
+	// The visitor follows the function calls, so make sure every Function we can reach has been built and linked.
+	m_parent_tu->GetParentProgram()->MaterializeFunction(this, true);
+
+	// Set up the visitor.  It prints to a large buffer which is written out a buffer-full at a time.
+	output_buffer out(output_sink::standard_output());
+	FunctionCFGVisitor cfg_visitor(*m_the_cfg, m_exit_vertex_desc, cfg_verbose, cfg_vertex_ids, out);
 	topological_visit_kahn(*m_the_cfg, m_entry_vertex_self_edge, cfg_visitor, remaining_in_degree_map);
 }
 
 
 void Function::PrintControlFlowGraphDot(bool cfg_verbose, bool cfg_vertex_ids, const std::string & output_filename)
 {
+	// Only this Function's own graph is drawn, but build the Functions it calls too so its calls get linked.
+	m_parent_tu->GetParentProgram()->MaterializeFunction(this);
+
 	std::clog << "Creating " << output_filename << std::endl;
 
 	std::ofstream outfile(output_filename.c_str());
 
-	// Create the visitor which will insert the GraphViz info into outfile.
-	WriteGraphvizDotFileVisitor visitor(*m_the_cfg, outfile);
+	{
+		output_sink file_sink(outfile);
+		output_buffer out(file_sink);
+		WriteControlFlowGraphDot(out);
+	}
+
+	outfile.close();
+}
+
+void Function::WriteControlFlowGraphDot(std::ostream &out) const
+{
+	// Create the visitor which will insert the GraphViz info into out.
+	WriteGraphvizDotFileVisitor visitor(*m_the_cfg, out);
 
 	// Let the visitor visit all vertices and edges in the graph.
 	improved_depth_first_visit(*m_the_cfg, m_entry_vertex_desc, visitor);
 
 	// Terminate the graph appropriately.
-	outfile << " }" << std::endl;
-	outfile << "}" << std::endl;
-
-	outfile.close();
+	out << " }\n";
+	out << "}\n";
 }
 
 
-void Function::PrintControlFlowGraphBitmap(ToolDot *the_dot, const boost::filesystem::path& output_filename)
+bool Function::PrintControlFlowGraphBitmap(ToolDot *the_dot, const boost::filesystem::path& output_filename)
 {
 	boost::filesystem::path dot_filename;
 
@@ -603,14 +596,157 @@ void Function::PrintControlFlowGraphBitmap(ToolDot *the_dot, const boost::filesy
 	PrintControlFlowGraphDot(true, true, dot_filename.generic_string());
 
 	std::clog << "Compiling " << dot_filename.generic_string() << " to " << output_filename.generic_string() << std::endl;
-	the_dot->CompileDotToPNG(dot_filename.generic_string(), output_filename.generic_string());
+	return the_dot->CompileDotToPNG(dot_filename.generic_string(), output_filename.generic_string());
+}
+
+/**
+ * Convert a Graphviz label to plain lines of text, splitting it at its "\n" escapes and removing the backslashes
+ * from any others.
+ */
+static std::vector<std::string> dot_label_to_lines(const std::string &dot_label)
+{
+	std::vector<std::string> lines(1);
+
+	for(std::string::size_type i = 0; i < dot_label.size(); ++i)
+	{
+		if((dot_label[i] == '\\') && (i+1 < dot_label.size()))
+		{
+			++i;
+			if((dot_label[i] == 'n') || (dot_label[i] == 'l') || (dot_label[i] == 'r'))
+			{
+				lines.push_back(std::string());
+				continue;
+			}
+		}
+		lines.back() += dot_label[i];
+	}
+
+	return lines;
 }
 
+void Function::CollectDrawnGraph(std::vector< ControlFlowGraph::vertex_descriptor > *vertices,
+		std::vector< ControlFlowGraph::edge_descriptor > *edges) const
+{
+	std::set<ControlFlowGraph::vertex_descriptor> discovered;
+	std::vector<ControlFlowGraph::vertex_descriptor> worklist;
+
+	// Collect the vertices reachable from Entry within this Function, skipping the same edges as
+	// WriteGraphvizDotFileVisitor.
+	worklist.push_back(m_entry_vertex_desc);
+	while(!worklist.empty())
+	{
+		ControlFlowGraph::vertex_descriptor u = worklist.back();
+		worklist.pop_back();
+
+		if(!discovered.insert(u).second)
+		{
+			continue;
+		}
+		vertices->push_back(u);
 
-class LabelMap : public std::map< std::string, ControlFlowGraph::vertex_descriptor>
+		StatementBase::out_edge_iterator ei, eend;
+		u->OutEdges(&ei, &eend);
+		for(; ei != eend; ++ei)
+		{
+			CFGEdgeTypeBase *e = *ei;
+			if(e->IsType<CFGEdgeTypeFunctionCall>() || e->IsType<CFGEdgeTypeReturn>() || e->Target()->IsType<Entry>()
+					|| e->Source()->IsType<Exit>())
+			{
+				continue;
+			}
+			worklist.push_back(e->Target());
+		}
+	}
+
+	// Now the edges between them, in the order the vertices were found so the result doesn't depend on where in
+	// memory the statements are.
+	BOOST_FOREACH(ControlFlowGraph::vertex_descriptor u, *vertices)
+	{
+		StatementBase::out_edge_iterator ei, eend;
+		u->OutEdges(&ei, &eend);
+		for(; ei != eend; ++ei)
+		{
+			CFGEdgeTypeBase *e = *ei;
+			if(e->IsType<CFGEdgeTypeFunctionCall>() || e->IsType<CFGEdgeTypeReturn>() || e->Target()->IsType<Entry>()
+					|| e->Source()->IsType<Exit>())
+			{
+				continue;
+			}
+			edges->push_back(e);
+		}
+	}
+}
+
+bool Function::PrintControlFlowGraphSVG(const boost::filesystem::path& output_filename) const
 {
+	LayeredLayout layout;
+	std::map<ControlFlowGraph::vertex_descriptor, long> layout_vertex;
+	std::vector<ControlFlowGraph::vertex_descriptor> vertices;
+	std::vector<ControlFlowGraph::edge_descriptor> edges;
+
+	CollectDrawnGraph(&vertices, &edges);
+
+	BOOST_FOREACH(ControlFlowGraph::vertex_descriptor u, vertices)
+	{
+		LayeredLayout::VertexAttributes attributes;
+		std::ostringstream label;
+		label << u->GetIndex() << " " << u->GetStatementTextDOT() << "\\n" << u->GetLocation().asLineColumn();
+		attributes.m_label_lines = dot_label_to_lines(label.str());
+		attributes.m_color = u->GetDotSVGColor();
+		attributes.m_shape = u->GetShapeTextDOT();
+		layout_vertex[u] = layout.AddVertex(attributes);
+	}
+
+	BOOST_FOREACH(ControlFlowGraph::edge_descriptor e, edges)
+	{
+		LayeredLayout::EdgeAttributes attributes;
+		std::vector<std::string> label_lines = dot_label_to_lines(e->GetDotLabel());
+		attributes.m_label = label_lines.front();
+		attributes.m_color = e->GetDotSVGColor();
+		attributes.m_style = e->GetDotStyle();
+		layout.AddEdge(layout_vertex[e->Source()], layout_vertex[e->Target()], e->IsBackEdge(), attributes);
+	}
+
+	layout.Layout();
+
+	std::ofstream outfile(output_filename.generic_string().c_str());
+	layout.WriteSVG(outfile, m_function_id);
+	outfile.close();
+
+	if(outfile.fail())
+	{
+		std::cerr << "ERROR: Couldn't write \"" << output_filename.generic_string() << "\"" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+void Function::WriteControlFlowGraphSignature(std::ostream &out) const
+{
+	std::map<ControlFlowGraph::vertex_descriptor, long> local_index;
+	std::vector<ControlFlowGraph::vertex_descriptor> vertices;
+	std::vector<ControlFlowGraph::edge_descriptor> edges;
+
+	CollectDrawnGraph(&vertices, &edges);
+
+	// Each Function's ControlFlowGraph numbers its own vertices, and the renderers show those indices in the vertex
+	// labels, so they're part of the signature.  Edges refer to their endpoints by the order they were found.
+	out << m_function_id << "\n";
+	BOOST_FOREACH(ControlFlowGraph::vertex_descriptor u, vertices)
+	{
+		long index = local_index.size();
+		local_index[u] = index;
+		out << "v\t" << u->GetIndex() << "\t" << u->GetStatementTextDOT() << "\t" << u->GetLocation().asLineColumn() << "\t"
+				<< u->GetDotSVGColor() << "\t" << u->GetShapeTextDOT() << "\n";
+	}
+	BOOST_FOREACH(ControlFlowGraph::edge_descriptor e, edges)
+	{
+		out << "e\t" << local_index[e->Source()] << "\t" << local_index[e->Target()] << "\t" << e->GetDotLabel()
+				<< "\t" << e->GetDotSVGColor() << "\t" << e->GetDotStyle() << "\t" << e->IsBackEdge() << "\n";
+	}
+}
 
-};
 
 bool Function::CreateControlFlowGraph(const std::vector< StatementBase* > &statement_list)
 {
@@ -618,13 +754,13 @@ bool Function::CreateControlFlowGraph(const std::vector< StatementBase* > &state
 	ControlFlowGraph::vertex_descriptor prev_vertex;
 	bool prev_vertex_ended_basic_block = false;
 
-	// A list of basic block leader info.
-	std::vector< BasicBlockLeaderInfo > list_of_leader_info;
-	std::vector< ControlFlowGraph::vertex_descriptor > list_of_statements_with_no_in_edge_yet;
-	std::vector< ControlFlowGraph::vertex_descriptor > list_of_unlinked_flow_control_statements;
+	// What we find out about each statement as we insert it, in statement list order.
+	std::vector< StatementFinalizationInfo > statement_info;
 
 	dlog_cfg << "Creating CFG for Function \"" << m_function_id << "\"" << std::endl;
 
+	m_unlinked_function_calls.clear();
+
 	// Create ENTRY and EXIT vertices.
 	Entry *entry_ptr = new Entry(Location("[" + GetDefinitionFilePath() + " : 0]"));
 	Exit *exit_ptr = new Exit(Location("[" + GetDefinitionFilePath() + " : 0]"));
@@ -637,20 +773,30 @@ bool Function::CreateControlFlowGraph(const std::vector< StatementBase* > &state
 	m_the_cfg->AddVertex(exit_ptr);
 	m_exit_vertex_desc = exit_ptr;
 
-	// Add EXIT to the label map, so that ReturnUnlinked instances can find it.
+	// Add EXIT to the label map, so that return statements can find it.
 	label_map["EXIT"] = m_exit_vertex_desc;
 
 	prev_vertex = m_entry_vertex_desc;
 
+	statement_info.reserve(statement_list.size());
+
 	// Add all the statements to the Function's CFG.
 	BOOST_FOREACH(StatementBase *sbp, statement_list)
 	{
 		// Add this Statement to the Control Flow Graph.
 		ControlFlowGraph::vertex_descriptor vid;
+		unsigned int flags = 0;
 		sbp->SetOwningFunction(this);
 		m_the_cfg->AddVertex(sbp);
 		vid = sbp;
 
+		FunctionCall *fc = dynamic_cast<FunctionCall*>(sbp);
+		if((fc != NULL) && !fc->IsResolved())
+		{
+			// Link() will need to resolve this.
+			m_unlinked_function_calls.push_back(fc);
+		}
+
 		// Find all the label definitions in the function.
 		if(sbp->IsType<Label>())
 		{
@@ -664,6 +810,19 @@ bool Function::CreateControlFlowGraph(const std::vector< StatementBase* > &state
 			}
 			label_map[lp->GetIdentifier()] = vid;
 			dlog_cfg << "Added label " << lp->GetIdentifier() << std::endl;
+
+			if(lp->IsCompilerGenerated())
+			{
+				// Compiler-generated labels (i.e. "<D.1234>") aren't needed once they've been linked to.
+				flags |= StatementFinalizationInfo::REDUNDANCY_CANDIDATE;
+			}
+		}
+		else if(sbp->IsType<Goto>())
+		{
+			// Gotos aren't needed once they've been linked.  They're removed before the back edges are found, so a loop
+			// closed by a Goto gets its back edge, and any Impossible way out, from the statement before the Goto.
+			// A Goto which is the source of an Impossible edge to an orphaned leader isn't redundant, and stays.
+			flags |= StatementFinalizationInfo::REDUNDANCY_CANDIDATE;
 		}
 
 		// See what kind of edge we need to add.
@@ -678,22 +837,20 @@ bool Function::CreateControlFlowGraph(const std::vector< StatementBase* > &state
 			// The previous vertex did end its basic block.  This means it was a control transfer statement, such as an 'if', 'switch', or 'goto',
 			// and that this vertex is a block leader.
 			// We therefore don't add an edge into this statement, because the only way we'll get here is by an explicit jump via a
-			// similar flow control statement.  This should be taken care of when we do the Label linking.  We'll add this vertex to a "watch list"
-			// and check it at the end to make sure it has such an in-edge.
-			list_of_statements_with_no_in_edge_yet.push_back(vid);
-
-			// Record the basic block leaders.  We also capture the vertex which ended the immediately-preceding basic block, in case we
-			// end up with no control transfers to this block.  In that case, we'll add an Impossible edge between the two to maintain
+			// similar flow control statement.  This should be taken care of when we do the Label linking.  We'll flag this vertex
+			// as a basic block leader and check it at the end to make sure it has such an in-edge.  If it doesn't, FinalizeControlFlowGraph()
+			// will add an Impossible edge from the immediately preceding statement, which ended the previous basic block, to maintain
 			// the invariant that EXIT post-dominates all vertices of the function.
-			list_of_leader_info.push_back(BasicBlockLeaderInfo(vid, prev_vertex));
+			flags |= StatementFinalizationInfo::BLOCK_LEADER;
 		}
 
 		// Did the current statement end its basic block?
-		if(sbp->IsType<FlowControlUnlinked>())
+		FlowControlBase *fcb = dynamic_cast<FlowControlBase*>(sbp);
+		if((fcb != NULL) && !fcb->IsLinked())
 		{
 			// It did, by its nature of being a flow control statement.
 			// Note that for our purposes here, FunctionCalls do not count as flow control statements.
-			list_of_unlinked_flow_control_statements.push_back(vid);
+			flags |= StatementFinalizationInfo::UNLINKED_FLOW_CONTROL;
 			prev_vertex_ended_basic_block = true;
 		}
 		else
@@ -701,6 +858,8 @@ bool Function::CreateControlFlowGraph(const std::vector< StatementBase* > &state
 			prev_vertex_ended_basic_block = false;
 		}
 
+		statement_info.push_back(StatementFinalizationInfo(vid, flags));
+
 		// Now this vertex is the previous vertex.
 		prev_vertex = vid;
 	}
@@ -718,46 +877,36 @@ bool Function::CreateControlFlowGraph(const std::vector< StatementBase* > &state
 	// Now we must link the basic blocks together.
 	//
 
-	// Link the FlowControlUnlinked-derived statements (i.e. link jumps to their targets).
-	dlog_cfg << "INFO: Linking FlowControlUnlinked-derived statements." << std::endl;
-	BOOST_FOREACH(ControlFlowGraph::vertex_descriptor vd, list_of_unlinked_flow_control_statements)
+	// Link the unlinked flow control statements (i.e. link jumps to their targets).  This is done in place, so the
+	// statements keep their vertices and the edges we've already added.
+	dlog_cfg << "INFO: Linking flow control statements." << std::endl;
+	BOOST_FOREACH(const StatementFinalizationInfo &info, statement_info)
 	{
-		FlowControlUnlinked *fcl = dynamic_cast<FlowControlUnlinked*>(vd);
-		dlog_cfg << "INFO: Linking " << typeid(*fcl).name() << std::endl;
-		StatementBase* replacement_statement = fcl->ResolveLinks(*m_the_cfg, vd, label_map);
+		if(!info.Is(StatementFinalizationInfo::UNLINKED_FLOW_CONTROL))
+		{
+			continue;
+		}
+
+		FlowControlBase *fcb = dynamic_cast<FlowControlBase*>(info.m_vertex);
+		dlog_cfg << "INFO: Linking " << typeid(*fcb).name() << std::endl;
 
-		if(replacement_statement != NULL)
+		if(fcb->ResolveLinks(*m_the_cfg, label_map))
 		{
-			// The ResolveLinks call succeeded.  Replace the *Unlinked() class instance with a suitable linked instance.
-			dlog_cfg << "INFO: Linked " << typeid(*fcl).name() << std::endl;
-			//cfg.GetT_CFG()[vd].m_statement = replacement_statement;
-			//delete fcl;
-			//cfg.ReplaceStatementPtr(vd, replacement_statement);
-			/// @todo This is probably wrong, it probably invalidates the iterator.
-			m_the_cfg->ReplaceVertex(vd, replacement_statement);
+			dlog_cfg << "INFO: Linked " << typeid(*fcb).name() << std::endl;
 		}
 		else
 		{
-			// The ResolveLinks call failed.  Not sure we can do much here, but we won't delete the FlowControlUnlinked object since
-			// we don't have anything to replace it with.
+			// The ResolveLinks call failed.  Not sure we can do much here, the statement just stays unlinked.
 			dlog_cfg << "ERROR: ResolveLinks() call failed." << std::endl;
 		}
 	}
 	dlog_cfg << "INFO: Linking complete." << std::endl;
 
-	// Now we have to add Impossible in edges for any leader vertices which we haven't already linked above.
-	// This happens in the following cases:
-	//  - Infinite loops
-	//  - Dead code that's been "unlinked" by gcc before we get a chance to look at it.
-	dlog_cfg << "INFO: Adding impossible edges." << std::endl;
-	AddImpossibleEdges(*m_the_cfg, list_of_leader_info);
-	dlog_cfg << "INFO: Impossible edge addition complete." << std::endl;
-
-
-	dlog_cfg << "INFO: Checking for unreachable code." << std::endl;
-	std::vector< ControlFlowGraph::vertex_descriptor > statements_with_no_in_edge;
-	CheckForNoInEdges(*m_the_cfg, list_of_statements_with_no_in_edge_yet, &statements_with_no_in_edge);
-	dlog_cfg << "INFO: Check complete." << std::endl;
+	// Every jump now has its edge, so we can finish off the graph in a single walk over the statements.  Linking has to be
+	// complete before this, since a leader's in edges can come from jumps anywhere in the function.
+	dlog_cfg << "INFO: Finalizing CFG." << std::endl;
+	FinalizeControlFlowGraph(statement_info);
+	dlog_cfg << "INFO: Finalization complete." << std::endl;
 
 	// Add self edges to the ENTRY and EXIT vertices.
 	m_entry_vertex_self_edge = new CFGEdgeTypeImpossible;
@@ -765,64 +914,73 @@ bool Function::CreateControlFlowGraph(const std::vector< StatementBase* > &state
 	m_exit_vertex_self_edge = new CFGEdgeTypeImpossible;
 	m_the_cfg->AddEdge(m_exit_vertex_desc, m_exit_vertex_desc, m_exit_vertex_self_edge);
 
+	// Finding the back edges needs a search over the whole graph, so it can't be folded into the walk above.
 	dlog_cfg << "INFO: Fixing up back edges." << std::endl;
-	FixupBackEdges(m_the_cfg, m_entry_vertex_desc);
+	FixupBackEdges(m_the_cfg, m_entry_vertex_desc, m_exit_vertex_desc, &m_loops);
 	dlog_cfg << "INFO: Fix up complete." << std::endl;
 
-	dlog_cfg << "INFO: Removing redundant nodes." << std::endl;
-	RemoveRedundantNodes(m_the_cfg);
-	dlog_cfg << "INFO: Redundant node removal complete." << std::endl;
+	// The graph is now in its final form, except for any linking.  Cache the filtered in and out degrees.
+	m_filtered_degrees.Compute(*m_the_cfg);
 
-	return true;
-}
-
-void Function::AddImpossibleEdges(ControlFlowGraph & cfg, std::vector<BasicBlockLeaderInfo> & leader_info_list)
-{
-	BOOST_FOREACH(BasicBlockLeaderInfo p, leader_info_list)
-	{
-		// Check if the leader has been linked.
-		long in_degree;
+	// Collapse the straight-line runs of statements into basic blocks.
+	m_basic_blocks.Build(*m_the_cfg, m_entry_vertex_desc);
+	dlog_cfg << "INFO: " << m_the_cfg->NumVertices() << " vertices collapsed into "
+			<< m_basic_blocks.NumBlocks() << " basic blocks." << std::endl;
 
-		in_degree = p.m_leader->InDegree();
+	// Project the blocks down to what call reachability needs.
+	m_reachability_skeleton.Build(*m_the_cfg, m_basic_blocks, m_exit_vertex_desc);
+	dlog_cfg << "INFO: Reachability skeleton has " << m_reachability_skeleton.NumVertices() << " vertices and "
+			<< m_reachability_skeleton.NumEdges() << " edges." << std::endl;
 
-		if(in_degree != 0)
-		{
-			// It's been linked, skip it.
-			continue;
-		}
+	// Find the dominators and post-dominators now too, rather than on first use, so they're never computed while
+	// other threads might be reading them.
+	m_dominator_tree.Compute(*m_the_cfg, m_entry_vertex_desc, false);
+	m_post_dominator_tree.Compute(*m_the_cfg, m_exit_vertex_desc, true);
+
+	m_cfg_is_built = true;
+
+	return true;
+}
 
-		// Link it to its immediate predecessor with an Impossible edge.
-		m_the_cfg->AddEdge(p.m_immediate_predecessor, p.m_leader, new CFGEdgeTypeImpossible);
-	}
-}
-
-bool Function::CheckForNoInEdges(ControlFlowGraph & cfg,
-		std::vector< ControlFlowGraph::vertex_descriptor > &list_of_statements_with_no_in_edge_yet,
-		std::vector< ControlFlowGraph::vertex_descriptor > *output)
+void Function::FinalizeControlFlowGraph(const std::vector< StatementFinalizationInfo > &statement_info)
 {
-	bool retval = false;
+	long num_removed = 0;
 
-	BOOST_FOREACH(ControlFlowGraph::vertex_descriptor vd, list_of_statements_with_no_in_edge_yet)
+	for(std::size_t i = 0; i < statement_info.size(); ++i)
 	{
-		long in_degree;
+		const StatementFinalizationInfo &info = statement_info[i];
 
-		in_degree = vd->InDegree();
+		if(info.Is(StatementFinalizationInfo::BLOCK_LEADER) && (info.m_vertex->InDegree() == 0))
+		{
+			// Compose the message first so it's written in one piece, since other Functions may be being built
+			// concurrently.
+			std::cerr << ("WARNING: CFG of function " + GetIdentifier() + " is not connected.\n");
+		}
 
-		if(in_degree == 0)
+		// If the next statement is a leader which nothing jumps to, link it to us with an Impossible edge.  This happens in
+		// the following cases:
+		//  - Infinite loops
+		//  - Dead code that's been "unlinked" by gcc before we get a chance to look at it.
+		// This has to be done before we check whether we're redundant, so that we're still around to be its source.
+		if((i+1 < statement_info.size()) && statement_info[i+1].Is(StatementFinalizationInfo::BLOCK_LEADER)
+				&& (statement_info[i+1].m_vertex->InDegree() == 0))
 		{
-			std::cerr << "WARNING: CFG of function " << GetIdentifier() << " is not connected." << std::endl;
-			output->push_back(vd);
+			m_the_cfg->AddEdge(info.m_vertex, statement_info[i+1].m_vertex, new CFGEdgeTypeImpossible);
+		}
 
-			// We found a statement with no in edges.
-			retval = true;
+		// Removing a vertex doesn't change the degree of any other vertex, so there's no need to look at the
+		// rest of the graph to do this.
+		if(info.Is(StatementFinalizationInfo::REDUNDANCY_CANDIDATE) && RemoveIfRedundant(m_the_cfg, info.m_vertex))
+		{
+			++num_removed;
 		}
 	}
 
-	return retval;
+	dlog_cfg << "INFO: Redundant vertices removed: " << num_removed << std::endl;
 }
 
-void Function::DumpCFG()
+void Function::DumpCFG()
 {
-	/// @todo Implement.
-}
+	/// @todo Implement.
+}
 
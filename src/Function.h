@@ -20,19 +20,25 @@
 #ifndef FUNCTION_H
 #define FUNCTION_H
  
+#include <iosfwd>
 #include <string>
 #include <vector>
 
 #include <boost/filesystem.hpp>
 
 #include "controlflowgraph/ControlFlowGraph.h"
+#include "controlflowgraph/FilteredDegreeCache.h"
+#include "controlflowgraph/BasicBlockGraph.h"
+#include "controlflowgraph/DominatorTree.h"
+#include "controlflowgraph/LoopNestingForest.h"
+#include "controlflowgraph/ReachabilitySkeleton.h"
 
 class TranslationUnit;
 class FunctionCall;
 class ToolDot;
 
-/// Map of function call identifiers to FunctionCallUnresolved instances.
-typedef std::multimap< std::string, FunctionCallUnresolved*> T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP;
+/// Map of function call identifiers to unresolved FunctionCall instances.
+typedef std::multimap< std::string, FunctionCall*> T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP;
 
 /**
  * Class representing a single function in the source.
@@ -46,13 +52,46 @@ public:
 	/**
 	 * Link the unresolved function calls in this Function to the Functions
 	 * in the passed \a function_map.
+	 *
+	 * Only calls to Functions whose control flow graphs have already been built are linked.  The others are left
+	 * unlinked, and will be linked by a later call once their targets have been built.  Calls to identifiers which
+	 * aren't in @a function_map can never be linked, and are dropped from the list of unlinked calls.
+	 * Does nothing if this Function's own control flow graph hasn't been built yet.
 	 * 
 	 * @param function_map The identifier->Function map to use to find the Functions to
 	 * link to.
-	 * @param[out] unresolved_function_calls List of function calls we weren't able to resolve.
+	 * @param[out] unresolved_function_calls List of function calls we weren't able to resolve.  May be NULL.
      */
 	void Link(const std::map< std::string, Function* > &function_map,
 			T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP *unresolved_function_calls);
+
+	/// @name Two-phase linking
+	/// Link() in two steps, so that many Functions can be linked at once.  ResolveCalls() only modifies the calling
+	/// Function, so it can be run on any number of Functions concurrently.  AttachCalls() adds the edges between a
+	/// callee and all of its callers, and has to be run serially.
+	//@{
+
+	/**
+	 * Resolve the unlinked calls in this Function which can be linked now, in place.  See Link() for which calls
+	 * are linked.
+	 *
+	 * @param function_map The identifier->Function map to use to find the Functions to link to.
+	 * @param[out] resolved_calls The resolved calls are appended to this list, to be passed to the callees'
+	 *        AttachCalls().
+	 * @param[out] unresolved_function_calls List of function calls we weren't able to resolve.  May be NULL.
+	 */
+	void ResolveCalls(const std::map< std::string, Function* > &function_map,
+			std::vector< FunctionCall* > *resolved_calls,
+			T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP *unresolved_function_calls);
+
+	/**
+	 * Add the FunctionCall and Return edges for resolved calls to this Function.
+	 *
+	 * @param calls_to_this_function Calls to this Function resolved by its callers' ResolveCalls().
+	 */
+	void AttachCalls(const std::vector< FunctionCall* > &calls_to_this_function);
+
+	//@}
 	
 	/**
 	 * Add the statements passed in @a statement_list to the control flow graph of this Function.
@@ -62,6 +101,59 @@ public:
      */
 	bool CreateControlFlowGraph(const std::vector< StatementBase* > &statement_list);
 
+	/// @name On-demand control flow graph construction
+	/// The parser hands each Function its statement list, but the control flow graph isn't built from it until
+	/// something actually needs it.  See Program::MaterializeFunction().
+	//@{
+
+	/**
+	 * Save @a statement_list for building this Function's control flow graph later, and note the function calls in it.
+	 *
+	 * @param statement_list The list of statements to build the control flow graph from.  Must outlive this Function,
+	 *        or at least the call to BuildControlFlowGraph().
+	 */
+	void SetStatementList(const std::vector< StatementBase* > *statement_list);
+
+	/**
+	 * Build the control flow graph from the statement list passed to SetStatementList(), if it hasn't been built yet.
+	 *
+	 * @return true on success, false on failure.
+	 */
+	bool BuildControlFlowGraph();
+
+	/**
+	 * @return true if this Function's control flow graph has been built.
+	 */
+	bool IsControlFlowGraphBuilt() const { return m_cfg_is_built; };
+
+	/**
+	 * Get the function calls of this Function which haven't been linked yet.  This is available as soon as
+	 * SetStatementList() has been called, whether or not the control flow graph has been built.
+	 *
+	 * @return The FunctionCall statements still waiting to be linked.
+	 */
+	const std::vector< FunctionCall* >& GetUnlinkedFunctionCalls() const { return m_unlinked_function_calls; };
+
+	/**
+	 * Compute the structural fingerprint of a function body: the StatementBase::GetStructuralHash() of each
+	 * statement, in order.  Since the statement order determines the fallthrough edges and the statements themselves
+	 * carry their jump targets and callees, two bodies with the same fingerprint will produce the same control flow
+	 * graph.  This is how we recognize the copies of a header's inline functions which show up in every
+	 * TranslationUnit that includes it.  The compiler-generated names in the body are canonicalized with a
+	 * StatementBase::CompilerNameMap, since GCC numbers them differently in each TranslationUnit.
+	 *
+	 * @param statement_list The statements of the function body.
+	 * @return The fingerprint.
+	 */
+	static std::size_t ComputeFingerprint(const std::vector< StatementBase* > &statement_list);
+
+	/**
+	 * @return The fingerprint of the statement list passed to SetStatementList().
+	 */
+	std::size_t GetFingerprint() const { return m_fingerprint; };
+
+	//@}
+
 	/**
 	 * Return this Function's identifier.
 	 *
@@ -93,14 +185,44 @@ public:
 	 */
 	void PrintControlFlowGraphDot(bool cfg_verbose, bool cfg_vertex_ids, const std::string &output_filename);
 
+	/**
+	 * Write the same dot graph PrintControlFlowGraphDot() does to @a out.
+	 *
+	 * Like PrintControlFlowGraphSVG(), this doesn't build anything, so the control flow graph must already have been
+	 * built and linked, and different Functions can be written in parallel.
+	 */
+	void WriteControlFlowGraphDot(std::ostream &out) const;
+
 	/**
 	 * Print the control flow graph of this function to a dot file in @a output_dir, and
 	 * run the dot too to generate the resulting png file.
 	 *
 	 * @param the_dot
 	 * @param output_filename The filename of the generated png file.
+	 * @return true if dot succeeded.
+	 */
+	bool PrintControlFlowGraphBitmap(ToolDot *the_dot, const boost::filesystem::path& output_filename);
+
+	/**
+	 * Lay out the control flow graph of this function with LayeredLayout and write it to an SVG file, without using
+	 * dot.  The graph drawn is the same one PrintControlFlowGraphDot() writes.
+	 *
+	 * Unlike the other Print functions, this doesn't build anything, so the control flow graph must already have been
+	 * built and linked.  Different Functions can then be written in parallel.
+	 *
+	 * @param output_filename The filename of the generated svg file.
+	 * @return true if the file was written.
 	 */
-	void PrintControlFlowGraphBitmap(ToolDot *the_dot, const boost::filesystem::path& output_filename);
+	bool PrintControlFlowGraphSVG(const boost::filesystem::path& output_filename) const;
+
+	/**
+	 * Write a description of the control flow graph drawn by the other Print functions to @a out: the same vertices,
+	 * edges and attributes, including the vertex indices shown in the labels.  A Function whose signature hasn't
+	 * changed draws exactly the same graph.
+	 *
+	 * Like PrintControlFlowGraphSVG(), this doesn't build anything.
+	 */
+	void WriteControlFlowGraphSignature(std::ostream &out) const;
 	
 	//@}
 
@@ -157,40 +279,108 @@ public:
 
 	ControlFlowGraph* GetCFGPointer() const { return m_the_cfg; };
 
+	/**
+	 * Get the cached filtered in/out degrees of the vertices of this Function's ControlFlowGraph.
+	 * These are computed once at the end of CreateControlFlowGraph() and kept up to date by Link().
+	 *
+	 * @return Reference to this Function's FilteredDegreeCache.
+	 */
+	const FilteredDegreeCache& GetFilteredDegreeCache() const { return m_filtered_degrees; };
+
+	/**
+	 * Get the basic blocks of this Function's ControlFlowGraph.
+	 * These are built at the end of CreateControlFlowGraph().  Link() resolves function calls in place, so it
+	 * doesn't change them.
+	 *
+	 * @return Reference to this Function's BasicBlockGraph.
+	 */
+	const BasicBlockGraph& GetBasicBlockGraph() const { return m_basic_blocks; };
+
+	/**
+	 * Get the reachability skeleton of this Function's ControlFlowGraph, i.e. just its Entry, Exit and FunctionCall
+	 * statements and which of them can follow which.  This is built from the basic blocks at the end of
+	 * CreateControlFlowGraph().
+	 *
+	 * @return Reference to this Function's ReachabilitySkeleton.
+	 */
+	const ReachabilitySkeleton& GetReachabilitySkeleton() const { return m_reachability_skeleton; };
+
+	/**
+	 * Get the loops of this Function's ControlFlowGraph.  These are found while marking the back edges in
+	 * CreateControlFlowGraph().
+	 *
+	 * @return Reference to this Function's LoopNestingForest.
+	 */
+	const LoopNestingForest& GetLoopNestingForest() const { return m_loops; };
+
+	/// @name Dominance information.
+	/// The trees are built at the end of CreateControlFlowGraph(), so they can be read from any number of threads.
+	/// They only follow intraprocedural edges, so Link() doesn't change them.
+	//@{
+
+	/**
+	 * @return The dominator tree of this Function's ControlFlowGraph, rooted at the Entry vertex.
+	 */
+	const DominatorTree& GetDominatorTree() const { return m_dominator_tree; };
+
+	/**
+	 * @return The post-dominator tree of this Function's ControlFlowGraph, rooted at the Exit vertex.
+	 */
+	const DominatorTree& GetPostDominatorTree() const { return m_post_dominator_tree; };
+
+	//@}
+
 private:
 	
 	/**
-	 * Structure for capturing info regarding basic block leaders.
-	 * Used in the creation of a Function's CFG.
+	 * Per-statement info gathered while the statements are inserted into the CFG, in statement list order.
+	 * Used by FinalizeControlFlowGraph() so that it doesn't have to rediscover it from the graph.
 	 */
-	struct BasicBlockLeaderInfo
+	struct StatementFinalizationInfo
 	{
-		BasicBlockLeaderInfo(ControlFlowGraph::vertex_descriptor leader, ControlFlowGraph::vertex_descriptor immediate_predecessor)
+		enum Flags
 		{
-			m_leader = leader;
-			m_immediate_predecessor = immediate_predecessor;
+			/// The statement is a flow control statement which still needs to be linked to its targets.
+			UNLINKED_FLOW_CONTROL = 1 << 0,
+			/// The statement is a basic block leader with no fallthrough in edge.
+			BLOCK_LEADER = 1 << 1,
+			/// The statement is a Goto or a compiler-generated Label, and may turn out to be redundant.
+			REDUNDANCY_CANDIDATE = 1 << 2
 		};
 
-		/// Vertex descriptor of the basic block leader.
-		ControlFlowGraph::vertex_descriptor m_leader;
+		StatementFinalizationInfo(ControlFlowGraph::vertex_descriptor vertex, unsigned int flags)
+		{
+			m_vertex = vertex;
+			m_flags = flags;
+		};
+
+		bool Is(Flags flag) const { return (m_flags & flag) != 0; };
 
-		/// The vertex which ended the immediately-preceding basic block.
-		ControlFlowGraph::vertex_descriptor m_immediate_predecessor;
+		/// Vertex descriptor of the statement.
+		ControlFlowGraph::vertex_descriptor m_vertex;
+
+		/// Bitwise OR of the Flags which apply to the statement.
+		unsigned int m_flags;
 	};
 
 	/**
-	 * Add any necessary Impossible edges to the CFG.
-	 *
-	 * These can be necessary when the source contains infinite loops or dead code.
+	 * Finish off the CFG once all the statements have been inserted and linked, in a single walk over
+	 * @a statement_info:
+	 *  - Add Impossible in edges to any basic block leaders which nothing jumps to.  These can be necessary when
+	 *    the source contains infinite loops or dead code.
+	 *  - Warn about any statements which still have no in edges.
+	 *  - Remove the redundant Gotos and compiler-generated Labels.
 	 *
-	 * @param cfg
-	 * @param leader_info_list
+	 * @param statement_info  The info gathered by CreateControlFlowGraph(), in statement list order.
 	 */
-	void AddImpossibleEdges(ControlFlowGraph & cfg, std::vector< BasicBlockLeaderInfo > &leader_info_list);
+	void FinalizeControlFlowGraph(const std::vector< StatementFinalizationInfo > &statement_info);
 
-	bool CheckForNoInEdges(ControlFlowGraph & cfg,
-			std::vector< ControlFlowGraph::vertex_descriptor > &list_of_statements_with_no_in_edge_yet,
-			std::vector< ControlFlowGraph::vertex_descriptor > *output);
+	/**
+	 * Collect the vertices and edges of the drawings of this Function's control flow graph: those reachable from
+	 * Entry without leaving the Function, in a deterministic order.
+	 */
+	void CollectDrawnGraph(std::vector< ControlFlowGraph::vertex_descriptor > *vertices,
+			std::vector< ControlFlowGraph::edge_descriptor > *edges) const;
 
 private:
 	/// The translation unit containing this function.
@@ -210,6 +400,36 @@ private:
 	/// The ControlFlowGraph of this function.
 	ControlFlowGraph *m_the_cfg;
 
+	/// The statements m_the_cfg will be built from, or NULL once it's been built.
+	const std::vector< StatementBase* > *m_pending_statement_list;
+
+	/// The fingerprint of the statement list, computed by SetStatementList().
+	std::size_t m_fingerprint;
+
+	/// Whether m_the_cfg has been built.
+	bool m_cfg_is_built;
+
+	/// The FunctionCall statements which Link() hasn't resolved yet.
+	std::vector< FunctionCall* > m_unlinked_function_calls;
+
+	/// Cache of the filtered degrees of the vertices in m_the_cfg.
+	FilteredDegreeCache m_filtered_degrees;
+
+	/// The loops of m_the_cfg.
+	LoopNestingForest m_loops;
+
+	/// The basic blocks of m_the_cfg.
+	BasicBlockGraph m_basic_blocks;
+
+	/// The reachability skeleton of m_the_cfg.
+	ReachabilitySkeleton m_reachability_skeleton;
+
+	/// @name The dominator and post-dominator trees of m_the_cfg.
+	//@{
+	DominatorTree m_dominator_tree;
+	DominatorTree m_post_dominator_tree;
+	//@}
+
 	/// @name Static properties of this function.
 	/// These are properties of the function determined at analysis-time which are invariant, such as
 	/// whether it is known to terminate, its complexity, etc.
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "JSON.h"
+
+#include <cstdio>
+
+#include <boost/foreach.hpp>
+
+std::string json_quote(const std::string &s)
+{
+	std::string retval = "\"";
+
+	BOOST_FOREACH(char c, s)
+	{
+		switch(c)
+		{
+			case '"': retval += "\\\""; break;
+			case '\\': retval += "\\\\"; break;
+			case '\n': retval += "\\n"; break;
+			case '\r': retval += "\\r"; break;
+			case '\t': retval += "\\t"; break;
+			default:
+				if(static_cast<unsigned char>(c) < 0x20)
+				{
+					char buf[8];
+					std::sprintf(buf, "\\u%04x", static_cast<unsigned int>(c));
+					retval += buf;
+				}
+				else
+				{
+					retval += c;
+				}
+				break;
+		}
+	}
+
+	return retval + "\"";
+}
@@ -17,29 +17,51 @@
 
 #include "Program.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 
 #include <sys/types.h>
 #include <sys/stat.h>
 
 #include <boost/foreach.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/regex.hpp>
 
 
 #include "TranslationUnit.h"
 //#include "RuleReachability.h"
 #include "controlflowgraph/statements/FunctionCall.h"
 #include "Function.h"
+#include "ProgramImage.h"
+#include "ReportFingerprints.h"
+#include "ThreadPool.h"
 
 // Include the templates for the output HTML, CSS, etc. files.
 #include "templates/templates.h"
 #include "templates/FileTemplate.h"
+#include "templates/StreamingTemplate.h"
+#include "templates/TarArchive.h"
 
 #include "libexttools/toollib.h"
+#include "libexttools/ToolDot.h"
+
+// Include the config.h file generated by configure.
+#include "../config.h"
+
+#if HAVE_LIBGVC
+#include "libexttools/GraphvizLibrary.h"
+#endif
 
 Program::Program()
 {
-
+	m_num_jobs = 0;
+	m_thread_pool = NULL;
+	m_the_dot = NULL;
+	m_use_graphviz_library = false;
 }
 
 Program::Program(const Program& orig)
@@ -48,6 +70,26 @@ Program::Program(const Program& orig)
 
 Program::~Program()
 {
+	delete m_thread_pool;
+}
+
+void Program::SetNumberOfJobs(unsigned int num_jobs)
+{
+	m_num_jobs = num_jobs;
+
+	// Start a new pool with the new number of threads when it's next needed.
+	delete m_thread_pool;
+	m_thread_pool = NULL;
+}
+
+ThreadPool* Program::GetThreadPool()
+{
+	if(m_thread_pool == NULL)
+	{
+		m_thread_pool = new ThreadPool(m_num_jobs);
+	}
+
+	return m_thread_pool;
 }
 
 void Program::SetTheDot(ToolDot *the_dot)
@@ -92,18 +134,569 @@ bool Program::Parse(const std::vector< std::string > &defines,
 		}
 	}
 
-	// Link the function calls.
+	// Resolve the function calls.  The calls themselves are linked as the Functions' control flow graphs are built,
+	// but we can determine which calls can never be resolved, and who calls whom, without building any.
 	std::cout << "Linking function calls..." << std::endl;
 
+	std::vector< Function* > functions;
+	long num_duplicate_functions = 0;
 	BOOST_FOREACH(TranslationUnit *tu, m_translation_units)
 	{
-		tu->Link(m_function_map, unresolved_function_calls);
+		functions.insert(functions.end(), tu->GetFunctionDefinitions().begin(), tu->GetFunctionDefinitions().end());
+		num_duplicate_functions += tu->GetNumDuplicateFunctions();
+	}
+	if(num_duplicate_functions > 0)
+	{
+		std::cout << "Skipped " << num_duplicate_functions << " duplicate function definitions." << std::endl;
 	}
+	m_call_graph.Build(functions, m_function_map, unresolved_function_calls);
 
 	// Parsing was successful.
 	return true;
 }
 
+void Program::MaterializeFunction(Function *f, bool transitive)
+{
+	std::vector< Function* > to_build(1, f);
+
+	// Build f and the Functions it calls, or everything reachable from it if we were asked to.
+	if(transitive)
+	{
+		std::vector<bool> reachable;
+		CallGraphReachable(f, false, &reachable);
+		for(std::size_t i = 0; i < reachable.size(); ++i)
+		{
+			if(reachable[i])
+			{
+				to_build.push_back(m_call_graph.GetFunction(i));
+			}
+		}
+	}
+	else if(m_call_graph.GetFunctionIndex(f) != CallGraph::NO_FUNCTION)
+	{
+		std::vector<CallGraph::function_index_type> callees;
+		m_call_graph.GetCallees(m_call_graph.GetFunctionIndex(f), &callees);
+		BOOST_FOREACH(CallGraph::function_index_type callee, callees)
+		{
+			to_build.push_back(m_call_graph.GetFunction(callee));
+		}
+	}
+
+	BuildAndLink(to_build);
+}
+
+long Program::MaterializeCallPaths(Function *source, Function *sink)
+{
+	std::vector<bool> reachable_from_source;
+	std::vector<bool> reaches_sink;
+
+	// A Function is on a call path from source to sink if source can call it and it can call sink.
+	CallGraphReachable(source, false, &reachable_from_source);
+	CallGraphReachable(sink, true, &reaches_sink);
+
+	// The endpoints are always needed, even if there's no call path between them.
+	std::vector< Function* > slice;
+	slice.push_back(source);
+	if(sink != source)
+	{
+		slice.push_back(sink);
+	}
+	for(std::size_t i = 0; i < reachable_from_source.size(); ++i)
+	{
+		Function *f = m_call_graph.GetFunction(i);
+		if(reachable_from_source[i] && reaches_sink[i] && (f != source) && (f != sink))
+		{
+			slice.push_back(f);
+		}
+	}
+
+	BuildAndLink(slice);
+
+	return slice.size();
+}
+
+void Program::BuildAndLink(const std::vector< Function* > &functions)
+{
+	std::vector< Function* > newly_built;
+
+	BOOST_FOREACH(Function *f, functions)
+	{
+		if(!f->IsControlFlowGraphBuilt()
+				&& (std::find(newly_built.begin(), newly_built.end(), f) == newly_built.end()))
+		{
+			newly_built.push_back(f);
+		}
+	}
+
+	BuildControlFlowGraphs(newly_built);
+
+	// Link the calls out of the newly-built Functions, and the calls into them from Functions which were built earlier.
+	// Calls to Functions which still haven't been built are left for later.
+	std::vector< Function* > to_link(newly_built);
+	std::vector< bool > is_queued(m_call_graph.NumFunctions(), false);
+	BOOST_FOREACH(Function *f, newly_built)
+	{
+		CallGraph::function_index_type fi = m_call_graph.GetFunctionIndex(f);
+		if(fi != CallGraph::NO_FUNCTION)
+		{
+			is_queued[fi] = true;
+		}
+	}
+	BOOST_FOREACH(Function *f, newly_built)
+	{
+		CallGraph::function_index_type fi = m_call_graph.GetFunctionIndex(f);
+		if(fi == CallGraph::NO_FUNCTION)
+		{
+			continue;
+		}
+
+		std::vector<CallGraph::function_index_type> callers;
+		m_call_graph.GetCallers(fi, &callers);
+		BOOST_FOREACH(CallGraph::function_index_type caller, callers)
+		{
+			if(!is_queued[caller] && m_call_graph.GetFunction(caller)->IsControlFlowGraphBuilt())
+			{
+				is_queued[caller] = true;
+				to_link.push_back(m_call_graph.GetFunction(caller));
+			}
+		}
+	}
+
+	LinkFunctions(to_link);
+}
+
+void Program::BuildControlFlowGraphs(const std::vector< Function* > &functions)
+{
+	// Each Function's graph, label map and statements are its own, so the graphs can all be built at once.
+	std::vector< ThreadPool::task_type > tasks;
+	BOOST_FOREACH(Function *f, functions)
+	{
+		tasks.push_back(boost::bind(&Function::BuildControlFlowGraph, f));
+	}
+	RunInParallel(tasks);
+}
+
+void Program::LinkFunctions(const std::vector< Function* > &functions)
+{
+	// Resolve phase.  Each Function only modifies its own call statements and collects them in its own list, so this
+	// can be done for all of them at once.
+	std::vector< std::vector< FunctionCall* > > resolved_calls(functions.size());
+	std::vector< ThreadPool::task_type > tasks;
+	for(std::size_t i = 0; i < functions.size(); ++i)
+	{
+		tasks.push_back(boost::bind(&Function::ResolveCalls, functions[i], boost::cref(m_function_map),
+				&resolved_calls[i], static_cast<T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP*>(NULL)));
+	}
+	RunInParallel(tasks);
+
+	// Commit phase.  Every call and return edge touches both the caller's and the callee's graphs, so this is done
+	// serially.  The calls are grouped by callee, in the order the callees were first seen so the result doesn't
+	// depend on the scheduling above, and each callee attaches its whole batch at once.
+	std::vector< Function* > callees;
+	std::map< Function*, std::vector< FunctionCall* > > calls_by_callee;
+	BOOST_FOREACH(const std::vector< FunctionCall* > &calls, resolved_calls)
+	{
+		BOOST_FOREACH(FunctionCall *fc, calls)
+		{
+			Function *callee = fc->GetCalledFunction();
+			std::vector< FunctionCall* > &batch = calls_by_callee[callee];
+			if(batch.empty())
+			{
+				callees.push_back(callee);
+			}
+			batch.push_back(fc);
+		}
+	}
+	BOOST_FOREACH(Function *callee, callees)
+	{
+		callee->AttachCalls(calls_by_callee[callee]);
+	}
+}
+
+void Program::RunInParallel(const std::vector< ThreadPool::task_type > &tasks)
+{
+	if(tasks.size() < 2)
+	{
+		// Not worth waking up the pool for.
+		BOOST_FOREACH(const ThreadPool::task_type &task, tasks)
+		{
+			task();
+		}
+		return;
+	}
+
+	GetThreadPool()->Run(tasks);
+}
+
+/// Name of the file in the report directory which holds the fingerprints of the control flow graph drawings.
+static const char f_report_fingerprints_filename[] = "cfg_fingerprints.txt";
+
+/**
+ * Compute the fingerprint of the drawing of @a f's control flow graph.
+ */
+static void compute_drawing_fingerprint(const Function *f, ReportFingerprints::fingerprint_type *fingerprint)
+{
+	std::ostringstream signature;
+
+	f->WriteControlFlowGraphSignature(signature);
+	*fingerprint = ReportFingerprints::Compute(signature.str());
+}
+
+std::string Program::GetRenderSettings() const
+{
+	// The drawings depend on CoFlo's version as well as the renderer's.
+	std::string render_settings = PACKAGE_STRING;
+
+	if(m_use_graphviz_library)
+	{
+		render_settings += ", Graphviz library";
+	}
+	else if(m_the_dot != NULL)
+	{
+		render_settings += ", dot " + std::string(m_the_dot->GetVersion());
+	}
+	else
+	{
+		render_settings += ", built-in layout";
+	}
+
+	return render_settings;
+}
+
+void Program::FindOutOfDateDrawings(const std::vector< Function* > &functions, const boost::filesystem::path &output_dir,
+		const std::string &fingerprints_filename, ReportFingerprints *fingerprints,
+		std::vector< Function* > *functions_to_draw)
+{
+	ReportFingerprints old_fingerprints;
+	std::string render_settings = GetRenderSettings();
+	bool have_old_drawings = old_fingerprints.Read(fingerprints_filename)
+			&& (old_fingerprints.GetRenderSettings() == render_settings);
+
+	// Fingerprint the graphs, which is a lot quicker than drawing them.
+	std::vector< ReportFingerprints::fingerprint_type > new_fingerprints(functions.size());
+	std::vector< ThreadPool::task_type > tasks;
+	for(std::size_t i = 0; i < functions.size(); ++i)
+	{
+		tasks.push_back(boost::bind(compute_drawing_fingerprint, functions[i], &new_fingerprints[i]));
+	}
+	RunInParallel(tasks);
+
+	fingerprints->SetRenderSettings(render_settings);
+	for(std::size_t i = 0; i < functions.size(); ++i)
+	{
+		const std::string &identifier = functions[i]->GetIdentifier();
+		boost::filesystem::path svg_filename = output_dir / (identifier + ".svg");
+		ReportFingerprints::fingerprint_type old_fingerprint;
+
+		fingerprints->Set(identifier, new_fingerprints[i]);
+
+		if(have_old_drawings && old_fingerprints.Lookup(identifier, &old_fingerprint)
+				&& (old_fingerprint == new_fingerprints[i]) && boost::filesystem::exists(svg_filename))
+		{
+			// Still up to date.
+			continue;
+		}
+
+		// Remove the old drawing, so if the new one fails we don't think it's up to date next time.
+		boost::system::error_code ec;
+		boost::filesystem::remove(svg_filename, ec);
+		functions_to_draw->push_back(functions[i]);
+	}
+
+	// Remove the drawings of any Functions which aren't in the report any more.
+	ReportFingerprints::map_type::const_iterator it;
+	for(it = old_fingerprints.GetFingerprints().begin(); it != old_fingerprints.GetFingerprints().end(); ++it)
+	{
+		ReportFingerprints::fingerprint_type unused;
+		if(!fingerprints->Lookup(it->first, &unused))
+		{
+			boost::system::error_code ec;
+			boost::filesystem::remove(output_dir / (it->first + ".svg"), ec);
+			boost::filesystem::remove(output_dir / (it->first + ".dot"), ec);
+		}
+	}
+
+	std::cout << functions_to_draw->size() << " of " << functions.size() << " control flow graphs need to be drawn."
+			<< std::endl;
+}
+
+/**
+ * Write @a tu's report manifest to @a output_dir, setting @a *succeeded to whether it worked.
+ */
+static void print_manifest(const TranslationUnit *tu, const boost::filesystem::path &output_dir, char *succeeded)
+{
+	*succeeded = tu->PrintManifest(output_dir);
+}
+
+bool Program::PrintManifests(const boost::filesystem::path &output_dir)
+{
+	std::vector< char > succeeded(m_translation_units.size(), false);
+	std::vector< ThreadPool::task_type > tasks;
+
+	for(std::size_t i = 0; i < m_translation_units.size(); ++i)
+	{
+		tasks.push_back(boost::bind(print_manifest, m_translation_units[i], output_dir, &succeeded[i]));
+	}
+	RunInParallel(tasks);
+
+	return std::count(succeeded.begin(), succeeded.end(), false) == 0;
+}
+
+/**
+ * Draw the control flow graph of @a f to @a output_filename, setting @a *succeeded to whether it worked.
+ */
+static void layout_svg_file(const Function *f, const boost::filesystem::path &output_filename, char *succeeded)
+{
+	*succeeded = f->PrintControlFlowGraphSVG(output_filename);
+}
+
+bool Program::LayoutSVGFiles(const std::vector< Function* > &functions, const boost::filesystem::path &output_dir)
+{
+	// Every Function was built and linked before we got here, and writing one only reads its own graph.
+	std::vector< char > succeeded(functions.size(), false);
+	std::vector< ThreadPool::task_type > tasks;
+
+	std::cout << "Drawing " << functions.size() << " control flow graphs..." << std::endl;
+
+	for(std::size_t i = 0; i < functions.size(); ++i)
+	{
+		tasks.push_back(boost::bind(layout_svg_file, functions[i], output_dir / (functions[i]->GetIdentifier() + ".svg"),
+				&succeeded[i]));
+	}
+	RunInParallel(tasks);
+
+	long num_failed = std::count(succeeded.begin(), succeeded.end(), false);
+	if(num_failed > 0)
+	{
+		std::cerr << "ERROR: " << num_failed << " of " << functions.size() << " control flow graphs couldn't be drawn."
+				<< std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+#if HAVE_LIBGVC
+/**
+ * Render the control flow graph of @a f to @a output_filename with the Graphviz libraries, setting @a *succeeded to
+ * whether it worked.
+ */
+static void render_svg_file_with_graphviz_library(const Function *f, const boost::filesystem::path &output_filename,
+		char *succeeded)
+{
+	std::ostringstream dot_source;
+	std::string svg;
+
+	*succeeded = false;
+
+	f->WriteControlFlowGraphDot(dot_source);
+	if(!GraphvizLibrary::RenderDot(dot_source.str(), &svg))
+	{
+		std::cerr << "ERROR: Graphviz couldn't render the control flow graph of " << f->GetIdentifier() << std::endl;
+		return;
+	}
+
+	std::ofstream outfile(output_filename.string().c_str(), std::ios::binary);
+	outfile.write(svg.data(), svg.size());
+	outfile.close();
+	*succeeded = !outfile.fail();
+}
+#endif
+
+bool Program::RenderSVGFilesWithGraphvizLibrary(const std::vector< Function* > &functions,
+		const boost::filesystem::path &output_dir)
+{
+#if HAVE_LIBGVC
+	// As with LayoutSVGFiles(), everything is built and linked, so the Functions can be written in parallel.
+	std::vector< char > succeeded(functions.size(), false);
+	std::vector< ThreadPool::task_type > tasks;
+
+	std::cout << "Rendering " << functions.size() << " control flow graphs with the Graphviz libraries..." << std::endl;
+
+	for(std::size_t i = 0; i < functions.size(); ++i)
+	{
+		tasks.push_back(boost::bind(render_svg_file_with_graphviz_library, functions[i],
+				output_dir / (functions[i]->GetIdentifier() + ".svg"), &succeeded[i]));
+	}
+	RunInParallel(tasks);
+
+	long num_failed = std::count(succeeded.begin(), succeeded.end(), false);
+	if(num_failed > 0)
+	{
+		std::cerr << "ERROR: " << num_failed << " of " << functions.size() << " control flow graphs couldn't be rendered."
+				<< std::endl;
+		return false;
+	}
+
+	return true;
+#else
+	(void)functions;
+	(void)output_dir;
+	std::cerr << "ERROR: CoFlo wasn't built with the Graphviz libraries." << std::endl;
+	return false;
+#endif
+}
+
+bool Program::RenderDotFiles(const std::vector< std::string > &dot_filenames)
+{
+	// Most graphs are small, so starting dot costs about as much as rendering one.  Give each dot process a batch of
+	// files, but make enough batches to keep all the jobs busy.
+	const std::size_t max_batch_size = 32;
+	std::size_t num_threads = GetThreadPool()->NumThreads();
+	std::size_t batch_size = std::min(max_batch_size, (dot_filenames.size() + num_threads - 1) / num_threads);
+	batch_size = std::max(batch_size, static_cast<std::size_t>(1));
+
+	std::vector< std::vector< std::string > > batches;
+	for(std::size_t i = 0; i < dot_filenames.size(); i += batch_size)
+	{
+		std::size_t end = std::min(i + batch_size, dot_filenames.size());
+		batches.push_back(std::vector< std::string >(dot_filenames.begin() + i, dot_filenames.begin() + end));
+	}
+
+	std::cout << "Rendering " << dot_filenames.size() << " control flow graphs in " << batches.size()
+			<< " batches..." << std::endl;
+
+	std::vector< ThreadPool::task_type > tasks;
+	BOOST_FOREACH(const std::vector< std::string > &batch, batches)
+	{
+		tasks.push_back(boost::bind(&ToolDot::CompileDotFiles, m_the_dot, boost::cref(batch), ToolDot::SVG));
+	}
+	RunInParallel(tasks);
+
+	// dot may have rendered the rest of a batch even if one file in it failed, so check the outputs one by one.
+	// Move each to the name the report refers to it by.
+	long num_failed = 0;
+	BOOST_FOREACH(const std::string &dot_filename, dot_filenames)
+	{
+		boost::filesystem::path rendered = ToolDot::GetCompiledFilename(dot_filename, ToolDot::SVG);
+		boost::filesystem::path svg_filename = dot_filename;
+		svg_filename.replace_extension(".svg");
+
+		boost::system::error_code ec;
+		if(boost::filesystem::exists(rendered, ec))
+		{
+			boost::filesystem::rename(rendered, svg_filename, ec);
+		}
+		else
+		{
+			ec = boost::system::errc::make_error_code(boost::system::errc::no_such_file_or_directory);
+		}
+
+		if(ec)
+		{
+			std::cerr << "ERROR: Couldn't render control flow graph \"" << dot_filename << "\": " << ec.message() << std::endl;
+			++num_failed;
+		}
+	}
+
+	if(num_failed > 0)
+	{
+		std::cerr << "ERROR: " << num_failed << " of " << dot_filenames.size() << " control flow graphs couldn't be rendered."
+				<< std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+void Program::CallGraphReachable(Function *start, bool backwards, std::vector<bool> *reachable) const
+{
+	std::vector<CallGraph::function_index_type> worklist;
+	std::vector<CallGraph::function_index_type> adjacent;
+
+	reachable->assign(m_call_graph.NumFunctions(), false);
+
+	CallGraph::function_index_type s = m_call_graph.GetFunctionIndex(start);
+	if(s == CallGraph::NO_FUNCTION)
+	{
+		return;
+	}
+
+	(*reachable)[s] = true;
+	worklist.push_back(s);
+	while(!worklist.empty())
+	{
+		CallGraph::function_index_type f = worklist.back();
+		worklist.pop_back();
+
+		adjacent.clear();
+		if(backwards)
+		{
+			m_call_graph.GetCallers(f, &adjacent);
+		}
+		else
+		{
+			m_call_graph.GetCallees(f, &adjacent);
+		}
+
+		BOOST_FOREACH(CallGraph::function_index_type next, adjacent)
+		{
+			if(!(*reachable)[next])
+			{
+				(*reachable)[next] = true;
+				worklist.push_back(next);
+			}
+		}
+	}
+}
+
+void Program::MaterializeAll()
+{
+	std::vector< Function* > to_build;
+
+	BOOST_FOREACH(TranslationUnit *tu, m_translation_units)
+	{
+		BOOST_FOREACH(Function *f, tu->GetFunctionDefinitions())
+		{
+			if(!f->IsControlFlowGraphBuilt())
+			{
+				to_build.push_back(f);
+			}
+		}
+	}
+
+	BuildControlFlowGraphs(to_build);
+
+	std::vector< Function* > all_functions;
+	BOOST_FOREACH(TranslationUnit *tu, m_translation_units)
+	{
+		all_functions.insert(all_functions.end(), tu->GetFunctionDefinitions().begin(), tu->GetFunctionDefinitions().end());
+	}
+	LinkFunctions(all_functions);
+}
+
+bool Program::WriteImage(const std::string &path)
+{
+	std::vector< Function* > to_build;
+	ProgramImage image;
+
+	// The skeletons only depend on the Functions' own statements, so there's no need to link anything here.  That's
+	// left to whoever merges the images.
+	BOOST_FOREACH(TranslationUnit *tu, m_translation_units)
+	{
+		BOOST_FOREACH(Function *f, tu->GetFunctionDefinitions())
+		{
+			if(!f->IsControlFlowGraphBuilt())
+			{
+				to_build.push_back(f);
+			}
+		}
+	}
+
+	BuildControlFlowGraphs(to_build);
+
+	BOOST_FOREACH(TranslationUnit *tu, m_translation_units)
+	{
+		BOOST_FOREACH(Function *f, tu->GetFunctionDefinitions())
+		{
+			image.AddFunction(*f);
+		}
+	}
+
+	std::cout << "Writing image of " << image.NumFunctions() << " functions to \"" << path << "\"..." << std::endl;
+	return image.Write(path);
+}
+
 Function *Program::LookupFunction(const std::string &function_id)
 {
 	T_ID_TO_FUNCTION_PTR_MAP::iterator fit;
@@ -139,7 +732,7 @@ static const char f_html_index_head[] = ""
 #define M_STRINGIZE(s) M_STRINGIZE_HELPER(s)
 
 
-void Program::Print(const std::string &output_path)
+bool Program::Print(const std::string &output_path)
 {
 	boost::filesystem::path template_dir;
 	boost::filesystem::path output_dir = output_path;
@@ -162,6 +755,7 @@ void Program::Print(const std::string &output_path)
 	mkdir((output_dir.string() + "/css").c_str(), S_IRWXU | S_IRWXG | S_IRWXO );
 	mkdir((output_dir.string() + "/img").c_str(), S_IRWXU | S_IRWXG | S_IRWXO );
 	mkdir((output_dir.string() + "/js").c_str(), S_IRWXU | S_IRWXG | S_IRWXO );
+	mkdir((output_dir.string() + "/manifests").c_str(), S_IRWXU | S_IRWXG | S_IRWXO );
 
 	
 	std::string index_html_filename = (output_dir / "index.html").generic_string();
@@ -173,29 +767,87 @@ void Program::Print(const std::string &output_path)
 
 	// Load the template strings.
 	std::string index_css = std::string(css_index_template_css);
-	FileTemplate index_htmlt(index_template_html);
-	FileTemplate index_csst(css_index_template_css);
+	std::string index_html_text = std::string(index_template_html);
+
+	// Change the name of the referenced stylesheet from "index.template.css" to "index.css".
+	index_html_text = boost::regex_replace(index_html_text, boost::regex("index.template.css"), "index.css");
+
+	// The rest of index.html is streamed out in order.  The per-function markup goes directly to the file as it's
+	// generated, instead of being accumulated in the template.  The sections which are for development only are
+	// dropped as the template is parsed.
+	StreamingTemplate index_htmlt(index_html_text);
+	StreamingTemplate::values_type index_values;
 
-	// Remove the sections which are for development only.
-	index_htmlt.regex_replace("(?s:<!-- REMOVE_START.*?REMOVE_END -->)", "<!-- REMOVED DEV TEXT -->");
 	// Insert the title.
 	/// @todo Make this settable from the command line.
-	index_htmlt.regex_replace("@INDEX_TITLE@", "CoFlo Analysis Results");
-	index_htmlt.regex_replace("@REPORT_HEADER@", "CoFlo Analysis Results");
-	// Change the name of the referenced stylesheet from "index.template.css" to "index.css".
-	index_htmlt.regex_replace("index.template.css", "index.css");
+	index_values["INDEX_TITLE"] = "CoFlo Analysis Results";
+	index_values["REPORT_HEADER"] = "CoFlo Analysis Results";
+
+	// Everything is going into the report, so build all the control flow graphs now.
+	MaterializeAll();
 
-	// Generate the resulting report files and add the appropriate markup for each translation unit.
+	// Add an entry for each translation unit to the navigation tree.  That's all index.html has in it, so it stays
+	// small however many functions there are.  The functions are listed in the per-file manifests, which the page
+	// loads as the user opens the files.
+	std::vector< Function* > report_functions;
+	index_htmlt.WriteSection(index_html_out, index_values, "", "NAV_END");
 	BOOST_FOREACH(TranslationUnit *tu, m_translation_units)
 	{
-		tu->Print(m_the_dot, output_path, index_htmlt);
+		tu->PrintNavTreeEntry(index_html_out, &report_functions);
+	}
+	index_htmlt.WriteSection(index_html_out, index_values, "NAV_END", "");
+	index_html_out << std::endl;
+	index_html_out.close();
+
+	// Write the manifests.
+	bool wrote_manifests = PrintManifests(output_dir);
+
+	// Find the drawings which are out of date, and get rid of the ones which aren't needed any more.
+	std::string fingerprints_filename = (output_dir / f_report_fingerprints_filename).generic_string();
+	ReportFingerprints fingerprints;
+	std::vector< Function* > functions_to_draw;
+	FindOutOfDateDrawings(report_functions, output_dir, fingerprints_filename, &fingerprints, &functions_to_draw);
+
+	// Now draw all the control flow graphs which need it at once.
+	bool rendered_all;
+	if(m_use_graphviz_library)
+	{
+		rendered_all = RenderSVGFilesWithGraphvizLibrary(functions_to_draw, output_dir);
+	}
+	else if(m_the_dot != NULL)
+	{
+		std::vector< std::string > dot_filenames;
+		BOOST_FOREACH(Function *f, functions_to_draw)
+		{
+			dot_filenames.push_back((output_dir / (f->GetIdentifier() + ".dot")).generic_string());
+			f->PrintControlFlowGraphDot(true, true, dot_filenames.back());
+		}
+		rendered_all = RenderDotFiles(dot_filenames);
+	}
+	else
+	{
+		rendered_all = LayoutSVGFiles(functions_to_draw, output_dir);
 	}
-	
-	// Create the actual index.html file.
-	index_html_out << index_htmlt << std::endl;
 
+	// Save the fingerprints of the drawings we have for the next run.  A drawing which failed is left out, so it's
+	// tried again then.
+	ReportFingerprints::map_type::const_iterator fit = fingerprints.GetFingerprints().begin();
+	ReportFingerprints drawn_fingerprints;
+	drawn_fingerprints.SetRenderSettings(fingerprints.GetRenderSettings());
+	for(; fit != fingerprints.GetFingerprints().end(); ++fit)
+	{
+		if(boost::filesystem::exists(output_dir / (fit->first + ".svg")))
+		{
+			drawn_fingerprints.Set(fit->first, fit->second);
+		}
+	}
+	if(!drawn_fingerprints.Write(fingerprints_filename))
+	{
+		std::cerr << "WARNING: Couldn't write \"" << fingerprints_filename << "\".  The next report will be drawn from "
+				"scratch." << std::endl;
+	}
+	
 	// Create the primary stylesheet from the template.
-	std::ifstream primary_css_template(index_css_template_filename.c_str());
 	std::ofstream primary_css(index_css_filename.c_str());
 
 	/// @todo Just copy it for now.
@@ -208,21 +860,34 @@ void Program::Print(const std::string &output_path)
 	}
 
 	{
-		FILE *fp;
-
 		// Extract the report boilerplate files (e.g. jQuery UI js and css theme files) to the destination directory.
-		fp = fopen((output_dir / "report_boilerplate.tar").generic_string().c_str(), "w");
-		fwrite(report_boilerplate_tar, report_boilerplate_tar_len, 1, fp);
-		fclose(fp);
-		::system(("cd " + output_dir.generic_string() + " && tar -xaf report_boilerplate.tar").c_str());
+		// Any which are already there from an earlier report are left alone.
+		TarArchive boilerplate(report_boilerplate_tar, report_boilerplate_tar_len);
+		long num_written, num_skipped;
+		if(boilerplate.ExtractTo(output_dir, &num_written, &num_skipped))
+		{
+			std::cout << "Report boilerplate: " << num_written << " files written, " << num_skipped
+					<< " already up to date." << std::endl;
+		}
+		else
+		{
+			std::cerr << "ERROR: Couldn't extract the report boilerplate files." << std::endl;
+			rendered_all = false;
+		}
+
+		// Earlier versions extracted the boilerplate with tar, and left the archive behind.
+		boost::system::error_code ec;
+		boost::filesystem::remove(output_dir / "report_boilerplate.tar", ec);
 	}
 
 	// Set permissions on the generated report appropriately.
 	/// @todo This is for development only at the moment.  We'll probably want to remove this.
 	//::system(("cd " + output_dir.generic_string() + " && chmod -R 666 .").c_str());
+
+	return rendered_all && wrote_manifests;
 }
 
-void Program::PrintUnresolvedFunctionCalls(T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP *unresolved_function_calls)
+void Program::PrintUnresolvedFunctionCalls(T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP *unresolved_function_calls)
 {
 	/// @todo Pass in.
 	bool only_list_ids = true;
@@ -235,7 +900,7 @@ void Program::PrintUnresolvedFunctionCalls(T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP
 		T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP::iterator it;
 		for(it=(*unresolved_function_calls).begin(); it!=(*unresolved_function_calls).end();)
 		{
-			FunctionCallUnresolved *fc = it->second;
+			FunctionCall *fc = it->second;
 			if(!only_list_ids)
 			{
 				std::cout << "[" << fc->GetLocation() << "]: " << fc->GetIdentifier() << std::endl;
@@ -247,9 +912,9 @@ void Program::PrintUnresolvedFunctionCalls(T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP
 				it = unresolved_function_calls->upper_bound(fc->GetIdentifier());
 			}
 		}
-	}
-}
-
+	}
+}
+
 bool Program::PrintFunctionCFG(const std::string &function_identifier, bool cfg_verbose, bool cfg_vertex_ids)
 {
 	Function *function;
@@ -24,18 +24,24 @@
 #include <string>
 #include <map>
 
+#include <boost/function.hpp>
+#include <boost/filesystem/path.hpp>
+
 #include "controlflowgraph/ControlFlowGraph.h"
+#include "CallGraph.h"
 
 class TranslationUnit;
 class Function;
 class ToolCompiler;
 class ToolDot;
+class ThreadPool;
+class ReportFingerprints;
 
 /// Map of identifiers to pointers to the Function objects the correspond to.
 typedef std::map< std::string, Function* > T_ID_TO_FUNCTION_PTR_MAP;
 
-/// Map of function call identifiers to FunctionCallUnresolved instances.
-typedef std::multimap< std::string, FunctionCallUnresolved*> T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP;
+/// Map of function call identifiers to unresolved FunctionCall instances.
+typedef std::multimap< std::string, FunctionCall*> T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP;
 
 /**
  * Encapsulates the concept of an entire program, consisting of one or more
@@ -48,10 +54,27 @@ public:
 	Program(const Program& orig);
 	virtual ~Program();
 	
+	/**
+	 * Set the dot to draw the report's control flow graphs with.  If this isn't set, Print() draws them itself.
+	 */
     void SetTheDot(ToolDot *the_dot);
+
+	/**
+	 * Draw the report's control flow graphs in-process with the Graphviz libraries instead of running dot.  Takes
+	 * precedence over SetTheDot().  Only possible if CoFlo was configured --with-libgvc.
+	 */
+	void SetUseGraphvizLibrary(bool use_graphviz_library) { m_use_graphviz_library = use_graphviz_library; };
     void SetTheGcc(ToolCompiler *the_compiler);
     void SetTheFilter(const std::string &the_filter);
 
+	/**
+	 * Set the number of threads to use for work which can be done in parallel, e.g. building the Functions' control
+	 * flow graphs.
+	 *
+	 * @param num_jobs  The number of threads.  0 means one per hardware thread.
+	 */
+	void SetNumberOfJobs(unsigned int num_jobs);
+
 	void AddSourceFiles(const std::vector< std::string > &file_paths);
 	
 	bool Parse(const std::vector< std::string > &defines,
@@ -68,13 +91,63 @@ public:
 	 * @return
 	 */
 	Function *LookupFunction(const std::string &function_id);
+
+	/// @name On-demand control flow graph construction
+	//@{
+
+	/**
+	 * Make sure the control flow graph of @a f has been built, along with those of the Functions it calls, and link
+	 * all the calls between Functions which have been built.
+	 *
+	 * @param f  The Function which is about to be printed, traversed, or otherwise needs its control flow graph.
+	 * @param transitive If true, build every Function reachable from @a f through function calls, not just the
+	 *        ones it calls directly.  Use this before any traversal which follows FunctionCall edges.
+	 */
+	void MaterializeFunction(Function *f, bool transitive = false);
+
+	/**
+	 * Build and link the control flow graphs of only those Functions which lie on some call path from @a source to
+	 * @a sink, including @a source and @a sink themselves.  Calls out to any other Function are left unlinked, and
+	 * are treated as ordinary statements by traversals.
+	 *
+	 * This is all a reachability check from @a source to @a sink needs: a control flow path from one to the other can
+	 * only pass into a Function which eventually calls @a sink.  Any other call just falls through.
+	 *
+	 * @param source  The Function the path starts in.
+	 * @param sink    The Function the path ends at.
+	 * @return The number of Functions in the slice.
+	 */
+	long MaterializeCallPaths(Function *source, Function *sink);
+
+	/**
+	 * Build and link the control flow graphs of all Functions in the Program.
+	 */
+	void MaterializeAll();
+
+	/**
+	 * Build the control flow graphs of all Functions in the Program, without linking them, and write the image of
+	 * their reachability skeletons to @a path.  This is the output of one shard of a sharded analysis.
+	 *
+	 * @param path  The image file to write.
+	 * @return true on success.
+	 */
+	bool WriteImage(const std::string &path);
+
+	/**
+	 * Returns the number of Functions defined in the Program.
+	 */
+	long GetNumberOfFunctionDefinitions() const { return m_function_map.size(); };
+
+	//@}
 	
 	/**
 	 * Creates an HTML page containing graphical control flow graphs of all functions in the program.
 	 *
 	 * @param output_path
+	 * @return true on success, false if any of the control flow graphs couldn't be rendered or any of the other
+	 *         report files couldn't be written.
 	 */
-	void Print(const std::string &output_path);
+	bool Print(const std::string &output_path);
 	
 	/**
 	 * Prints the Control Flow Graph of the specified function to cout.
@@ -94,8 +167,108 @@ public:
 	 */
 	ControlFlowGraph* GetControlFlowGraphPtr() { return &m_cfg; };
 
+	/**
+	 * Return the Program's CallGraph.  This is built by Parse(), before any Function's control flow graph is built.
+	 *
+	 * @return
+	 */
+	const CallGraph& GetCallGraph() const { return m_call_graph; };
+
 private:
 
+	/// The unit tests set up the Program's Functions directly, instead of parsing them out of source files.
+	friend class ProgramTest;
+
+	/**
+	 * Build the control flow graphs of those @a functions which haven't been built yet, then link the calls out of
+	 * them and the calls into them from Functions which were built earlier.
+	 */
+	void BuildAndLink(const std::vector< Function* > &functions);
+
+	/**
+	 * Build the control flow graphs of @a functions, none of which may have been built yet, in parallel.
+	 */
+	void BuildControlFlowGraphs(const std::vector< Function* > &functions);
+
+	/**
+	 * Link the unlinked calls of @a functions.  The calls of all of them are resolved at once on the thread pool,
+	 * then the FunctionCall and Return edges are added one callee at a time.
+	 */
+	void LinkFunctions(const std::vector< Function* > &functions);
+
+	/**
+	 * Render @a dot_filenames to SVG files of the same names, with ".svg" in place of ".dot".  The files are split
+	 * into batches, each rendered by a single dot process, and the batches are run on the thread pool, so there are
+	 * never more dot processes running than there are jobs.
+	 *
+	 * @return true if all the files were rendered.
+	 */
+	bool RenderDotFiles(const std::vector< std::string > &dot_filenames);
+
+	/**
+	 * @return A description of how the report's control flow graphs will be drawn, for ReportFingerprints.
+	 */
+	std::string GetRenderSettings() const;
+
+	/**
+	 * Work out which of the report's control flow graph drawings need to be redrawn.  A drawing left in
+	 * @a output_dir by an earlier run is kept if the fingerprints file says it was drawn the same way from the same
+	 * graph.  Out-of-date drawings, and drawings of Functions which aren't in the report any more, are deleted.
+	 *
+	 * @param functions  The Functions in the report.
+	 * @param output_dir  The report directory.
+	 * @param fingerprints_filename  The fingerprints file left by the earlier run, if any.
+	 * @param[out] fingerprints  Set to the fingerprints of the drawings of all of @a functions.
+	 * @param[out] functions_to_draw  The Functions whose graphs need to be drawn are appended to this.
+	 */
+	void FindOutOfDateDrawings(const std::vector< Function* > &functions, const boost::filesystem::path &output_dir,
+			const std::string &fingerprints_filename, ReportFingerprints *fingerprints,
+			std::vector< Function* > *functions_to_draw);
+
+	/**
+	 * Write the report manifest of each TranslationUnit to @a output_dir, in parallel.
+	 *
+	 * @return true if all the manifests were written.
+	 */
+	bool PrintManifests(const boost::filesystem::path &output_dir);
+
+	/**
+	 * Draw the control flow graphs of @a functions to "<identifier>.svg" files in @a output_dir with the built-in
+	 * layout, in parallel.
+	 *
+	 * @return true if all the files were written.
+	 */
+	bool LayoutSVGFiles(const std::vector< Function* > &functions, const boost::filesystem::path &output_dir);
+
+	/**
+	 * Render the control flow graphs of @a functions to "<identifier>.svg" files in @a output_dir with the Graphviz
+	 * libraries, in parallel.  Each graph goes straight from its dot text in memory to its SVG file, without a dot
+	 * file or a dot process.
+	 *
+	 * @return true if all the files were written.
+	 */
+	bool RenderSVGFilesWithGraphvizLibrary(const std::vector< Function* > &functions,
+			const boost::filesystem::path &output_dir);
+
+	/**
+	 * Run @a tasks on the thread pool and wait for them to finish.  If there's fewer than two, they're just run here.
+	 */
+	void RunInParallel(const std::vector< boost::function<void ()> > &tasks);
+
+	/**
+	 * @return The thread pool, starting it if necessary.
+	 */
+	ThreadPool* GetThreadPool();
+
+	/**
+	 * Find all Functions reachable from @a start in the CallGraph, including @a start.
+	 *
+	 * @param start  The Function to start at.
+	 * @param backwards  If true, follow the calls from callee to caller.
+	 * @param[out] reachable  Set to a vector of flags indexed by CallGraph::function_index_type.
+	 */
+	void CallGraphReachable(Function *start, bool backwards, std::vector<bool> *reachable) const;
+
 	/// The TranslationUnits which make up this Program.
 	std::vector< TranslationUnit* > m_translation_units;
 	
@@ -108,12 +281,24 @@ private:
 	/// The dot program from the GraphViz program to use for generating
 	/// the graph drawings.
 	ToolDot *m_the_dot;
+
+	/// Whether to render the report's graphs with the Graphviz libraries.
+	bool m_use_graphviz_library;
 	
 	/// The Control Flow Graph for the Program.
 	ControlFlowGraph m_cfg;
 	
 	/// The identifier string to Function* map.
 	T_ID_TO_FUNCTION_PTR_MAP m_function_map;
+
+	/// Who calls whom, found from the statement lists during Parse().
+	CallGraph m_call_graph;
+
+	/// Number of threads to use.  0 means one per hardware thread.
+	unsigned int m_num_jobs;
+
+	/// The threads parallel work is run on, or NULL if they haven't been started yet.
+	ThreadPool *m_thread_pool;
 };
 
 #endif	/* PROGRAM_H */
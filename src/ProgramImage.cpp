@@ -0,0 +1,455 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "ProgramImage.h"
+
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <boost/foreach.hpp>
+
+#include "Function.h"
+#include "controlflowgraph/ReachabilitySkeleton.h"
+#include "controlflowgraph/statements/FunctionCall.h"
+
+/// Version of the image file format.  Bump this whenever the format changes.
+static const long f_image_format_version = 1;
+
+/// The first word of every image file.
+static const char f_image_magic[] = "COFLO_IMAGE";
+
+/**
+ * @return @a field with its tabs, newlines and backslashes escaped.
+ */
+static std::string escape_field(const std::string &field)
+{
+	std::string retval;
+
+	BOOST_FOREACH(char c, field)
+	{
+		switch(c)
+		{
+			case '\\': retval += "\\\\"; break;
+			case '\t': retval += "\\t"; break;
+			case '\n': retval += "\\n"; break;
+			default: retval += c; break;
+		}
+	}
+
+	return retval;
+}
+
+/**
+ * Split @a line into its tab-separated fields, undoing escape_field() on each.
+ */
+static void split_fields(const std::string &line, std::vector<std::string> *fields)
+{
+	fields->assign(1, std::string());
+
+	for(std::string::size_type i = 0; i < line.size(); ++i)
+	{
+		if(line[i] == '\t')
+		{
+			fields->push_back(std::string());
+		}
+		else if((line[i] == '\\') && (i+1 < line.size()))
+		{
+			++i;
+			switch(line[i])
+			{
+				case 't': fields->back() += '\t'; break;
+				case 'n': fields->back() += '\n'; break;
+				default: fields->back() += line[i]; break;
+			}
+		}
+		else
+		{
+			fields->back() += line[i];
+		}
+	}
+}
+
+/**
+ * Convert @a field to a number of type T.
+ *
+ * @return true if the whole field was a number.
+ */
+template <typename T>
+static bool field_to_number(const std::string &field, T *value)
+{
+	std::istringstream iss(field);
+	iss >> *value;
+	return !iss.fail() && iss.eof();
+}
+
+ProgramImage::ProgramImage()
+{
+	m_num_vertices = 0;
+	m_num_duplicate_functions = 0;
+}
+
+ProgramImage::~ProgramImage()
+{
+}
+
+void ProgramImage::AddFunction(const Function &f)
+{
+	const ReachabilitySkeleton &skeleton = f.GetReachabilitySkeleton();
+	const std::vector<ControlFlowGraph::vertex_descriptor> &skeleton_vertices = skeleton.GetVertices();
+	ImageFunction image_function;
+
+	image_function.m_identifier = f.GetIdentifier();
+	image_function.m_definition_file_path = f.GetDefinitionFilePath();
+	image_function.m_fingerprint = f.GetFingerprint();
+
+	// Number the skeleton vertices in the order the skeleton has them, which puts Entry first.
+	std::map<ControlFlowGraph::vertex_descriptor, long> index_of;
+	for(std::size_t i = 0; i < skeleton_vertices.size(); ++i)
+	{
+		index_of[skeleton_vertices[i]] = i;
+	}
+
+	BOOST_FOREACH(ControlFlowGraph::vertex_descriptor v, skeleton_vertices)
+	{
+		ImageVertex image_vertex;
+
+		if(v == f.GetEntryVertexDescriptor())
+		{
+			image_vertex.m_kind = ImageVertex::ENTRY;
+		}
+		else if(v == f.GetExitVertexDescriptor())
+		{
+			image_vertex.m_kind = ImageVertex::EXIT;
+		}
+		else
+		{
+			FunctionCall *fc = dynamic_cast<FunctionCall*>(v);
+			image_vertex.m_kind = ImageVertex::CALL;
+			image_vertex.m_identifier = fc->GetIdentifier();
+			image_vertex.m_params = fc->m_params;
+		}
+		image_vertex.m_location = v->GetLocation();
+
+		BOOST_FOREACH(ControlFlowGraph::vertex_descriptor s, skeleton.GetSuccessors(v))
+		{
+			image_vertex.m_successors.push_back(index_of[s]);
+		}
+
+		image_function.m_vertices.push_back(image_vertex);
+	}
+
+	InsertFunction(image_function);
+}
+
+bool ProgramImage::Write(const std::string &path) const
+{
+	std::ofstream out(path.c_str());
+
+	if(!out)
+	{
+		std::cerr << "ERROR: Couldn't open image file \"" << path << "\" for writing." << std::endl;
+		return false;
+	}
+
+	out << f_image_magic << "\t" << f_image_format_version << "\n";
+
+	BOOST_FOREACH(const ImageFunction &f, m_functions)
+	{
+		out << "function\t" << escape_field(f.m_identifier)
+			<< "\t" << escape_field(f.m_definition_file_path)
+			<< "\t" << f.m_fingerprint
+			<< "\t" << f.m_vertices.size() << "\n";
+
+		BOOST_FOREACH(const ImageVertex &v, f.m_vertices)
+		{
+			static const char * const kind_names[] = { "ENTRY", "EXIT", "CALL" };
+
+			out << "vertex\t" << kind_names[v.m_kind]
+				<< "\t" << escape_field(v.m_identifier)
+				<< "\t" << escape_field(v.m_params)
+				<< "\t" << escape_field(v.m_location.GetPassedFilePath())
+				<< "\t" << v.m_location.GetLineNumber()
+				<< "\t" << v.m_location.GetColumn();
+			BOOST_FOREACH(long s, v.m_successors)
+			{
+				out << "\t" << s;
+			}
+			out << "\n";
+		}
+	}
+
+	out.close();
+	if(out.fail())
+	{
+		std::cerr << "ERROR: Couldn't write image file \"" << path << "\"." << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool ProgramImage::Read(const std::string &path)
+{
+	std::ifstream in(path.c_str());
+	std::string line;
+	std::vector<std::string> fields;
+	long line_number = 0;
+	long version;
+
+	if(!in)
+	{
+		std::cerr << "ERROR: Couldn't open image file \"" << path << "\"." << std::endl;
+		return false;
+	}
+
+	// Check the header.
+	std::getline(in, line);
+	++line_number;
+	split_fields(line, &fields);
+	if((fields.size() != 2) || (fields[0] != f_image_magic) || !field_to_number(fields[1], &version))
+	{
+		std::cerr << "ERROR: \"" << path << "\" isn't a CoFlo image file." << std::endl;
+		return false;
+	}
+	if(version != f_image_format_version)
+	{
+		std::cerr << "ERROR: Image file \"" << path << "\" is format version " << version
+			<< ", expected version " << f_image_format_version << "." << std::endl;
+		return false;
+	}
+
+	// Read the Functions, each followed by its vertices.  Nothing is added to the image unless the whole file is good.
+	std::vector<ImageFunction> functions;
+	std::size_t num_vertices_expected = 0;
+	while(std::getline(in, line))
+	{
+		++line_number;
+		split_fields(line, &fields);
+
+		bool ok = true;
+		if(fields[0] == "function")
+		{
+			ImageFunction f;
+			ok = (fields.size() == 5) && (functions.empty() || (functions.back().m_vertices.size() == num_vertices_expected))
+					&& field_to_number(fields[3], &f.m_fingerprint) && field_to_number(fields[4], &num_vertices_expected);
+			if(ok)
+			{
+				f.m_identifier = fields[1];
+				f.m_definition_file_path = fields[2];
+				functions.push_back(f);
+			}
+		}
+		else if(fields[0] == "vertex")
+		{
+			ImageVertex v;
+			long line_no, column;
+			ok = (fields.size() >= 7) && !functions.empty() && (functions.back().m_vertices.size() < num_vertices_expected)
+					&& field_to_number(fields[5], &line_no) && field_to_number(fields[6], &column);
+			if(!ok)
+			{
+				// Don't look at any of the fields.
+			}
+			else if(fields[1] == "ENTRY")
+			{
+				v.m_kind = ImageVertex::ENTRY;
+			}
+			else if(fields[1] == "EXIT")
+			{
+				v.m_kind = ImageVertex::EXIT;
+			}
+			else if(fields[1] == "CALL")
+			{
+				v.m_kind = ImageVertex::CALL;
+			}
+			else
+			{
+				ok = false;
+			}
+			// Entry comes first, and only first.
+			ok = ok && ((v.m_kind == ImageVertex::ENTRY) == functions.back().m_vertices.empty());
+			for(std::size_t i = 7; ok && (i < fields.size()); ++i)
+			{
+				long s;
+				ok = field_to_number(fields[i], &s) && (s >= 0) && (static_cast<std::size_t>(s) < num_vertices_expected);
+				v.m_successors.push_back(s);
+			}
+			if(ok)
+			{
+				v.m_identifier = fields[2];
+				v.m_params = fields[3];
+				v.m_location = Location(fields[4], line_no, column);
+				functions.back().m_vertices.push_back(v);
+			}
+		}
+		else
+		{
+			ok = false;
+		}
+
+		if(!ok)
+		{
+			std::cerr << "ERROR: " << path << ":" << line_number << ": Invalid image record." << std::endl;
+			return false;
+		}
+	}
+	if(!functions.empty() && (functions.back().m_vertices.size() != num_vertices_expected))
+	{
+		std::cerr << "ERROR: Image file \"" << path << "\" is truncated." << std::endl;
+		return false;
+	}
+
+	BOOST_FOREACH(const ImageFunction &f, functions)
+	{
+		// Every shard which includes a header with an inline function in it will have a copy of that function.
+		// There's no point in keeping more than one.
+		function_index_type existing = LookupFunction(f.m_identifier);
+		if((existing != NO_FUNCTION) && (m_functions[existing].m_fingerprint == f.m_fingerprint))
+		{
+			++m_num_duplicate_functions;
+			continue;
+		}
+
+		InsertFunction(f);
+	}
+
+	return true;
+}
+
+void ProgramImage::Link(std::set<std::string> *unresolved_identifiers)
+{
+	m_vertex_base.clear();
+	m_num_vertices = 0;
+
+	for(std::size_t f = 0; f < m_functions.size(); ++f)
+	{
+		m_vertex_base.push_back(m_num_vertices);
+		m_num_vertices += m_functions[f].m_vertices.size();
+
+		BOOST_FOREACH(ImageVertex &v, m_functions[f].m_vertices)
+		{
+			if(v.m_kind != ImageVertex::CALL)
+			{
+				continue;
+			}
+
+			v.m_callee = LookupFunction(v.m_identifier);
+			if(v.m_callee == NO_FUNCTION)
+			{
+				unresolved_identifiers->insert(v.m_identifier);
+			}
+		}
+	}
+}
+
+ProgramImage::function_index_type ProgramImage::LookupFunction(const std::string &function_id) const
+{
+	std::map<std::string, function_index_type>::const_iterator it = m_function_index.find(function_id);
+
+	if(it == m_function_index.end())
+	{
+		return NO_FUNCTION;
+	}
+
+	return it->second;
+}
+
+bool ProgramImage::FindPath(function_index_type source, function_index_type sink, std::vector<vertex_type> *path) const
+{
+	// Each vertex is visited at most once.  As with skeleton_witness_path(), there's no need to track the call stack:
+	// returning from a call never reaches anything the call's own skeleton successors don't.
+	const vertex_type no_parent(NO_FUNCTION, -1);
+	std::vector<vertex_type> parent(m_num_vertices, no_parent);
+	std::vector<bool> visited(m_num_vertices, false);
+	std::deque<vertex_type> queue;
+	const vertex_type start(source, 0);
+	const vertex_type goal(sink, 0);
+
+	path->clear();
+
+	if((m_vertex_base.size() != m_functions.size())
+			|| m_functions[source].m_vertices.empty() || m_functions[sink].m_vertices.empty())
+	{
+		// Not linked, or nothing to search.
+		return false;
+	}
+
+	visited[m_vertex_base[source]] = true;
+	queue.push_back(start);
+
+	bool found = (start == goal);
+	while(!queue.empty() && !found)
+	{
+		vertex_type u = queue.front();
+		queue.pop_front();
+
+		const ImageVertex &uv = GetVertex(u);
+
+		// The next vertices are the intraprocedural successors, and for a linked call, the callee's Entry.
+		std::vector<vertex_type> next;
+		BOOST_FOREACH(long s, uv.m_successors)
+		{
+			next.push_back(vertex_type(u.first, s));
+		}
+		if(uv.m_callee != NO_FUNCTION && !m_functions[uv.m_callee].m_vertices.empty())
+		{
+			next.push_back(vertex_type(uv.m_callee, 0));
+		}
+
+		BOOST_FOREACH(const vertex_type &w, next)
+		{
+			std::size_t wi = m_vertex_base[w.first] + w.second;
+			if(visited[wi])
+			{
+				continue;
+			}
+			visited[wi] = true;
+			parent[wi] = u;
+
+			if(w == goal)
+			{
+				found = true;
+				break;
+			}
+
+			queue.push_back(w);
+		}
+	}
+
+	if(!found)
+	{
+		return false;
+	}
+
+	for(vertex_type v = goal; v != no_parent; v = parent[m_vertex_base[v.first] + v.second])
+	{
+		path->insert(path->begin(), v);
+	}
+
+	return true;
+}
+
+void ProgramImage::InsertFunction(const ImageFunction &f)
+{
+	// A later definition with the same identifier replaces the earlier one in the map, as it does in the Program's
+	// function map.
+	m_function_index[f.m_identifier] = m_functions.size();
+	m_functions.push_back(f);
+}
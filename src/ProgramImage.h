@@ -0,0 +1,188 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#ifndef PROGRAMIMAGE_H
+#define PROGRAMIMAGE_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Location.h"
+
+class Function;
+
+/**
+ * A serializable image of the Functions of all or part of a Program, holding just what's needed to link them and
+ * check reachability constraints: each Function's ReachabilitySkeleton, with the calls identified by the name of the
+ * function they call.
+ *
+ * This is what makes sharded analysis possible.  Each "coflo --shard I/N" process parses and builds a share of the
+ * TranslationUnits and writes their image, and "coflo --merge" reads all the images, links the calls between them by
+ * name, and checks the constraints, without ever having the whole Program's control flow graphs in memory at once.
+ *
+ * The image file is line-oriented text, with tab-separated fields:
+ * @code
+ * COFLO_IMAGE <version>
+ * function <identifier> <definition file path> <fingerprint> <number of vertices>
+ * vertex <ENTRY|EXIT|CALL> <callee identifier> <parameters> <file> <line> <column> <successor index>...
+ * ...
+ * @endcode
+ * Each function is followed by its skeleton vertices, Entry first.  Tabs, newlines and backslashes within fields are
+ * backslash-escaped.
+ */
+class ProgramImage
+{
+public:
+
+	/// Index of a Function in the image.
+	typedef long function_index_type;
+
+	/// Function index value meaning "no function", e.g. for a call which couldn't be linked.
+	static const function_index_type NO_FUNCTION = -1;
+
+	/**
+	 * A vertex of a Function's reachability skeleton.
+	 */
+	struct ImageVertex
+	{
+		enum Kind { ENTRY, EXIT, CALL };
+
+		ImageVertex() { m_kind = ENTRY; m_callee = NO_FUNCTION; };
+
+		Kind m_kind;
+
+		/// For calls, the identifier of the function called.
+		std::string m_identifier;
+
+		/// For calls, the parameters passed.
+		std::string m_params;
+
+		Location m_location;
+
+		/// Indices of the skeleton successors within the same Function.
+		std::vector<long> m_successors;
+
+		/// For calls, the Function called, or NO_FUNCTION until Link() finds it.
+		function_index_type m_callee;
+	};
+
+	/**
+	 * A Function's skeleton.
+	 */
+	struct ImageFunction
+	{
+		std::string m_identifier;
+		std::string m_definition_file_path;
+
+		/// The Function's structural fingerprint, for recognizing duplicate definitions across shards.
+		std::size_t m_fingerprint;
+
+		/// The skeleton vertices.  The Entry vertex is always first.
+		std::vector<ImageVertex> m_vertices;
+	};
+
+	/// A vertex of the linked image: the Function it's in and its index within the Function.
+	typedef std::pair<function_index_type, long> vertex_type;
+
+	ProgramImage();
+	~ProgramImage();
+
+	/**
+	 * Add the skeleton of @a f, whose control flow graph must have been built, to the image.
+	 */
+	void AddFunction(const Function &f);
+
+	/**
+	 * Write the image to the file at @a path.
+	 *
+	 * @return true on success, false if the file couldn't be written.
+	 */
+	bool Write(const std::string &path) const;
+
+	/**
+	 * Read the image file at @a path and add its Functions to this image.  A Function whose identifier and
+	 * fingerprint match one already in the image, e.g. a header's inline function which every shard has a copy of,
+	 * is skipped.
+	 *
+	 * @return true on success, false if the file couldn't be read or isn't a valid image.
+	 */
+	bool Read(const std::string &path);
+
+	/**
+	 * Resolve each call in the image to the Function it calls, by identifier.
+	 *
+	 * @param[out] unresolved_identifiers  The identifiers of the functions called which aren't in the image.
+	 */
+	void Link(std::set<std::string> *unresolved_identifiers);
+
+	/**
+	 * @return The index of the Function with identifier @a function_id, or NO_FUNCTION if there isn't one.
+	 */
+	function_index_type LookupFunction(const std::string &function_id) const;
+
+	/**
+	 * Find a path from the Entry of Function @a source to the Entry of Function @a sink in the linked image.
+	 * The search is breadth-first, so the path found passes through the fewest skeleton vertices.
+	 *
+	 * @param source  The Function to start at.
+	 * @param sink  The Function to find.
+	 * @param[out] path  If a path is found, its vertices from @a source's Entry to @a sink's Entry, in order.  If
+	 *   @a source is @a sink, that's just the one Entry.
+	 * @return true if @a sink is reachable from @a source.
+	 */
+	bool FindPath(function_index_type source, function_index_type sink, std::vector<vertex_type> *path) const;
+
+	/// @name Accessors.
+	//@{
+	std::size_t NumFunctions() const { return m_functions.size(); };
+	const ImageFunction& GetFunction(function_index_type f) const { return m_functions[f]; };
+	const ImageVertex& GetVertex(const vertex_type &v) const { return m_functions[v.first].m_vertices[v.second]; };
+
+	/**
+	 * @return The number of Functions skipped by Read() because they duplicated ones already in the image.
+	 */
+	long GetNumDuplicateFunctions() const { return m_num_duplicate_functions; };
+	//@}
+
+private:
+
+	/// Add @a f to the image and the identifier map.
+	void InsertFunction(const ImageFunction &f);
+
+	/// The Functions.
+	std::vector<ImageFunction> m_functions;
+
+	/// Map of identifiers to Function indices.
+	std::map<std::string, function_index_type> m_function_index;
+
+	/// Offset of each Function's vertices in the flat search arrays used by FindPath().  Set up by Link().
+	std::vector<std::size_t> m_vertex_base;
+
+	/// Total number of vertices in the image.  Set up by Link().
+	std::size_t m_num_vertices;
+
+	long m_num_duplicate_functions;
+};
+
+#endif /* PROGRAMIMAGE_H */
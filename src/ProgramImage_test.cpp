@@ -0,0 +1,259 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/foreach.hpp>
+
+#include "ProgramImage.h"
+#include "Function.h"
+#include "TranslationUnit.h"
+#include "controlflowgraph/statements/FunctionCall.h"
+#include "controlflowgraph/statements/If.h"
+#include "controlflowgraph/statements/Label.h"
+#include "controlflowgraph/analysis/Analyzer.h"
+#include "controlflowgraph/analysis/ResultsSink.h"
+#include "controlflowgraph/analysis/RuleReachability.h"
+#include "debug_utils/output_sink.hpp"
+
+/// Name of the scratch image file the tests write.
+static const char f_test_image_path[] = "ProgramImage_test.img";
+
+/// a() calls b(), which calls c().  d() calls a function which isn't in the image.
+static const char f_test_image[] =
+		"COFLO_IMAGE\t1\n"
+		"function\ta\ta.c\t101\t3\n"
+		"vertex\tENTRY\t\t\ta.c\t0\t-1\t1\n"
+		"vertex\tCALL\tb\tx\\ty\ta.c\t3\t5\t2\n"
+		"vertex\tEXIT\t\t\ta.c\t0\t-1\n"
+		"function\tb\tb.c\t102\t3\n"
+		"vertex\tENTRY\t\t\tb.c\t0\t-1\t1\n"
+		"vertex\tCALL\tc\t\tb.c\t7\t2\t2\n"
+		"vertex\tEXIT\t\t\tb.c\t0\t-1\n"
+		"function\tc\tb.c\t103\t2\n"
+		"vertex\tENTRY\t\t\tb.c\t0\t-1\t1\n"
+		"vertex\tEXIT\t\t\tb.c\t0\t-1\n"
+		"function\td\td.c\t104\t3\n"
+		"vertex\tENTRY\t\t\td.c\t0\t-1\t1\n"
+		"vertex\tCALL\tmissing\t\td.c\t2\t1\t2\n"
+		"vertex\tEXIT\t\t\td.c\t0\t-1\n";
+
+static void write_test_file(const std::string &contents)
+{
+	std::ofstream out(f_test_image_path);
+	out << contents;
+}
+
+/**
+ * A ResultsSink which keeps the results, instead of writing them out.
+ */
+class CollectingResultsSink : public ResultsSink
+{
+public:
+	explicit CollectingResultsSink(output_sink &sink) : ResultsSink(sink) {};
+
+	std::vector<RuleResult> m_results;
+
+protected:
+	virtual void FormatResult(std::ostream &/*os*/, const RuleResult &result) { m_results.push_back(result); };
+};
+
+TEST(ProgramImageTest, ReadLinkAndFindPath)
+{
+	ProgramImage image;
+	std::set<std::string> unresolved;
+	std::vector<ProgramImage::vertex_type> path;
+
+	write_test_file(f_test_image);
+	ASSERT_TRUE(image.Read(f_test_image_path));
+	std::remove(f_test_image_path);
+
+	ASSERT_EQ(4U, image.NumFunctions());
+	ASSERT_EQ("x\ty", image.GetFunction(image.LookupFunction("a")).m_vertices[1].m_params);
+
+	image.Link(&unresolved);
+	ASSERT_EQ(1U, unresolved.size());
+	ASSERT_EQ("missing", *unresolved.begin());
+
+	// a() -> b() -> c().
+	ASSERT_TRUE(image.FindPath(image.LookupFunction("a"), image.LookupFunction("c"), &path));
+	ASSERT_EQ(5U, path.size());
+	ASSERT_EQ("b", image.GetVertex(path[1]).m_identifier);
+	ASSERT_EQ("c", image.GetVertex(path[3]).m_identifier);
+	ASSERT_EQ(7, image.GetVertex(path[3]).m_location.GetLineNumber());
+
+	// Nothing calls back up the chain.
+	ASSERT_FALSE(image.FindPath(image.LookupFunction("c"), image.LookupFunction("a"), &path));
+	ASSERT_FALSE(image.FindPath(image.LookupFunction("d"), image.LookupFunction("a"), &path));
+}
+
+TEST(ProgramImageTest, WriteRoundTripsAndMergeSkipsDuplicates)
+{
+	ProgramImage image, merged;
+	std::set<std::string> unresolved;
+	std::vector<ProgramImage::vertex_type> path;
+
+	write_test_file(f_test_image);
+	ASSERT_TRUE(image.Read(f_test_image_path));
+	ASSERT_TRUE(image.Write(f_test_image_path));
+
+	// Reading the same image twice, as when every shard has a copy of the same inline function, keeps one copy.
+	ASSERT_TRUE(merged.Read(f_test_image_path));
+	ASSERT_TRUE(merged.Read(f_test_image_path));
+	std::remove(f_test_image_path);
+	ASSERT_EQ(4U, merged.NumFunctions());
+	ASSERT_EQ(4, merged.GetNumDuplicateFunctions());
+
+	merged.Link(&unresolved);
+	ASSERT_TRUE(merged.FindPath(merged.LookupFunction("a"), merged.LookupFunction("c"), &path));
+	ASSERT_EQ(5U, path.size());
+	ASSERT_EQ("x\ty", merged.GetVertex(path[1]).m_params);
+}
+
+TEST(ProgramImageTest, RejectsInvalidImages)
+{
+	ProgramImage image;
+
+	write_test_file("COFLO_IMAGE\t2\n");
+	ASSERT_FALSE(image.Read(f_test_image_path));
+
+	// Successor out of range.
+	write_test_file("COFLO_IMAGE\t1\nfunction\ta\ta.c\t1\t1\nvertex\tENTRY\t\t\ta.c\t0\t-1\t1\n");
+	ASSERT_FALSE(image.Read(f_test_image_path));
+
+	// Truncated.
+	write_test_file("COFLO_IMAGE\t1\nfunction\ta\ta.c\t1\t2\nvertex\tENTRY\t\t\ta.c\t0\t-1\t1\n");
+	ASSERT_FALSE(image.Read(f_test_image_path));
+	std::remove(f_test_image_path);
+
+	ASSERT_EQ(0U, image.NumFunctions());
+}
+
+TEST(ProgramImageTest, MergeMatchesInProcessAnalysis)
+{
+	TranslationUnit tu(NULL, "test.c");
+	const char *names[] = { "main", "helper", "sink" };
+	std::vector<Function*> functions;
+	std::vector<StatementBase*> statement_lists[3];
+	std::map<std::string, Function*> function_map;
+
+	// main() calls helper() on one arm of an if, and helper() calls sink().
+	statement_lists[0].push_back(new If(Location("test.c", 2, 1), "c", "then", "else"));
+	statement_lists[0].push_back(new Label(Location("test.c", 3, 1), "then"));
+	statement_lists[0].push_back(new FunctionCall("helper", Location("test.c", 4, 3), "c"));
+	statement_lists[0].push_back(new Label(Location("test.c", 5, 1), "else"));
+	statement_lists[1].push_back(new FunctionCall("sink", Location("test.c", 9, 3), ""));
+
+	for(std::size_t i = 0; i < 3; ++i)
+	{
+		functions.push_back(new Function(&tu, names[i]));
+		function_map[names[i]] = functions.back();
+		functions.back()->SetStatementList(&statement_lists[i]);
+		ASSERT_TRUE(functions.back()->BuildControlFlowGraph());
+	}
+
+	ProgramImage image;
+	std::set<std::string> unresolved;
+	for(std::size_t i = 0; i < 3; ++i)
+	{
+		functions[i]->Link(function_map, NULL);
+		image.AddFunction(*functions[i]);
+	}
+	image.Link(&unresolved);
+
+	// Check every pair of functions, including each against itself, both ways.
+	std::vector<std::string> constraints;
+	std::vector<RuleResult> in_process_results;
+	for(std::size_t i = 0; i < 3; ++i)
+	{
+		for(std::size_t j = 0; j < 3; ++j)
+		{
+			RuleReachability rule(*functions[i]->GetCFGPointer(), functions[i], functions[j]);
+			RuleResult result;
+
+			ASSERT_TRUE(rule.RunRule(&result));
+			in_process_results.push_back(result);
+			constraints.push_back(std::string(names[i]) + "() -x " + names[j] + "()");
+		}
+	}
+
+	std::ostringstream out;
+	output_sink out_sink(out);
+	CollectingResultsSink merge_results(out_sink);
+	Analyzer analyzer;
+	ASSERT_TRUE(analyzer.AnalyzeImage(image, constraints, &merge_results));
+	ASSERT_EQ(in_process_results.size(), merge_results.m_results.size());
+
+	for(std::size_t k = 0; k < constraints.size(); ++k)
+	{
+		const RuleResult &in_process = in_process_results[k];
+		const RuleResult &merged = merge_results.m_results[k];
+
+		SCOPED_TRACE(constraints[k]);
+		ASSERT_EQ(in_process.m_status, merged.m_status);
+		if(in_process.m_status != RuleResult::VIOLATED)
+		{
+			continue;
+		}
+		EXPECT_EQ(in_process.m_function, merged.m_function);
+		EXPECT_EQ(in_process.m_statement, merged.m_statement);
+		EXPECT_EQ(in_process.m_location.GetLineNumber(), merged.m_location.GetLineNumber());
+
+		// The merged witness is the in-process one without its decisions.
+		std::vector<WitnessStep> calls;
+		BOOST_FOREACH(const WitnessStep &step, in_process.m_witness)
+		{
+			if(step.m_text.find(", taking out edge") == std::string::npos)
+			{
+				calls.push_back(step);
+			}
+		}
+		ASSERT_EQ(calls.size(), merged.m_witness.size());
+		for(std::size_t w = 0; w < calls.size(); ++w)
+		{
+			EXPECT_EQ(calls[w].m_text, merged.m_witness[w].m_text);
+			EXPECT_EQ(calls[w].m_location.GetLineNumber(), merged.m_witness[w].m_location.GetLineNumber());
+			EXPECT_EQ(calls[w].m_depth, merged.m_witness[w].m_depth);
+		}
+	}
+
+	// main() reaches sink() through both helper() and a decision, main() trivially reaches itself, and sink() doesn't
+	// reach back up to main().
+	EXPECT_EQ(RuleResult::VIOLATED, in_process_results[2].m_status);
+	EXPECT_EQ(RuleResult::VIOLATED, in_process_results[0].m_status);
+	EXPECT_EQ(RuleResult::NOT_VIOLATED, in_process_results[6].m_status);
+	EXPECT_EQ(3U, in_process_results[2].m_witness.size());
+
+	for(std::size_t i = 0; i < 3; ++i)
+	{
+		delete functions[i];
+		BOOST_FOREACH(StatementBase *sbp, statement_lists[i])
+		{
+			delete sbp;
+		}
+	}
+}
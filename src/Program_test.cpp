@@ -0,0 +1,207 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <boost/foreach.hpp>
+
+#include "Program.h"
+#include "TranslationUnit.h"
+#include "Function.h"
+#include "controlflowgraph/statements/FunctionCall.h"
+#include "Location.h"
+
+/**
+ * Test fixture for the on-demand building and linking of a Program's control flow graphs.
+ *
+ * The tests add Functions made only of calls straight to the Program, without compiling or parsing anything.
+ */
+class ProgramTest : public ::testing::Test
+{
+protected:
+	ProgramTest() {};
+	virtual ~ProgramTest() {};
+
+	virtual void SetUp()
+	{
+		m_tu = new TranslationUnit(&m_program, "test.c");
+	};
+
+	virtual void TearDown()
+	{
+		BOOST_FOREACH(Function *f, m_functions)
+		{
+			delete f;
+		}
+		for(std::size_t i = 0; i < m_statement_lists.size(); ++i)
+		{
+			BOOST_FOREACH(StatementBase *sbp, *m_statement_lists[i])
+			{
+				delete sbp;
+			}
+			delete m_statement_lists[i];
+		}
+		delete m_tu;
+	};
+
+	/// Add a Function called @a identifier to the Program.
+	Function* AddFunction(const std::string &identifier)
+	{
+		m_functions.push_back(new Function(m_tu, identifier));
+		m_statement_lists.push_back(new std::vector<StatementBase*>);
+		m_program.m_function_map[identifier] = m_functions.back();
+		return m_functions.back();
+	};
+
+	/// Add a call to @a callee at the end of @a caller's statement list.
+	FunctionCall* AddCall(Function *caller, Function *callee)
+	{
+		FunctionCall *fc = new FunctionCall(callee->GetIdentifier(), Location(), "");
+		m_statement_lists[IndexOf(caller)]->push_back(fc);
+		return fc;
+	};
+
+	/// Hand the Functions their statement lists and build the Program's CallGraph, as Program::Parse() would.
+	void FinishParse()
+	{
+		T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP unresolved_function_calls;
+
+		for(std::size_t i = 0; i < m_functions.size(); ++i)
+		{
+			m_functions[i]->SetStatementList(m_statement_lists[i]);
+		}
+		m_program.m_call_graph.Build(m_functions, m_program.m_function_map, &unresolved_function_calls);
+	};
+
+	std::size_t IndexOf(Function *f) const
+	{
+		return std::find(m_functions.begin(), m_functions.end(), f) - m_functions.begin();
+	};
+
+	Program m_program;
+	TranslationUnit *m_tu;
+	std::vector<Function*> m_functions;
+	std::vector< std::vector<StatementBase*>* > m_statement_lists;
+};
+
+TEST_F(ProgramTest, MaterializeCallPathsBuildsOnlyTheSlice)
+{
+	Function *main_f = AddFunction("main");
+	Function *a = AddFunction("a");
+	Function *b = AddFunction("b");
+	Function *c = AddFunction("c");
+	Function *d = AddFunction("d");
+	Function *sink = AddFunction("sink");
+	Function *e = AddFunction("e");
+
+	// main() reaches sink() only through a().  b() and c() don't reach it, d() isn't reachable from main(), and e() is
+	// only called by sink().
+	FunctionCall *main_calls_a = AddCall(main_f, a);
+	FunctionCall *main_calls_b = AddCall(main_f, b);
+	FunctionCall *a_calls_c = AddCall(a, c);
+	FunctionCall *a_calls_sink = AddCall(a, sink);
+	AddCall(b, c);
+	AddCall(d, sink);
+	FunctionCall *sink_calls_e = AddCall(sink, e);
+	FinishParse();
+
+	EXPECT_EQ(3, m_program.MaterializeCallPaths(main_f, sink));
+
+	EXPECT_TRUE(main_f->IsControlFlowGraphBuilt());
+	EXPECT_TRUE(a->IsControlFlowGraphBuilt());
+	EXPECT_TRUE(sink->IsControlFlowGraphBuilt());
+	EXPECT_FALSE(b->IsControlFlowGraphBuilt());
+	EXPECT_FALSE(c->IsControlFlowGraphBuilt());
+	EXPECT_FALSE(d->IsControlFlowGraphBuilt());
+	EXPECT_FALSE(e->IsControlFlowGraphBuilt());
+
+	// The calls along the path are linked, and the ones leaving the slice aren't.
+	EXPECT_EQ(a, main_calls_a->GetCalledFunction());
+	EXPECT_EQ(sink, a_calls_sink->GetCalledFunction());
+	EXPECT_TRUE(a->IsCalled());
+	EXPECT_TRUE(sink->IsCalled());
+	EXPECT_FALSE(main_calls_b->IsResolved());
+	EXPECT_FALSE(a_calls_c->IsResolved());
+	EXPECT_FALSE(sink_calls_e->IsResolved());
+}
+
+TEST_F(ProgramTest, MaterializeCallPathsWithoutAPath)
+{
+	Function *a = AddFunction("a");
+	Function *b = AddFunction("b");
+	Function *c = AddFunction("c");
+
+	// Neither a() nor b() can reach the other.
+	AddCall(a, c);
+	AddCall(b, c);
+	FinishParse();
+
+	// The endpoints are still built, but nothing else is.
+	EXPECT_EQ(2, m_program.MaterializeCallPaths(a, b));
+	EXPECT_TRUE(a->IsControlFlowGraphBuilt());
+	EXPECT_TRUE(b->IsControlFlowGraphBuilt());
+	EXPECT_FALSE(c->IsControlFlowGraphBuilt());
+
+	// A Function on its own is its own slice.
+	EXPECT_EQ(1, m_program.MaterializeCallPaths(c, c));
+	EXPECT_TRUE(c->IsControlFlowGraphBuilt());
+}
+
+TEST_F(ProgramTest, LaterMaterializationLinksEarlierFunctions)
+{
+	Function *a = AddFunction("a");
+	Function *b = AddFunction("b");
+	Function *c = AddFunction("c");
+	Function *d = AddFunction("d");
+
+	FunctionCall *a_calls_b = AddCall(a, b);
+	FunctionCall *b_calls_c = AddCall(b, c);
+	FunctionCall *d_calls_a = AddCall(d, a);
+	FinishParse();
+
+	// Only a() and the Functions it calls directly are built.  b()'s call to c() has to wait for c().
+	m_program.MaterializeFunction(a);
+	EXPECT_TRUE(a->IsControlFlowGraphBuilt());
+	EXPECT_TRUE(b->IsControlFlowGraphBuilt());
+	EXPECT_FALSE(c->IsControlFlowGraphBuilt());
+	EXPECT_EQ(b, a_calls_b->GetCalledFunction());
+	EXPECT_FALSE(b_calls_c->IsResolved());
+	EXPECT_EQ(1U, b->GetUnlinkedFunctionCalls().size());
+
+	// Building c() later links the call into it from b(), which was built earlier.
+	m_program.MaterializeFunction(c);
+	EXPECT_TRUE(c->IsControlFlowGraphBuilt());
+	EXPECT_EQ(c, b_calls_c->GetCalledFunction());
+	EXPECT_TRUE(c->IsCalled());
+	EXPECT_TRUE(b->GetUnlinkedFunctionCalls().empty());
+
+	// Building d() later links its call into a(), which was built earlier.
+	EXPECT_FALSE(a->IsCalled());
+	m_program.MaterializeFunction(d);
+	EXPECT_EQ(a, d_calls_a->GetCalledFunction());
+	EXPECT_TRUE(a->IsCalled());
+	EXPECT_TRUE(d->GetUnlinkedFunctionCalls().empty());
+
+	// a()'s call into b() wasn't linked again along the way.  b()'s Entry has its self-edge and the one call edge.
+	EXPECT_EQ(2U, b->GetEntryVertexDescriptor()->InDegree());
+}
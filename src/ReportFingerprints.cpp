@@ -0,0 +1,153 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "ReportFingerprints.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+/// Version of the fingerprints file format.  Bump this whenever the format changes.
+static const long f_fingerprints_format_version = 1;
+
+/// The first word of every fingerprints file.
+static const char f_fingerprints_magic[] = "COFLO_REPORT_FINGERPRINTS";
+
+ReportFingerprints::ReportFingerprints()
+{
+}
+
+ReportFingerprints::~ReportFingerprints()
+{
+}
+
+bool ReportFingerprints::Read(const std::string &path)
+{
+	std::ifstream infile(path.c_str());
+	std::string line;
+
+	m_render_settings.clear();
+	m_fingerprints.clear();
+
+	if(!std::getline(infile, line))
+	{
+		return false;
+	}
+
+	// Check the header.
+	std::ostringstream expected_header;
+	expected_header << f_fingerprints_magic << "\t" << f_fingerprints_format_version << "\t";
+	if(line.compare(0, expected_header.str().size(), expected_header.str()) != 0)
+	{
+		return false;
+	}
+	std::string render_settings = line.substr(expected_header.str().size());
+
+	map_type fingerprints;
+	while(std::getline(infile, line))
+	{
+		std::string::size_type tab = line.find('\t');
+		if(tab != 16 || line.size() == tab + 1)
+		{
+			return false;
+		}
+
+		fingerprint_type fingerprint = 0;
+		for(std::string::size_type i = 0; i < tab; ++i)
+		{
+			char c = line[i];
+			int digit;
+			if(c >= '0' && c <= '9')
+			{
+				digit = c - '0';
+			}
+			else if(c >= 'a' && c <= 'f')
+			{
+				digit = c - 'a' + 10;
+			}
+			else
+			{
+				return false;
+			}
+			fingerprint = (fingerprint << 4) | digit;
+		}
+
+		fingerprints[line.substr(tab + 1)] = fingerprint;
+	}
+
+	m_render_settings = render_settings;
+	m_fingerprints.swap(fingerprints);
+
+	return true;
+}
+
+bool ReportFingerprints::Write(const std::string &path) const
+{
+	// Write to a temporary file and rename it into place, so an interrupted run can't leave a truncated file behind.
+	std::string temp_path = path + ".tmp";
+
+	{
+		std::ofstream outfile(temp_path.c_str());
+
+		outfile << f_fingerprints_magic << "\t" << f_fingerprints_format_version << "\t" << m_render_settings << "\n";
+
+		for(map_type::const_iterator it = m_fingerprints.begin(); it != m_fingerprints.end(); ++it)
+		{
+			char hex[17];
+			std::sprintf(hex, "%08lx%08lx", static_cast<unsigned long>(it->second >> 32),
+					static_cast<unsigned long>(it->second & 0xffffffffUL));
+			outfile << hex << "\t" << it->first << "\n";
+		}
+
+		outfile.close();
+		if(outfile.fail())
+		{
+			std::remove(temp_path.c_str());
+			return false;
+		}
+	}
+
+	return std::rename(temp_path.c_str(), path.c_str()) == 0;
+}
+
+bool ReportFingerprints::Lookup(const std::string &identifier, fingerprint_type *fingerprint) const
+{
+	map_type::const_iterator it = m_fingerprints.find(identifier);
+
+	if(it == m_fingerprints.end())
+	{
+		return false;
+	}
+
+	*fingerprint = it->second;
+	return true;
+}
+
+ReportFingerprints::fingerprint_type ReportFingerprints::Compute(const std::string &data)
+{
+	fingerprint_type hash = 0xcbf29ce484222325ULL;
+
+	for(std::string::size_type i = 0; i < data.size(); ++i)
+	{
+		hash ^= static_cast<unsigned char>(data[i]);
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#ifndef REPORTFINGERPRINTS_H
+#define REPORTFINGERPRINTS_H
+
+#include <map>
+#include <string>
+
+#include <boost/cstdint.hpp>
+
+/**
+ * The fingerprints of the control flow graphs drawn in a report, saved in the report's directory so the next run
+ * which writes to the same directory can tell which drawings are already up to date.
+ *
+ * Each entry maps a Function's identifier to the fingerprint of the graph its drawing was made from.  The whole
+ * set is also tagged with the render settings, e.g. which renderer was used, since changing them makes every
+ * drawing out of date.
+ *
+ * The file is line-oriented text:
+ * @code
+ * COFLO_REPORT_FINGERPRINTS <version> <render settings>
+ * <fingerprint, 16 hex digits> <identifier>
+ * ...
+ * @endcode
+ * with tab-separated fields.
+ */
+class ReportFingerprints
+{
+public:
+
+	/// A fingerprint.  These are saved between runs, so they're computed with a fixed hash function, not boost::hash.
+	typedef boost::uint64_t fingerprint_type;
+
+	/// Map of Function identifiers to fingerprints.
+	typedef std::map<std::string, fingerprint_type> map_type;
+
+	ReportFingerprints();
+	~ReportFingerprints();
+
+	/**
+	 * Read the fingerprints and render settings saved in the file at @a path, replacing any already in this object.
+	 *
+	 * @return true if the file was read, false if it doesn't exist or isn't a valid fingerprints file.  In that case
+	 *         this object is left empty.
+	 */
+	bool Read(const std::string &path);
+
+	/**
+	 * Write the fingerprints to the file at @a path, replacing it.
+	 *
+	 * @return true on success.
+	 */
+	bool Write(const std::string &path) const;
+
+	/**
+	 * Look up the fingerprint of @a identifier.
+	 *
+	 * @return true if there is one.
+	 */
+	bool Lookup(const std::string &identifier, fingerprint_type *fingerprint) const;
+
+	void Set(const std::string &identifier, fingerprint_type fingerprint) { m_fingerprints[identifier] = fingerprint; };
+
+	/**
+	 * Set the description of everything other than the graphs themselves which affects the drawings.  It must not
+	 * contain tabs or newlines.
+	 */
+	void SetRenderSettings(const std::string &render_settings) { m_render_settings = render_settings; };
+
+	const std::string& GetRenderSettings() const { return m_render_settings; };
+
+	const map_type& GetFingerprints() const { return m_fingerprints; };
+
+	/**
+	 * Compute the fingerprint of @a data, with the 64-bit FNV-1a hash.
+	 */
+	static fingerprint_type Compute(const std::string &data);
+
+private:
+
+	std::string m_render_settings;
+
+	map_type m_fingerprints;
+};
+
+#endif /* REPORTFINGERPRINTS_H */
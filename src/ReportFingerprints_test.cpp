@@ -0,0 +1,81 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "ReportFingerprints.h"
+
+/// Name of the scratch fingerprints file the tests write.
+static const char f_test_fingerprints_path[] = "ReportFingerprints_test.txt";
+
+TEST(ReportFingerprintsTest, ComputeIsFNV1a)
+{
+	// The published FNV-1a test vectors.
+	ASSERT_EQ(0xcbf29ce484222325ULL, ReportFingerprints::Compute(""));
+	ASSERT_EQ(0xaf63dc4c8601ec8cULL, ReportFingerprints::Compute("a"));
+	ASSERT_EQ(0x85944171f73967e8ULL, ReportFingerprints::Compute("foobar"));
+}
+
+TEST(ReportFingerprintsTest, WriteRoundTrips)
+{
+	ReportFingerprints written, read;
+	ReportFingerprints::fingerprint_type fingerprint = 0;
+
+	written.SetRenderSettings("dot 2.26");
+	written.Set("main", 0xfedcba9876543210ULL);
+	written.Set("operator new(unsigned long)", 1);
+	ASSERT_TRUE(written.Write(f_test_fingerprints_path));
+
+	ASSERT_TRUE(read.Read(f_test_fingerprints_path));
+	std::remove(f_test_fingerprints_path);
+
+	ASSERT_EQ("dot 2.26", read.GetRenderSettings());
+	ASSERT_EQ(2U, read.GetFingerprints().size());
+	ASSERT_TRUE(read.Lookup("main", &fingerprint));
+	ASSERT_EQ(0xfedcba9876543210ULL, fingerprint);
+	ASSERT_TRUE(read.Lookup("operator new(unsigned long)", &fingerprint));
+	ASSERT_EQ(1U, fingerprint);
+	ASSERT_FALSE(read.Lookup("missing", &fingerprint));
+}
+
+TEST(ReportFingerprintsTest, RejectsInvalidFiles)
+{
+	ReportFingerprints fingerprints;
+
+	{
+		std::ofstream outfile(f_test_fingerprints_path);
+		outfile << "COFLO_REPORT_FINGERPRINTS\t1\tdot 2.26\n0000000000000001\tmain\nnot a fingerprint\tf\n";
+	}
+	ASSERT_FALSE(fingerprints.Read(f_test_fingerprints_path));
+	ASSERT_TRUE(fingerprints.GetFingerprints().empty());
+
+	{
+		std::ofstream outfile(f_test_fingerprints_path);
+		outfile << "COFLO_REPORT_FINGERPRINTS\t2\tdot 2.26\n";
+	}
+	ASSERT_FALSE(fingerprints.Read(f_test_fingerprints_path));
+	std::remove(f_test_fingerprints_path);
+
+	// Missing.
+	ASSERT_FALSE(fingerprints.Read(f_test_fingerprints_path));
+}
@@ -134,6 +134,10 @@ void RuntimeConfiguration::ParseAllOptionSources(int argc, char* argv[])
 	(CLP_RESPONSE_FILE, po::value<std::string>(&response_filename), "Read command line options from file. Can also be specified with '@name'.")
 	(CLP_TEMPS_DIR, po::value< std::string >(), "The directory in which to put intermediate files during the analysis.")
 	(CLP_OUTPUT_DIR",O", po::value< std::string >(), "Put HTML report output in the given directory.")
+	(CLP_REPORT_USE_DOT, po::bool_switch()->default_value(false), "Draw the HTML report's control flow graphs with "
+			"GraphViz dot instead of CoFlo's built-in layout.  If CoFlo was configured --with-libgvc, this uses the "
+			"Graphviz libraries in-process instead of running the dot program.")
+	(CLP_JOBS",j", po::value< unsigned int >()->default_value(0), "Number of threads to use.  0 means one per CPU.")
 	;
 	preproc_options.add_options()
 	(CLP_DEFINE",D", po::value< std::vector<std::string> >(), "Define a preprocessing macro")
@@ -146,6 +150,18 @@ void RuntimeConfiguration::ParseAllOptionSources(int argc, char* argv[])
 	;
 	analysis_options.add_options()
 	(CLP_CONSTRAINT, po::value< std::vector<std::string> >(), "\"f1() -x f2()\" : Warn if f1 can reach f2.")
+	(CLP_SHARD, po::value< std::string >(), "\"I/N\" : Parse only the I'th of N shares of the input files and write their image "
+			"for a later --" CLP_MERGE ", instead of analyzing them.")
+	(CLP_IMAGE_FILE, po::value< std::string >(), "The image file --" CLP_SHARD " writes.  Defaults to \"coflo-shard-I-of-N.img\".")
+	(CLP_MERGE, po::value< std::vector<std::string> >()->multitoken(), "Link the given shard image files and check the "
+			"constraints against them, instead of parsing any input files.  The images only hold the calls, so violations "
+			"are reported with the chain of calls leading to them, without the decisions taken along the way.")
+	(CLP_RESULTS_FORMAT, po::value< std::string >()->default_value("text"), "The format of the constraint-checking results.\n"
+			"  text   : gcc-style warnings.\n"
+			"  ndjson : One JSON object per constraint, per line.\n"
+			"  sarif  : A SARIF 2.1.0 log.")
+	(CLP_RESULTS_FILE, po::value< std::string >(), "Write the constraint-checking results to the given file instead of "
+			"standard output.")
 	;
 	cfg_options.add_options()
 	(CLP_PRINT_FUNCTION_CFG, po::value< std::string >(), "Print the control flow graph of the given function to standard output.")
@@ -39,6 +39,8 @@
 #define CLP_DEBUG_CFG	"debug-cfg"
 #define CLP_TEMPS_DIR	"temps-dir"
 #define CLP_OUTPUT_DIR	"output-dir"
+#define CLP_REPORT_USE_DOT	"report-use-dot"
+#define CLP_JOBS	"jobs"
 
 #define CLP_DEFINE	"define"
 #define CLP_INCLUDE_DIR	"include-dir"
@@ -54,6 +56,11 @@
 #define CLP_CFG_OUTPUT_FILENAME "cfg-output-file"
 
 #define CLP_CONSTRAINT "constraint"
+#define CLP_SHARD "shard"
+#define CLP_MERGE "merge"
+#define CLP_IMAGE_FILE "image-file"
+#define CLP_RESULTS_FORMAT "results-format"
+#define CLP_RESULTS_FILE "results-file"
 
 #define CLP_INPUT_FILE "input-file"
 
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "ThreadPool.h"
+
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+
+ThreadPool::ThreadPool(unsigned int num_threads)
+{
+	if(num_threads == 0)
+	{
+		num_threads = boost::thread::hardware_concurrency();
+		if(num_threads == 0)
+		{
+			// Couldn't tell.
+			num_threads = 1;
+		}
+	}
+
+	m_num_threads = num_threads;
+	m_num_outstanding = 0;
+	m_stopping = false;
+
+	if(m_num_threads > 1)
+	{
+		for(unsigned int i = 0; i < m_num_threads; ++i)
+		{
+			m_workers.create_thread(boost::bind(&ThreadPool::WorkerLoop, this));
+		}
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	try
+	{
+		Wait();
+	}
+	catch(...)
+	{
+		// Nobody left to report it to.
+	}
+
+	{
+		boost::mutex::scoped_lock lock(m_mutex);
+		m_stopping = true;
+	}
+	m_work_available.notify_all();
+	m_workers.join_all();
+}
+
+void ThreadPool::Post(const task_type &task)
+{
+	{
+		boost::mutex::scoped_lock lock(m_mutex);
+		m_queue.push_back(task);
+		m_num_outstanding++;
+	}
+	m_work_available.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+	boost::exception_ptr e;
+
+	if(m_num_threads <= 1)
+	{
+		// No workers, so run the queue here.
+		while(!m_queue.empty())
+		{
+			task_type task = m_queue.front();
+			m_queue.pop_front();
+			RunTask(task);
+			m_num_outstanding--;
+		}
+	}
+
+	{
+		boost::mutex::scoped_lock lock(m_mutex);
+		while(m_num_outstanding > 0)
+		{
+			m_all_done.wait(lock);
+		}
+		e = m_first_exception;
+		m_first_exception = boost::exception_ptr();
+	}
+
+	if(e)
+	{
+		boost::rethrow_exception(e);
+	}
+}
+
+void ThreadPool::Run(const std::vector<task_type> &tasks)
+{
+	BOOST_FOREACH(const task_type &task, tasks)
+	{
+		Post(task);
+	}
+	Wait();
+}
+
+void ThreadPool::WorkerLoop()
+{
+	while(true)
+	{
+		task_type task;
+
+		{
+			boost::mutex::scoped_lock lock(m_mutex);
+			while(m_queue.empty() && !m_stopping)
+			{
+				m_work_available.wait(lock);
+			}
+			if(m_queue.empty())
+			{
+				// Stopping, and nothing left to do.
+				return;
+			}
+			task = m_queue.front();
+			m_queue.pop_front();
+		}
+
+		RunTask(task);
+
+		bool last;
+		{
+			boost::mutex::scoped_lock lock(m_mutex);
+			m_num_outstanding--;
+			last = (m_num_outstanding == 0);
+		}
+		if(last)
+		{
+			m_all_done.notify_all();
+		}
+	}
+}
+
+void ThreadPool::RunTask(const task_type &task)
+{
+	try
+	{
+		task();
+	}
+	catch(...)
+	{
+		boost::mutex::scoped_lock lock(m_mutex);
+		if(!m_first_exception)
+		{
+			m_first_exception = boost::current_exception();
+		}
+	}
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <deque>
+#include <vector>
+
+#include <boost/utility.hpp>
+#include <boost/function.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+/**
+ * A fixed set of worker threads which run posted tasks.
+ *
+ * With one thread, no workers are started and tasks are run in the posting thread by Wait().  That keeps
+ * single-threaded runs, e.g. when debugging, exactly as they were.
+ */
+class ThreadPool : boost::noncopyable
+{
+public:
+
+	/// A unit of work.
+	typedef boost::function<void ()> task_type;
+
+	/**
+	 * @param num_threads  Number of worker threads.  0 means one per hardware thread.
+	 */
+	explicit ThreadPool(unsigned int num_threads = 0);
+
+	/**
+	 * Waits for any outstanding tasks, then stops the workers.
+	 */
+	~ThreadPool();
+
+	/**
+	 * Queue @a task to be run by the next free worker.
+	 */
+	void Post(const task_type &task);
+
+	/**
+	 * Wait until every task posted so far has finished.  If any of them threw, the first exception is rethrown here.
+	 */
+	void Wait();
+
+	/**
+	 * Run all of @a tasks and wait for them to finish.
+	 */
+	void Run(const std::vector<task_type> &tasks);
+
+	/**
+	 * @return The number of threads tasks are run on.
+	 */
+	unsigned int NumThreads() const { return m_num_threads; };
+
+private:
+
+	/// The body of each worker thread.
+	void WorkerLoop();
+
+	/// Run @a task, capturing any exception it throws.
+	void RunTask(const task_type &task);
+
+	unsigned int m_num_threads;
+
+	boost::thread_group m_workers;
+
+	/// Protects everything below.
+	boost::mutex m_mutex;
+
+	/// Signalled when a task is queued, or the workers should stop.
+	boost::condition_variable m_work_available;
+
+	/// Signalled when the last outstanding task finishes.
+	boost::condition_variable m_all_done;
+
+	std::deque<task_type> m_queue;
+
+	/// Tasks which have been posted but haven't finished.
+	long m_num_outstanding;
+
+	bool m_stopping;
+
+	/// The first exception thrown by a task since the last Wait().
+	boost::exception_ptr m_first_exception;
+};
+
+#endif /* THREADPOOL_H_ */
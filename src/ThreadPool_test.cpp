@@ -0,0 +1,70 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <vector>
+
+#include <boost/bind.hpp>
+
+#include "ThreadPool.h"
+
+/// Each task sets its own slot, so no locking is needed.
+static void set_slot(std::vector<long> *slots, long i)
+{
+	(*slots)[i] = i;
+}
+
+static void throw_runtime_error()
+{
+	throw std::runtime_error("task failed");
+}
+
+TEST(ThreadPoolTest, RunsEveryTask)
+{
+	for(unsigned int num_threads = 1; num_threads <= 4; num_threads += 3)
+	{
+		ThreadPool pool(num_threads);
+		std::vector<long> slots(1000, -1);
+		std::vector<ThreadPool::task_type> tasks;
+
+		for(long i = 0; i < (long)slots.size(); ++i)
+		{
+			tasks.push_back(boost::bind(set_slot, &slots, i));
+		}
+		pool.Run(tasks);
+
+		for(long i = 0; i < (long)slots.size(); ++i)
+		{
+			ASSERT_EQ(i, slots[i]);
+		}
+	}
+}
+
+TEST(ThreadPoolTest, WaitRethrowsTaskException)
+{
+	ThreadPool pool(2);
+
+	pool.Post(throw_runtime_error);
+	ASSERT_THROW(pool.Wait(), std::runtime_error);
+
+	// The exception is only reported once.
+	ASSERT_NO_THROW(pool.Wait());
+}
@@ -19,6 +19,7 @@
 
 #include "TranslationUnit.h"
 
+#include <cstdio>
 #include <iostream>
 #include <fstream>
 #include <sys/types.h>
@@ -34,18 +35,19 @@
 
 #include "debug_utils/debug_utils.hpp"
 
+#include "JSON.h"
 #include "Location.h"
 #include "Function.h"
 
 #include "controlflowgraph/statements/If.h"
-#include "controlflowgraph/statements/FunctionCallUnresolved.h"
+#include "controlflowgraph/statements/FunctionCall.h"
 #include "controlflowgraph/statements/NoOp.h"
 #include "controlflowgraph/statements/Switch.h"
 
 #include "libexttools/ToolCompiler.h"
 #include "libexttools/toollib.h"
 
-#include "templates/FileTemplate.h"
+#include "templates/StreamingTemplate.h"
 
 #include "parsers/gcc_gimple_parser.h"
 
@@ -57,6 +59,7 @@ TranslationUnit::TranslationUnit(Program *parent_program, const std::string &fil
 {
 	m_parent_program = parent_program;
 	m_source_filename = file_path;
+	m_num_duplicate_functions = 0;
 }
 
 TranslationUnit::TranslationUnit(const TranslationUnit& orig)
@@ -191,28 +194,39 @@ const std::string str_template_function_cfg = std::string(""
 		"</div>\n");
 */
 
-const std::string str_template_function_cfg = std::string(""
-	"<div id=\"@IDENTIFIER_FUNCTION@\">\n"
-	"		<!-- Surround the function name with an anchor in an attempt at having reasonable <noscript> nav fallback. -->\n"
-	"		<p><a id=\"file1-@IDENTIFIER_FUNCTION@\">@IDENTIFIER_FUNCTION@()</a></p>\n"
-	"		<object class=\"svg-cfg\" type=\"image/svg+xml\" data=\"@IDENTIFIER_FUNCTION@.svg\"></object>\n"
-	"	</div>");
-
-const char f_str_template_nav_tree_function_entry[] =
-		"			<li data-nav-tree-node-type=\"function\">\n"
-		"				<a href=\"#@IDENTIFIER_FUNCTION@\">@IDENTIFIER_FUNCTION@()</a>\n"
-		"			</li>\n";
-
 const char f_str_template_nav_tree_file_entry[] =
-		"	<li id=\"@UNIQUE_FILE_ID@\" class=\"coflo-nav-tree-file\" data-nav-tree-node-type=\"source_file\">\n"
+		"	<li id=\"@UNIQUE_FILE_ID@\" class=\"coflo-nav-tree-file jstree-closed\" data-nav-tree-node-type=\"source_file\"\n"
+		"		data-manifest=\"@MANIFEST@\">\n"
 		"		<a href=\"#\">@FILENAME@</a>\n"
-		"		<ul>\n"
-		"			<!-- NAV_FUNCTION_ENTRY_START -->\n"
-		"			<!-- NAV_FUNCTION_ENTRY_END -->\n"
-		"		</ul>\n"
-		"	</li>";
+		"	</li>\n";
+
+// The template above, parsed once.
+static const StreamingTemplate f_nav_tree_file_entry(f_str_template_nav_tree_file_entry);
+
+/**
+ * @return The total number of call sites on the call graph edges [@a first, @a last) of one Function, as returned by
+ * CallGraph::GetCalleeEdges() or CallGraph::GetCallerEdges().
+ */
+static long count_call_sites(const CallGraph &call_graph, std::size_t first, std::size_t last, bool callers)
+{
+	long num_call_sites = 0;
+
+	for(std::size_t i = first; i < last; ++i)
+	{
+		CallGraph::edge_index_type e = callers ? call_graph.GetCallerEdge(i) : call_graph.GetCalleeEdge(i);
+		num_call_sites += call_graph.GetEdge(e).m_call_sites.size();
+	}
+
+	return num_call_sites;
+}
+
+std::string TranslationUnit::GetUniqueFileId() const
+{
+	std::string unique_file_id = std::string("file_") + m_source_filename.generic_string();
+	return regex_replace(unique_file_id, "[./-]", "_");
+}
 
-void TranslationUnit::Print(ToolDot *the_dot, const boost::filesystem::path &output_dir, FileTemplate & index_html_out)
+void TranslationUnit::PrintNavTreeEntry(std::ostream &index_html_out, std::vector< Function* > *report_functions)
 {
 	std::cout << "Translation Unit Filename: " << m_source_filename << std::endl;
 	std::cout << "Number of functions defined in this translation unit: " << m_function_defs.size() << std::endl;
@@ -222,55 +236,60 @@ void TranslationUnit::Print(ToolDot *the_dot, const boost::filesystem::path &out
 	BOOST_FOREACH(Function* fp, m_function_defs)
 	{
 		std::cout << "Function: " << fp->GetIdentifier() << std::endl;
+		report_functions->push_back(fp);
 	}
 	
-	// Create filenames for the index and primary css files.
-	std::string index_html_filename = (output_dir / "index.html").generic_string();
-
-	// Create an entry for this file in the navigation tree.
-	FileTemplate nav_tree_table_entry(f_str_template_nav_tree_file_entry);
-
-	// Create a unique ID for this file which can be referenced by the other entries in the nav tree.
-	std::string unique_file_id = std::string("file_") + m_source_filename.generic_string();
-	unique_file_id = regex_replace(unique_file_id, "[./-]", "_");
+	// Write the entry for this file in the navigation tree.  Its functions are listed in its manifest, which the
+	// report loads when the file is opened in the tree.
+	StreamingTemplate::values_type file_values;
+	file_values["UNIQUE_FILE_ID"] = GetUniqueFileId();
+	file_values["FILENAME"] = m_source_filename.filename().generic_string();
+	file_values["MANIFEST"] = GetManifestPath();
+	f_nav_tree_file_entry.Write(index_html_out, file_values);
+}
 
-	nav_tree_table_entry.regex_replace("@UNIQUE_FILE_ID@", unique_file_id);
-	nav_tree_table_entry.regex_replace("@FILENAME@", m_source_filename.filename().generic_string());
+bool TranslationUnit::PrintManifest(const boost::filesystem::path &output_dir) const
+{
+	const CallGraph &call_graph = m_parent_program->GetCallGraph();
+	std::string manifest_filename = (output_dir / GetManifestPath()).generic_string();
+	std::ofstream manifest(manifest_filename.c_str());
 
-	// Now insert it into the navigation tree.
-	index_html_out.regex_insert_before("<!-- NAV_END -->", nav_tree_table_entry.str());
+	manifest << "coflo_manifest_loaded({\n\t\"id\": " << json_quote(GetUniqueFileId())
+			<< ",\n\t\"file\": " << json_quote(m_source_filename.generic_string()) << ",\n\t\"functions\": [";
 
-	std::stringstream ss;
-	int i = 1;
+	bool first_function = true;
 	BOOST_FOREACH(Function* fp, m_function_defs)
 	{
-		ss.str("");
-		ss << i;
-		/*if(!fp->IsCalled())
+		CallGraph::function_index_type f = call_graph.GetFunctionIndex(fp);
+		std::size_t first, last;
+		long num_calls = 0, num_callers = 0;
+
+		if(f != CallGraph::NO_FUNCTION)
 		{
-			ss << " (possible entry point)";
-		}*/
-
-		// Generate the tab list item for this function.
-		FileTemplate nav_tree_table_entry_function(f_str_template_nav_tree_function_entry);
-		nav_tree_table_entry_function.regex_replace("@UNIQUE_FILE_ID@", unique_file_id);
-		nav_tree_table_entry_function.regex_replace("@IDENTIFIER_FUNCTION@", fp->GetIdentifier());
-		nav_tree_table_entry_function.regex_replace("@UNIQUE_FUNCTION_ID@", fp->GetIdentifier());
-		nav_tree_table_entry_function.regex_replace("@TABNUMBER@", ss.str());
-		index_html_out.regex_insert_before("<!-- NAV_FUNCTION_ENTRY_END -->", nav_tree_table_entry_function.str());
-
-		std::string cfg_image_filename;
-		cfg_image_filename = fp->GetIdentifier()+".svg";
-		fp->PrintControlFlowGraphBitmap(the_dot, output_dir / cfg_image_filename);
-
-		// Output the tab panel HTML for this function.
-		FileTemplate function_cfg(str_template_function_cfg);
-		function_cfg.regex_replace("@IDENTIFIER_FUNCTION@", fp->GetIdentifier());
-		function_cfg.regex_replace("TABNUMBER",	ss.str());
-		index_html_out.regex_insert_before("<!-- TAB_PANEL_LIST_END -->", function_cfg.str());
-
-		i++;
+			call_graph.GetCalleeEdges(f, &first, &last);
+			num_calls = count_call_sites(call_graph, first, last, false);
+			call_graph.GetCallerEdges(f, &first, &last);
+			num_callers = count_call_sites(call_graph, first, last, true);
+		}
+
+		manifest << (first_function ? "\n" : ",\n");
+		manifest << "\t\t{ \"name\": " << json_quote(fp->GetIdentifier())
+				<< ", \"calls\": " << num_calls
+				<< ", \"callers\": " << num_callers
+				<< ", \"svg\": " << json_quote(fp->GetIdentifier() + ".svg") << " }";
+		first_function = false;
+	}
+
+	manifest << "\n\t]\n});\n";
+	manifest.close();
+
+	if(manifest.fail())
+	{
+		std::cerr << "ERROR: Couldn't write manifest \"" << manifest_filename << "\"" << std::endl;
+		return false;
 	}
+
+	return true;
 }
 
 void TranslationUnit::CompileSourceFile(const std::string& file_path, const std::string &the_filter, ToolCompiler *compiler,
@@ -315,6 +334,26 @@ void TranslationUnit::BuildFunctionsFromThreeAddressFormStatementLists(const std
 
 		dlog_parse_gimple << "Processing FunctionInfo for function \"" << *(fi->m_identifier) << "\"..." << std::endl;
 
+		// Check if we've already got an identical definition of this function from another TranslationUnit.  This is
+		// usually a static inline function from a header which every TranslationUnit includes.  There's no point in
+		// keeping more than one copy, so we skip this one before anything's been built from it.
+		T_ID_TO_FUNCTION_PTR_MAP::const_iterator existing = function_map->find(*(fi->m_identifier));
+		if((existing != function_map->end())
+				&& (existing->second->GetFingerprint() == Function::ComputeFingerprint(*(fi->m_statement_list))))
+		{
+			dlog_parse_gimple << "Skipping duplicate definition of function \"" << *(fi->m_identifier) << "\"" << std::endl;
+
+			BOOST_FOREACH(StatementBase *sbp, *(fi->m_statement_list))
+			{
+				delete sbp;
+			}
+			delete fi->m_statement_list;
+			fi->m_statement_list = NULL;
+
+			++m_num_duplicate_functions;
+			continue;
+		}
+
 		// Create the function.
 		Function *f = new Function(this, *(fi->m_identifier));
 
@@ -324,8 +363,8 @@ void TranslationUnit::BuildFunctionsFromThreeAddressFormStatementLists(const std
 		// Add the new Function to the program-wide function map.
 		(*function_map)[*(fi->m_identifier)] = f;
 
-		// Create the control flow graph for this function.
-		f->CreateControlFlowGraph(*(fi->m_statement_list));
+		// Hand the function its statements.  Its control flow graph will be built from them when it's first needed.
+		f->SetStatementList(fi->m_statement_list);
 	}
 }
 
@@ -18,6 +18,7 @@
 #ifndef TRANSLATIONUNIT_H
 #define	TRANSLATIONUNIT_H
 
+#include <iosfwd>
 #include <string>
 
 #include <boost/filesystem.hpp>
@@ -28,10 +29,8 @@
 // Forward declarations.
 class Function;
 class FunctionCall;
-class ToolDot;
-typedef std::vector< FunctionCallUnresolved* > T_UNRESOLVED_FUNCTION_CALL_MAP;
+typedef std::vector< FunctionCall* > T_UNRESOLVED_FUNCTION_CALL_MAP;
 struct FunctionInfo;
-class FileTemplate;
 
 /**
  * Class representing a single translation unit.
@@ -78,7 +77,41 @@ public:
 	void Link(const std::map< std::string, Function* > &function_map,
 			T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP *unresolved_function_calls);
 
-	void Print(ToolDot *the_dot, const boost::filesystem::path &output_dir, FileTemplate & index_html_stream);
+	/**
+	 * Write this TranslationUnit's entry in the report's navigation tree to @a index_html_stream.  The entry just
+	 * names the file and its manifest.  The report's page loads the manifest, and from it the list of Functions, when
+	 * the file is opened in the tree.
+	 *
+	 * The control flow graphs aren't drawn here.  Program::Print() draws them all together, since that's by far the
+	 * slowest part of generating the report.
+	 *
+	 * @param index_html_stream  The report's index.html, positioned at the navigation tree's insertion point.
+	 * @param[out] report_functions  The Functions added to the report are appended to this.  The manifest refers to
+	 *        each one's graph as "<identifier>.svg".
+	 */
+	void PrintNavTreeEntry(std::ostream &index_html_stream, std::vector< Function* > *report_functions);
+
+	/**
+	 * Write this TranslationUnit's report manifest to GetManifestPath() under @a output_dir.  This is a script which
+	 * passes a JSON object listing the Functions defined here to the report page:
+	 * @code
+	 * coflo_manifest_loaded({ "id": "<unique file id>", "file": "<path>",
+	 *     "functions": [ { "name": "<identifier>", "calls": <n>, "callers": <n>, "svg": "<path>" }, ... ] });
+	 * @endcode
+	 * The page loads it with a <script> tag, which unlike XHR works when the report is opened from the local
+	 * filesystem.  "id" is the id of the file's nav tree entry.  "calls" is the number of call sites in the Function
+	 * which call Functions defined in the Program, and "callers" is the number of such call sites which call it.
+	 *
+	 * This only reads the Program, so the manifests of different TranslationUnits can be written in parallel.
+	 *
+	 * @return true if the manifest was written.
+	 */
+	bool PrintManifest(const boost::filesystem::path &output_dir) const;
+
+	/**
+	 * @return The path of this TranslationUnit's report manifest, relative to the report's directory.
+	 */
+	std::string GetManifestPath() const { return "manifests/" + GetUniqueFileId() + ".js"; };
 	
 	/**
 	 * Returns the file path.
@@ -92,6 +125,22 @@ public:
 	 */
 	long GetNumberOfFunctionDefinitions() const { return m_function_defs.size(); };
 
+	/**
+	 * Returns the Program which contains this TranslationUnit.
+	 */
+	Program* GetParentProgram() const { return m_parent_program; };
+
+	/**
+	 * Returns the Functions defined in this TranslationUnit.
+	 */
+	const std::vector< Function* >& GetFunctionDefinitions() const { return m_function_defs; };
+
+	/**
+	 * Returns the number of function definitions in this TranslationUnit which were skipped because an identical
+	 * definition had already been parsed from another TranslationUnit, e.g. a static inline function from a common header.
+	 */
+	long GetNumDuplicateFunctions() const { return m_num_duplicate_functions; };
+
 private:
 	
 	/**
@@ -106,6 +155,11 @@ private:
 	void BuildFunctionsFromThreeAddressFormStatementLists(const std::vector< FunctionInfo* > &function_info_list,
 			T_ID_TO_FUNCTION_PTR_MAP *function_map);
 
+	/**
+	 * @return An identifier for this file, unique within the report, made from its path.
+	 */
+	std::string GetUniqueFileId() const;
+
 	/// Pointer to the program which contains this TranslationUnit.
 	Program *m_parent_program;
 
@@ -114,6 +168,9 @@ private:
 
 	/// List of function definitions in this file.
 	std::vector< Function* > m_function_defs;
+
+	/// Number of function definitions in this file which duplicated one we already had.
+	long m_num_duplicate_functions;
 };
 
 #endif	/* TRANSLATIONUNIT_H */
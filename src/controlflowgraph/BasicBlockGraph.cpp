@@ -0,0 +1,335 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "BasicBlockGraph.h"
+
+#include <algorithm>
+
+#include <boost/foreach.hpp>
+#include <boost/tuple/tuple.hpp>
+
+#include "edges/edge_types.h"
+#include "statements/FunctionCall.h"
+
+/**
+ * @return true if @a e stays within a single Function, i.e. it isn't a FunctionCall or Return edge.
+ */
+static bool is_intraprocedural(const CFGEdgeTypeBase *e)
+{
+	return (dynamic_cast<const CFGEdgeTypeFunctionCall*>(e) == NULL)
+			&& (dynamic_cast<const CFGEdgeTypeReturn*>(e) == NULL);
+}
+
+const BasicBlockGraph::block_index_type BasicBlockGraph::NO_BLOCK;
+
+BasicBlockGraph::BasicBlockGraph()
+{
+	m_num_block_edges = 0;
+}
+
+BasicBlockGraph::~BasicBlockGraph()
+{
+}
+
+void BasicBlockGraph::Build(const ControlFlowGraph &cfg, ControlFlowGraph::vertex_descriptor entry)
+{
+	std::size_t num_indices = cfg.GetVertexIndexUpperBound();
+
+	m_blocks.clear();
+	m_num_block_edges = 0;
+	m_block_of.assign(num_indices, NO_BLOCK);
+	m_position_in_block.assign(num_indices, 0);
+
+	// Count the intraprocedural in and out edges of each vertex, remembering the last of each.  For the vertices
+	// we care about, there will only be one.
+	std::vector<long> in_degree(num_indices, 0);
+	std::vector<long> out_degree(num_indices, 0);
+	std::vector<ControlFlowGraph::edge_descriptor> in_edge(num_indices, ControlFlowGraph::edge_descriptor(NULL));
+	std::vector<ControlFlowGraph::edge_descriptor> out_edge(num_indices, ControlFlowGraph::edge_descriptor(NULL));
+
+	ControlFlowGraph::vertex_iterator vit, vend;
+	boost::tie(vit, vend) = vertices(cfg);
+	for(; vit != vend; ++vit)
+	{
+		StatementBase::out_edge_iterator eit, eend;
+		(*vit)->OutEdges(&eit, &eend);
+		for(; eit != eend; ++eit)
+		{
+			if(!is_intraprocedural(*eit))
+			{
+				continue;
+			}
+			out_degree[(*vit)->GetIndex()]++;
+			out_edge[(*vit)->GetIndex()] = *eit;
+			in_degree[(*eit)->Target()->GetIndex()]++;
+			in_edge[(*eit)->Target()->GetIndex()] = *eit;
+		}
+	}
+
+	// A vertex starts a new block unless its only predecessor falls through to it and to nothing else.
+	std::vector<bool> is_leader(num_indices, false);
+	std::vector<ControlFlowGraph::vertex_descriptor> leaders;
+	is_leader[entry->GetIndex()] = true;
+	leaders.push_back(entry);
+	boost::tie(vit, vend) = vertices(cfg);
+	for(; vit != vend; ++vit)
+	{
+		std::size_t i = (*vit)->GetIndex();
+
+		if(*vit == entry)
+		{
+			continue;
+		}
+
+		if((in_degree[i] != 1)
+				|| !in_edge[i]->IsType<CFGEdgeTypeFallthrough>()
+				|| (in_edge[i]->Source() == *vit)
+				|| (out_degree[in_edge[i]->Source()->GetIndex()] != 1))
+		{
+			is_leader[i] = true;
+			leaders.push_back(*vit);
+		}
+	}
+
+	BOOST_FOREACH(ControlFlowGraph::vertex_descriptor leader, leaders)
+	{
+		GrowBlock(leader, out_degree, out_edge, is_leader);
+	}
+
+	// Anything left over is on a cycle of Fallthrough edges with no way in.  Start a block at the first such
+	// vertex we come across, which will pick up the rest of the cycle.
+	boost::tie(vit, vend) = vertices(cfg);
+	for(; vit != vend; ++vit)
+	{
+		if(m_block_of[(*vit)->GetIndex()] == NO_BLOCK)
+		{
+			GrowBlock(*vit, out_degree, out_edge, is_leader);
+		}
+	}
+
+	// Link the blocks.  Every intraprocedural edge which isn't inside a block leaves the last statement of one block
+	// and enters the leader of another.
+	for(block_index_type b = 0; b < static_cast<block_index_type>(m_blocks.size()); ++b)
+	{
+		StatementBase::out_edge_iterator eit, eend;
+		m_blocks[b].GetLastStatement()->OutEdges(&eit, &eend);
+		for(; eit != eend; ++eit)
+		{
+			if(!is_intraprocedural(*eit))
+			{
+				continue;
+			}
+
+			block_index_type target_block = m_block_of[(*eit)->Target()->GetIndex()];
+			m_blocks[b].m_succs.push_back(BlockEdge(target_block, *eit));
+			m_blocks[target_block].m_preds.push_back(BlockEdge(b, *eit));
+			m_num_block_edges++;
+		}
+	}
+}
+
+void BasicBlockGraph::ReplaceStatement(ControlFlowGraph::vertex_descriptor old_statement,
+		ControlFlowGraph::vertex_descriptor new_statement)
+{
+	block_index_type b = GetBlockIndex(old_statement);
+
+	if(b == NO_BLOCK)
+	{
+		return;
+	}
+
+	std::size_t position = m_position_in_block[old_statement->GetIndex()];
+	BasicBlock &block = m_blocks[b];
+
+	block.m_statements[position] = new_statement;
+	m_block_of[old_statement->GetIndex()] = NO_BLOCK;
+
+	if(new_statement->GetIndex() >= m_block_of.size())
+	{
+		m_block_of.resize(new_statement->GetIndex()+1, NO_BLOCK);
+		m_position_in_block.resize(new_statement->GetIndex()+1, 0);
+	}
+	m_block_of[new_statement->GetIndex()] = b;
+	m_position_in_block[new_statement->GetIndex()] = position;
+
+	// Keep the FunctionCall index in sync.
+	std::vector<std::size_t>::iterator it = std::lower_bound(block.m_function_calls.begin(),
+			block.m_function_calls.end(), position);
+	bool was_call = (it != block.m_function_calls.end()) && (*it == position);
+	bool is_call = (dynamic_cast<FunctionCall*>(new_statement) != NULL);
+	if(was_call && !is_call)
+	{
+		block.m_function_calls.erase(it);
+	}
+	else if(!was_call && is_call)
+	{
+		block.m_function_calls.insert(it, position);
+	}
+}
+
+BasicBlockGraph::block_index_type BasicBlockGraph::GetBlockIndex(ControlFlowGraph::vertex_descriptor v) const
+{
+	if(v->GetIndex() >= m_block_of.size())
+	{
+		return NO_BLOCK;
+	}
+
+	return m_block_of[v->GetIndex()];
+}
+
+std::size_t BasicBlockGraph::GetPositionInBlock(ControlFlowGraph::vertex_descriptor v) const
+{
+	return m_position_in_block[v->GetIndex()];
+}
+
+void BasicBlockGraph::ReachableBlocks(block_index_type b, std::vector<bool> *reachable) const
+{
+	std::vector<block_index_type> stack;
+
+	reachable->assign(m_blocks.size(), false);
+
+	stack.push_back(b);
+	while(!stack.empty())
+	{
+		block_index_type u = stack.back();
+		stack.pop_back();
+
+		const std::vector<BlockEdge> &succs = m_blocks[u].m_succs;
+		for(std::size_t i = 0; i < succs.size(); ++i)
+		{
+			if(succs[i].m_edge->IsImpossible() || (*reachable)[succs[i].m_other_block])
+			{
+				continue;
+			}
+
+			(*reachable)[succs[i].m_other_block] = true;
+			stack.push_back(succs[i].m_other_block);
+		}
+	}
+}
+
+bool BasicBlockGraph::IsReachable(ControlFlowGraph::vertex_descriptor from, ControlFlowGraph::vertex_descriptor to) const
+{
+	block_index_type from_block = GetBlockIndex(from);
+	block_index_type to_block = GetBlockIndex(to);
+
+	if((from_block == NO_BLOCK) || (to_block == NO_BLOCK))
+	{
+		return false;
+	}
+
+	if((from_block == to_block) && (GetPositionInBlock(from) < GetPositionInBlock(to)))
+	{
+		// Straight-line code within the block.
+		return true;
+	}
+
+	std::vector<bool> reachable;
+	ReachableBlocks(from_block, &reachable);
+
+	return reachable[to_block];
+}
+
+void BasicBlockGraph::ReachableFunctionCalls(ControlFlowGraph::vertex_descriptor from,
+		std::vector<ControlFlowGraph::vertex_descriptor> *calls) const
+{
+	block_index_type from_block = GetBlockIndex(from);
+
+	if(from_block == NO_BLOCK)
+	{
+		return;
+	}
+
+	// First the calls following @a from in its own block.
+	const BasicBlock &block = m_blocks[from_block];
+	std::size_t from_position = GetPositionInBlock(from);
+	std::vector<std::size_t>::const_iterator first_after = std::upper_bound(block.m_function_calls.begin(),
+			block.m_function_calls.end(), from_position);
+	for(std::vector<std::size_t>::const_iterator it = first_after; it != block.m_function_calls.end(); ++it)
+	{
+		calls->push_back(block.m_statements[*it]);
+	}
+
+	// Then the calls in all the blocks reachable from there.
+	std::vector<bool> reachable;
+	ReachableBlocks(from_block, &reachable);
+	for(block_index_type b = 0; b < static_cast<block_index_type>(m_blocks.size()); ++b)
+	{
+		if(!reachable[b])
+		{
+			continue;
+		}
+
+		const BasicBlock &rblock = m_blocks[b];
+		std::vector<std::size_t>::const_iterator end = rblock.m_function_calls.end();
+		if(b == from_block)
+		{
+			// We've looped back around.  Only the calls up to and including @a from are new.
+			end = first_after;
+		}
+		for(std::vector<std::size_t>::const_iterator it = rblock.m_function_calls.begin(); it != end; ++it)
+		{
+			calls->push_back(rblock.m_statements[*it]);
+		}
+	}
+}
+
+void BasicBlockGraph::GrowBlock(ControlFlowGraph::vertex_descriptor leader, const std::vector<long> &out_degree,
+		const std::vector<ControlFlowGraph::edge_descriptor> &out_edge, const std::vector<bool> &is_leader)
+{
+	block_index_type b = m_blocks.size();
+	m_blocks.push_back(BasicBlock());
+
+	ControlFlowGraph::vertex_descriptor v = leader;
+	AppendStatement(b, v);
+	while((out_degree[v->GetIndex()] == 1) && out_edge[v->GetIndex()]->IsType<CFGEdgeTypeFallthrough>())
+	{
+		ControlFlowGraph::vertex_descriptor next = out_edge[v->GetIndex()]->Target();
+
+		if(is_leader[next->GetIndex()] || (m_block_of[next->GetIndex()] != NO_BLOCK))
+		{
+			// Either the next vertex starts its own block, or we've looped back around.
+			break;
+		}
+
+		v = next;
+		AppendStatement(b, v);
+	}
+}
+
+void BasicBlockGraph::AppendStatement(block_index_type b, ControlFlowGraph::vertex_descriptor v)
+{
+	if(v->GetIndex() >= m_block_of.size())
+	{
+		m_block_of.resize(v->GetIndex()+1, NO_BLOCK);
+		m_position_in_block.resize(v->GetIndex()+1, 0);
+	}
+
+	BasicBlock &block = m_blocks[b];
+
+	m_block_of[v->GetIndex()] = b;
+	m_position_in_block[v->GetIndex()] = block.m_statements.size();
+
+	if(dynamic_cast<FunctionCall*>(v) != NULL)
+	{
+		block.m_function_calls.push_back(block.m_statements.size());
+	}
+
+	block.m_statements.push_back(v);
+}
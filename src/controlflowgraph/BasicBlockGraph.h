@@ -0,0 +1,179 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#ifndef BASICBLOCKGRAPH_H_
+#define BASICBLOCKGRAPH_H_
+
+#include <vector>
+
+#include "ControlFlowGraph.h"
+
+/**
+ * Basic block view of a Function's ControlFlowGraph.
+ *
+ * Every maximal chain of statements linked by Fallthrough edges, where each statement but the first has exactly one
+ * predecessor and each statement but the last has exactly one successor, is collapsed into a single block.  Only
+ * intraprocedural edges are considered when forming the blocks, so FunctionCall statements don't end their blocks.
+ * Instead, each block keeps an index of the positions of its FunctionCall statements.
+ *
+ * The block graph doesn't own or modify the underlying ControlFlowGraph.  It's built once the ControlFlowGraph is in
+ * its final form, and traversals which don't need to look at every statement can then run over far fewer vertices
+ * and edges.
+ */
+class BasicBlockGraph
+{
+public:
+
+	/// Index of a block in the graph.
+	typedef long block_index_type;
+
+	/// Block index value meaning "no block".
+	static const block_index_type NO_BLOCK = -1;
+
+	/**
+	 * An edge between two blocks.  This is always the single intraprocedural out edge of the last statement of
+	 * the source block which leads to the first statement of the target block.
+	 */
+	struct BlockEdge
+	{
+		BlockEdge(block_index_type other_block, ControlFlowGraph::edge_descriptor edge)
+		{
+			m_other_block = other_block;
+			m_edge = edge;
+		};
+
+		/// The block at the other end of the edge.
+		block_index_type m_other_block;
+
+		/// The ControlFlowGraph edge this block edge corresponds to.
+		ControlFlowGraph::edge_descriptor m_edge;
+	};
+
+	/**
+	 * A basic block.
+	 */
+	struct BasicBlock
+	{
+		/// The statements of the block, in program order.
+		std::vector<ControlFlowGraph::vertex_descriptor> m_statements;
+
+		/// The positions in m_statements of the block's FunctionCall statements.
+		std::vector<std::size_t> m_function_calls;
+
+		/// @name In and out edges of the block.
+		//@{
+		std::vector<BlockEdge> m_preds;
+		std::vector<BlockEdge> m_succs;
+		//@}
+
+		ControlFlowGraph::vertex_descriptor GetLeader() const { return m_statements.front(); };
+		ControlFlowGraph::vertex_descriptor GetLastStatement() const { return m_statements.back(); };
+	};
+
+	BasicBlockGraph();
+	~BasicBlockGraph();
+
+	/**
+	 * Build the basic blocks of @a cfg, discarding any existing blocks.
+	 *
+	 * @param cfg   The ControlFlowGraph to build the blocks of.
+	 * @param entry The Entry vertex of @a cfg, which always starts the first block.
+	 */
+	void Build(const ControlFlowGraph &cfg, ControlFlowGraph::vertex_descriptor entry);
+
+	/**
+	 * Replace statement @a old_statement with @a new_statement in its block.  This is for when a vertex of the
+	 * underlying ControlFlowGraph is replaced with ControlFlowGraph::ReplaceVertex(), which keeps the edges but gives
+	 * the new vertex a new index.
+	 */
+	void ReplaceStatement(ControlFlowGraph::vertex_descriptor old_statement, ControlFlowGraph::vertex_descriptor new_statement);
+
+	/// @name Block accessors.
+	//@{
+	std::size_t NumBlocks() const { return m_blocks.size(); };
+	const BasicBlock& GetBlock(block_index_type b) const { return m_blocks[b]; };
+	block_index_type GetEntryBlock() const { return m_blocks.empty() ? NO_BLOCK : 0; };
+
+	/**
+	 * @return The total number of edges between blocks.
+	 */
+	std::size_t NumBlockEdges() const { return m_num_block_edges; };
+	//@}
+
+	/**
+	 * @return The index of the block containing @a v, or NO_BLOCK if @a v isn't in any block.
+	 */
+	block_index_type GetBlockIndex(ControlFlowGraph::vertex_descriptor v) const;
+
+	/**
+	 * @return The position of @a v within its block.  @a v must be in a block.
+	 */
+	std::size_t GetPositionInBlock(ControlFlowGraph::vertex_descriptor v) const;
+
+	/**
+	 * Find all blocks reachable from block @a b, following any block edges which aren't Impossible.
+	 * Block @a b itself is only marked reachable if it's on a cycle.
+	 *
+	 * @param b  The block to start at.
+	 * @param[out] reachable  Set to a vector of NumBlocks() flags, true for each reachable block.
+	 */
+	void ReachableBlocks(block_index_type b, std::vector<bool> *reachable) const;
+
+	/**
+	 * Determine whether statement @a to can be executed after statement @a from in the same invocation of the
+	 * Function, ignoring Impossible edges.
+	 *
+	 * @return true if there's a path from @a from to @a to of at least one edge.
+	 */
+	bool IsReachable(ControlFlowGraph::vertex_descriptor from, ControlFlowGraph::vertex_descriptor to) const;
+
+	/**
+	 * Collect the FunctionCall statements which can be executed after statement @a from in the same invocation of
+	 * the Function, ignoring Impossible edges.
+	 *
+	 * @param from  The statement to start at.
+	 * @param[out] calls  The FunctionCall statements found are appended to this list, in block order.
+	 */
+	void ReachableFunctionCalls(ControlFlowGraph::vertex_descriptor from,
+			std::vector<ControlFlowGraph::vertex_descriptor> *calls) const;
+
+private:
+
+	/**
+	 * Start a new block at @a leader and add the statements which follow it, up to the next leader.
+	 */
+	void GrowBlock(ControlFlowGraph::vertex_descriptor leader, const std::vector<long> &out_degree,
+			const std::vector<ControlFlowGraph::edge_descriptor> &out_edge, const std::vector<bool> &is_leader);
+
+	/// Add statement @a v to the end of block @a b.
+	void AppendStatement(block_index_type b, ControlFlowGraph::vertex_descriptor v);
+
+	/// The blocks.  Block 0 is the one containing the Entry vertex.
+	std::vector<BasicBlock> m_blocks;
+
+	/// The block of each statement, indexed by Vertex::GetIndex().
+	std::vector<block_index_type> m_block_of;
+
+	/// The position of each statement within its block, indexed by Vertex::GetIndex().
+	std::vector<std::size_t> m_position_in_block;
+
+	std::size_t m_num_block_edges;
+};
+
+#endif /* BASICBLOCKGRAPH_H_ */
@@ -17,7 +17,7 @@
 
 #include "CallStackFrameBase.h"
 
-CallStackFrameBase::CallStackFrameBase(FunctionCallResolved *function_call_which_pushed_this_frame,
+CallStackFrameBase::CallStackFrameBase(FunctionCall *function_call_which_pushed_this_frame,
 		ControlFlowGraph *cfg)
 {
 	m_function_call_which_pushed_this_frame = function_call_which_pushed_this_frame;
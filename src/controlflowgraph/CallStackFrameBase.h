@@ -23,7 +23,7 @@
 #include "SparsePropertyMap.h"
 #include "ControlFlowGraph.h"
 
-class FunctionCallResolved;
+class FunctionCall;
 
 /**
  * Base class for CallStackBase stack frames.
@@ -34,14 +34,14 @@ class CallStackFrameBase
 public:
 	typedef SparsePropertyMap< ControlFlowGraph::vertex_descriptor, boost::default_color_type, boost::white_color > T_COLOR_MAP;
 
-	explicit CallStackFrameBase(FunctionCallResolved *function_call_which_pushed_this_frame,
+	explicit CallStackFrameBase(FunctionCall *function_call_which_pushed_this_frame,
 			ControlFlowGraph *cfg);
 	virtual ~CallStackFrameBase();
 
 	/// @name Member functions for accessing different parts of this stack frame.
 	///@{
 
-	FunctionCallResolved* GetPushingCall() { return m_function_call_which_pushed_this_frame; };
+	FunctionCall* GetPushingCall() { return m_function_call_which_pushed_this_frame; };
 	ControlFlowGraph* GetCurrentControlFlowGraph() { return m_calling_cfg; };
 	T_COLOR_MAP* GetColorMap() { return m_color_map; };
 
@@ -52,8 +52,8 @@ private:
 	/// @name Calling context.
 	/// All stack frames need at least this information so that the return edges can be determined.
 	///@{
-	/// The FunctionCallResolved vertex which resulted in this frame being pushed onto the stack.
-	FunctionCallResolved *m_function_call_which_pushed_this_frame;
+	/// The FunctionCall vertex which resulted in this frame being pushed onto the stack.
+	FunctionCall *m_function_call_which_pushed_this_frame;
 	/// The ControlFlowGraph from which the caller pushed this frame.
 	ControlFlowGraph *m_calling_cfg;
 	/// The color map in use at the time the function call was made.
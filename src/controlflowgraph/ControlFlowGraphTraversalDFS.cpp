@@ -233,11 +233,11 @@ void ControlFlowGraphTraversalDFS::Traverse(ControlFlowGraph::vertex_descriptor
 
 #if 0
 				StatementBase* sbp = u;
-				//// If this is a FunctionCallResolved node, push a new stack frame.
-				if(sbp->IsType<FunctionCallResolved>())
+				//// If this is a resolved FunctionCall node, push a new stack frame.
+				if(sbp->IsType<FunctionCall>() && dynamic_cast<FunctionCall*>(sbp)->IsResolved())
 				{
 					std::cout << "PUSH-fcr" << std::endl;
-					m_call_stack->PushCallStack(new CallStackFrameBase(dynamic_cast<FunctionCallResolved*>(sbp),
+					m_call_stack->PushCallStack(new CallStackFrameBase(dynamic_cast<FunctionCall*>(sbp),
 							));
 				}
 #endif
@@ -345,7 +345,7 @@ bool ControlFlowGraphTraversalDFS::SkipEdge(ControlFlowGraph::edge_descriptor e)
 	}
 
 	// Handle recursion.
-	// We deal with recursion by deciding here which path to take out of a FunctionCallResolved vertex.
+	// We deal with recursion by deciding here which path to take out of a resolved FunctionCall vertex.
 	// Note that this is currently the only vertex type which can result in recursion.
 	if ((fcb != NULL) && true/*(m_last_discovered_vertex_is_recursive == false)*/)
 	{
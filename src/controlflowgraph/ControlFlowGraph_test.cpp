@@ -19,14 +19,32 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <sstream>
+
 #include <boost/graph/graphviz.hpp>
 
 #include "GraphAdapter.h"
 #include "ControlFlowGraph.h"
 #include "statements/Goto.h"
 #include "statements/Label.h"
+#include "statements/FunctionCall.h"
+#include "statements/LabelMap.h"
+#include "statements/If.h"
 #include "edges/CFGEdgeTypeGoto.h"
 #include "edges/CFGEdgeTypeFallthrough.h"
+#include "algorithms/dataflow.h"
+#include "algorithms/cfg_algs.h"
+#include "algorithms/layered_layout.h"
+#include "algorithms/shortest_witness_path.h"
+#include "BasicBlockGraph.h"
+#include "ReachabilitySkeleton.h"
+#include "DominatorTree.h"
+#include "LoopNestingForest.h"
+#include "../Function.h"
+#include "../TranslationUnit.h"
 
 
 int GetMeToo() {return 5; };
@@ -37,16 +55,86 @@ int GetMeToo() {return 5; };
 class ControlFlowGraphTest : public ::testing::Test
 {
 protected:
-	ControlFlowGraphTest() {};
+	ControlFlowGraphTest() : m_tu(NULL, "test.c") {};
 	virtual ~ControlFlowGraphTest() {};
 
 	virtual void SetUp() {};
-	virtual void TearDown() {};
+	virtual void TearDown()
+	{
+		for(std::size_t i = 0; i < m_functions.size(); ++i)
+		{
+			delete m_functions[i];
+		}
+		for(std::size_t i = 0; i < m_statement_lists.size(); ++i)
+		{
+			for(std::size_t j = 0; j < m_statement_lists[i]->size(); ++j)
+			{
+				delete (*m_statement_lists[i])[j];
+			}
+			delete m_statement_lists[i];
+		}
+	};
 
 	ControlFlowGraph* CreateSimplestCFG();
 
+	/// Add a Function called @a identifier, with an empty statement list.
+	Function* AddFunction(const std::string &identifier)
+	{
+		m_functions.push_back(new Function(&m_tu, identifier));
+		m_statement_lists.push_back(new std::vector<StatementBase*>);
+		m_function_map[identifier] = m_functions.back();
+		return m_functions.back();
+	};
+
+	/// Add @a sbp to the end of @a f's statement list.
+	StatementBase* AddStatement(Function *f, StatementBase *sbp)
+	{
+		m_statement_lists[std::find(m_functions.begin(), m_functions.end(), f) - m_functions.begin()]->push_back(sbp);
+		return sbp;
+	};
+
+	/// Build and link the control flow graphs of all the Functions added, as Program does once they've been parsed.
+	/// Statements removed from the graphs as redundant have already been deleted, so they're dropped from the statement lists.
+	void BuildAndLinkFunctions()
+	{
+		for(std::size_t i = 0; i < m_functions.size(); ++i)
+		{
+			m_functions[i]->SetStatementList(m_statement_lists[i]);
+			m_functions[i]->BuildControlFlowGraph();
+
+			std::set<StatementBase*> remaining;
+			ControlFlowGraph::vertex_iterator vit, vend;
+			m_functions[i]->GetCFGPointer()->Vertices(&vit, &vend);
+			remaining.insert(vit, vend);
+
+			std::vector<StatementBase*> *statements = m_statement_lists[i];
+			std::vector<StatementBase*>::iterator last = statements->begin();
+			for(std::size_t j = 0; j < statements->size(); ++j)
+			{
+				if(remaining.count((*statements)[j]) != 0)
+				{
+					*last = (*statements)[j];
+					++last;
+				}
+			}
+			statements->erase(last, statements->end());
+		}
+		for(std::size_t i = 0; i < m_functions.size(); ++i)
+		{
+			m_functions[i]->Link(m_function_map, NULL);
+		}
+	};
+
 	ControlFlowGraph *m_test_graph;
 	StatementBase *m_test_vert1, *m_test_vert2;
+
+	/// @name The Functions made by AddFunction(), and their statement lists.
+	//@{
+	TranslationUnit m_tu;
+	std::vector<Function*> m_functions;
+	std::vector< std::vector<StatementBase*>* > m_statement_lists;
+	std::map<std::string, Function*> m_function_map;
+	//@}
 };
 
 
@@ -224,3 +312,801 @@ TEST_F(ControlFlowGraphTest, SimpleCFG_graphviz_out)
 
 	delete g;
 }
+
+/**
+ * Simple gen/kill dataflow problem for testing the DataflowSolver.
+ * Vertex m_gen0 generates fact 0, and m_gen1_kill0 generates fact 1 and kills fact 0.
+ */
+class TestGenKillProblem : public DataflowProblem
+{
+public:
+	TestGenKillProblem(StatementBase *gen0, StatementBase *gen1_kill0, bool forward, bool meet_is_union)
+	{
+		m_gen0 = gen0;
+		m_gen1_kill0 = gen1_kill0;
+		m_forward = forward;
+		m_meet_is_union = meet_is_union;
+	};
+
+	virtual std::size_t GetNumFacts() const { return 2; };
+	virtual bool IsForward() const { return m_forward; };
+	virtual bool IsMeetUnion() const { return m_meet_is_union; };
+
+	virtual void Transfer(ControlFlowGraph::vertex_descriptor v, const bitset_type &in, bitset_type *out) const
+	{
+		*out = in;
+		if(v == m_gen0)
+		{
+			out->set(0);
+		}
+		else if(v == m_gen1_kill0)
+		{
+			out->set(1);
+			out->reset(0);
+		}
+	};
+
+	StatementBase *m_gen0;
+	StatementBase *m_gen1_kill0;
+	bool m_forward;
+	bool m_meet_is_union;
+};
+
+TEST_F(ControlFlowGraphTest, DataflowForwardLoop)
+{
+	// Entry -> s1 -> s2 -> Exit, with a back edge s2 -> s1.
+	ControlFlowGraph g;
+	Entry entry((Location()));
+	NoOp s1((Location()));
+	NoOp s2((Location()));
+	Exit exit_vertex((Location()));
+
+	g.AddVertex(&entry);
+	g.AddVertex(&s1);
+	g.AddVertex(&s2);
+	g.AddVertex(&exit_vertex);
+
+	CFGEdgeTypeFallthrough e1, e2, e3;
+	CFGEdgeTypeGoto back_edge;
+	g.AddEdge(&entry, &s1, &e1);
+	g.AddEdge(&s1, &s2, &e2);
+	g.AddEdge(&s2, &exit_vertex, &e3);
+	g.AddEdge(&s2, &s1, &back_edge);
+
+	// A forward "may" problem.
+	TestGenKillProblem may_problem(&s1, &s2, true, true);
+	DataflowSolver may_solver(may_problem);
+	may_solver.Solve(g, &entry, &exit_vertex);
+
+	ASSERT_TRUE(may_solver.IsInSolution(&exit_vertex));
+	// Fact 1 reaches s1 around the loop.
+	EXPECT_FALSE(may_solver.GetIn(&s1).test(0));
+	EXPECT_TRUE(may_solver.GetIn(&s1).test(1));
+	EXPECT_TRUE(may_solver.GetIn(&s2).test(0));
+	EXPECT_TRUE(may_solver.GetIn(&s2).test(1));
+	EXPECT_FALSE(may_solver.GetIn(&exit_vertex).test(0));
+	EXPECT_TRUE(may_solver.GetIn(&exit_vertex).test(1));
+
+	// The same problem as a "must" problem.  Fact 1 doesn't hold on the first trip into s1.
+	TestGenKillProblem must_problem(&s1, &s2, true, false);
+	DataflowSolver must_solver(must_problem);
+	must_solver.Solve(g, &entry, &exit_vertex);
+
+	EXPECT_FALSE(must_solver.GetIn(&s1).test(1));
+	EXPECT_TRUE(must_solver.GetIn(&s2).test(0));
+	EXPECT_FALSE(must_solver.GetIn(&s2).test(1));
+	EXPECT_TRUE(must_solver.GetOut(&s2).test(1));
+
+	// Clean up the edges and vertices, which are all on the stack.
+	g.RemoveEdge(&back_edge);
+	g.RemoveEdge(&e3);
+	g.RemoveEdge(&e2);
+	g.RemoveEdge(&e1);
+}
+
+TEST_F(ControlFlowGraphTest, DataflowBackward)
+{
+	// Entry -> s1 -> s2 -> Exit.
+	ControlFlowGraph g;
+	Entry entry((Location()));
+	NoOp s1((Location()));
+	NoOp s2((Location()));
+	Exit exit_vertex((Location()));
+
+	g.AddVertex(&entry);
+	g.AddVertex(&s1);
+	g.AddVertex(&s2);
+	g.AddVertex(&exit_vertex);
+
+	CFGEdgeTypeFallthrough e1, e2, e3;
+	g.AddEdge(&entry, &s1, &e1);
+	g.AddEdge(&s1, &s2, &e2);
+	g.AddEdge(&s2, &exit_vertex, &e3);
+
+	// Backwards, s2 is executed first, so fact 1 holds before s2 and is still there before s1,
+	// which then adds fact 0.
+	TestGenKillProblem problem(&s1, &s2, false, true);
+	DataflowSolver solver(problem);
+	solver.Solve(g, &entry, &exit_vertex);
+
+	EXPECT_TRUE(solver.GetOut(&exit_vertex).none());
+	EXPECT_TRUE(solver.GetIn(&s2).test(1));
+	EXPECT_FALSE(solver.GetIn(&s2).test(0));
+	EXPECT_TRUE(solver.GetIn(&s1).test(0));
+	EXPECT_TRUE(solver.GetIn(&entry).test(1));
+
+	g.RemoveEdge(&e3);
+	g.RemoveEdge(&e2);
+	g.RemoveEdge(&e1);
+}
+
+TEST_F(ControlFlowGraphTest, BasicBlocks)
+{
+	// Entry -> s1 -> call -> s3 -> Exit, with a back edge s3 -> s1.
+	ControlFlowGraph g;
+	Entry entry((Location()));
+	NoOp s1((Location()));
+	FunctionCall call("f", Location(), "");
+	NoOp s3((Location()));
+	Exit exit_vertex((Location()));
+
+	g.AddVertex(&entry);
+	g.AddVertex(&s1);
+	g.AddVertex(&call);
+	g.AddVertex(&s3);
+	g.AddVertex(&exit_vertex);
+
+	CFGEdgeTypeFallthrough e1, e2, e3, e4;
+	CFGEdgeTypeGoto back_edge;
+	g.AddEdge(&entry, &s1, &e1);
+	g.AddEdge(&s1, &call, &e2);
+	g.AddEdge(&call, &s3, &e3);
+	g.AddEdge(&s3, &exit_vertex, &e4);
+	g.AddEdge(&s3, &s1, &back_edge);
+
+	BasicBlockGraph bbg;
+	bbg.Build(g, &entry);
+
+	// s1, the call and s3 make up one block.
+	ASSERT_EQ(bbg.NumBlocks(), 3);
+	EXPECT_EQ(bbg.NumBlockEdges(), 3);
+	EXPECT_EQ(bbg.GetBlockIndex(&entry), bbg.GetEntryBlock());
+	BasicBlockGraph::block_index_type loop_block = bbg.GetBlockIndex(&s1);
+	EXPECT_EQ(bbg.GetBlockIndex(&call), loop_block);
+	EXPECT_EQ(bbg.GetBlockIndex(&s3), loop_block);
+	EXPECT_NE(bbg.GetBlockIndex(&exit_vertex), loop_block);
+	EXPECT_EQ(bbg.GetBlock(loop_block).m_statements.size(), 3);
+	ASSERT_EQ(bbg.GetBlock(loop_block).m_function_calls.size(), 1);
+	EXPECT_EQ(bbg.GetBlock(loop_block).m_function_calls[0], 1);
+
+	EXPECT_TRUE(bbg.IsReachable(&s1, &s3));
+	EXPECT_TRUE(bbg.IsReachable(&s3, &s1));
+	EXPECT_TRUE(bbg.IsReachable(&entry, &exit_vertex));
+	EXPECT_FALSE(bbg.IsReachable(&exit_vertex, &s1));
+	EXPECT_FALSE(bbg.IsReachable(&s1, &entry));
+
+	// The call is reachable from s3 around the loop.
+	std::vector<ControlFlowGraph::vertex_descriptor> calls;
+	bbg.ReachableFunctionCalls(&s3, &calls);
+	ASSERT_EQ(calls.size(), 1);
+	EXPECT_EQ(calls[0], &call);
+
+	g.RemoveEdge(&back_edge);
+	g.RemoveEdge(&e4);
+	g.RemoveEdge(&e3);
+	g.RemoveEdge(&e2);
+	g.RemoveEdge(&e1);
+}
+
+TEST_F(ControlFlowGraphTest, DominatorTrees)
+{
+	// Entry -> a -> (b | c) -> d -> Exit, with a back edge d -> a.
+	ControlFlowGraph g;
+	Entry entry((Location()));
+	NoOp a((Location()));
+	NoOp b((Location()));
+	NoOp c((Location()));
+	NoOp d((Location()));
+	Exit exit_vertex((Location()));
+
+	g.AddVertex(&entry);
+	g.AddVertex(&a);
+	g.AddVertex(&b);
+	g.AddVertex(&c);
+	g.AddVertex(&d);
+	g.AddVertex(&exit_vertex);
+
+	CFGEdgeTypeFallthrough e1, e2;
+	CFGEdgeTypeGoto ab, ac, bd, cd, back_edge;
+	g.AddEdge(&entry, &a, &e1);
+	g.AddEdge(&a, &b, &ab);
+	g.AddEdge(&a, &c, &ac);
+	g.AddEdge(&b, &d, &bd);
+	g.AddEdge(&c, &d, &cd);
+	g.AddEdge(&d, &a, &back_edge);
+	g.AddEdge(&d, &exit_vertex, &e2);
+
+	DominatorTree dom;
+	dom.Compute(g, &entry, false);
+	ASSERT_TRUE(dom.IsUpToDate(g));
+
+	EXPECT_EQ(dom.GetImmediateDominator(&entry), (StatementBase*)NULL);
+	EXPECT_EQ(dom.GetImmediateDominator(&a), &entry);
+	EXPECT_EQ(dom.GetImmediateDominator(&b), &a);
+	EXPECT_EQ(dom.GetImmediateDominator(&d), &a);
+	EXPECT_EQ(dom.GetImmediateDominator(&exit_vertex), &d);
+	EXPECT_TRUE(dom.Dominates(&a, &a));
+	EXPECT_FALSE(dom.StrictlyDominates(&a, &a));
+	EXPECT_TRUE(dom.Dominates(&a, &exit_vertex));
+	EXPECT_TRUE(dom.Dominates(&entry, &c));
+	EXPECT_FALSE(dom.Dominates(&b, &d));
+	EXPECT_FALSE(dom.Dominates(&d, &a));
+
+	DominatorTree pdom;
+	pdom.Compute(g, &exit_vertex, true);
+
+	EXPECT_EQ(pdom.GetImmediateDominator(&a), &d);
+	EXPECT_EQ(pdom.GetImmediateDominator(&b), &d);
+	EXPECT_EQ(pdom.GetImmediateDominator(&d), &exit_vertex);
+	EXPECT_TRUE(pdom.Dominates(&d, &entry));
+	EXPECT_TRUE(pdom.Dominates(&exit_vertex, &c));
+	EXPECT_FALSE(pdom.Dominates(&b, &a));
+
+	// Any change to the graph makes the trees stale.
+	g.RemoveEdge(&back_edge);
+	EXPECT_FALSE(dom.IsUpToDate(g));
+	EXPECT_FALSE(pdom.IsUpToDate(g));
+
+	g.RemoveEdge(&e2);
+	g.RemoveEdge(&cd);
+	g.RemoveEdge(&bd);
+	g.RemoveEdge(&ac);
+	g.RemoveEdge(&ab);
+	g.RemoveEdge(&e1);
+}
+
+TEST_F(ControlFlowGraphTest, FunctionDominatorTrees)
+{
+	Function *main_f = AddFunction("main");
+	Function *callee = AddFunction("callee");
+
+	StatementBase *call = AddStatement(main_f, new FunctionCall("callee", Location(), ""));
+	BuildAndLinkFunctions();
+
+	// The trees are built with the graph, and linking the call into callee() doesn't change them.
+	const DominatorTree &dom = main_f->GetDominatorTree();
+	const DominatorTree &pdom = main_f->GetPostDominatorTree();
+	EXPECT_EQ(main_f->GetEntryVertexDescriptor(), dom.GetImmediateDominator(call));
+	EXPECT_EQ(main_f->GetExitVertexDescriptor(), pdom.GetImmediateDominator(call));
+	EXPECT_EQ(call, dom.GetImmediateDominator(main_f->GetExitVertexDescriptor()));
+	EXPECT_TRUE(callee->GetPostDominatorTree().IsInTree(callee->GetEntryVertexDescriptor()));
+}
+
+TEST_F(ControlFlowGraphTest, LoopNestingForestNested)
+{
+	// Entry -> a -> b -> c -> d -> Exit, with back edges c -> b and d -> a.
+	ControlFlowGraph g;
+	Entry entry((Location()));
+	NoOp a((Location()));
+	NoOp b((Location()));
+	NoOp c((Location()));
+	NoOp d((Location()));
+	Exit exit_vertex((Location()));
+
+	g.AddVertex(&entry);
+	g.AddVertex(&a);
+	g.AddVertex(&b);
+	g.AddVertex(&c);
+	g.AddVertex(&d);
+	g.AddVertex(&exit_vertex);
+
+	CFGEdgeTypeFallthrough e1, e2, e3, e4, e5;
+	CFGEdgeTypeGoto inner_back, outer_back;
+	g.AddEdge(&entry, &a, &e1);
+	g.AddEdge(&a, &b, &e2);
+	g.AddEdge(&b, &c, &e3);
+	g.AddEdge(&c, &b, &inner_back);
+	g.AddEdge(&c, &d, &e4);
+	g.AddEdge(&d, &a, &outer_back);
+	g.AddEdge(&d, &exit_vertex, &e5);
+
+	LoopNestingForest loops;
+	loops.Compute(g, &entry);
+
+	// The order the back edges are found in depends on the order of the out edges, so just check they're both there.
+	ASSERT_EQ(loops.GetBackEdges().size(), 2);
+	EXPECT_TRUE(std::find(loops.GetBackEdges().begin(), loops.GetBackEdges().end(), &inner_back) != loops.GetBackEdges().end());
+	EXPECT_TRUE(std::find(loops.GetBackEdges().begin(), loops.GetBackEdges().end(), &outer_back) != loops.GetBackEdges().end());
+
+	ASSERT_EQ(loops.NumLoops(), 2);
+	LoopNestingForest::loop_index_type outer = loops.GetInnermostLoop(&a);
+	LoopNestingForest::loop_index_type inner = loops.GetInnermostLoop(&b);
+	ASSERT_NE(outer, LoopNestingForest::NO_LOOP);
+	ASSERT_NE(inner, LoopNestingForest::NO_LOOP);
+	EXPECT_EQ(loops.GetLoop(outer).m_header, &a);
+	EXPECT_EQ(loops.GetLoop(inner).m_header, &b);
+	EXPECT_EQ(loops.GetLoop(inner).m_parent, outer);
+	EXPECT_TRUE(loops.GetLoop(outer).m_is_reducible);
+	EXPECT_EQ(loops.GetLoop(outer).m_num_vertices, 4);
+	EXPECT_EQ(loops.GetLoop(inner).m_num_vertices, 2);
+
+	EXPECT_TRUE(loops.IsLoopHeader(&b));
+	EXPECT_FALSE(loops.IsLoopHeader(&c));
+	EXPECT_EQ(loops.GetLoopDepth(&c), 2);
+	EXPECT_EQ(loops.GetLoopDepth(&d), 1);
+	EXPECT_EQ(loops.GetLoopDepth(&exit_vertex), 0);
+	EXPECT_TRUE(loops.IsInLoop(&c, outer));
+	EXPECT_TRUE(loops.IsInLoop(&c, inner));
+	EXPECT_FALSE(loops.IsInLoop(&d, inner));
+	EXPECT_FALSE(loops.IsInLoop(&entry, outer));
+
+	std::vector<ControlFlowGraph::vertex_descriptor> body;
+	loops.GetLoopBody(g, inner, &body);
+	EXPECT_EQ(body.size(), 2);
+
+	g.RemoveEdge(&e5);
+	g.RemoveEdge(&outer_back);
+	g.RemoveEdge(&e4);
+	g.RemoveEdge(&inner_back);
+	g.RemoveEdge(&e3);
+	g.RemoveEdge(&e2);
+	g.RemoveEdge(&e1);
+}
+
+TEST_F(ControlFlowGraphTest, LoopNestingForestIrreducible)
+{
+	// Entry -> p, which branches into both q and r of the cycle q <-> r.  r -> Exit.
+	ControlFlowGraph g;
+	Entry entry((Location()));
+	NoOp p((Location()));
+	NoOp q((Location()));
+	NoOp r((Location()));
+	Exit exit_vertex((Location()));
+
+	g.AddVertex(&entry);
+	g.AddVertex(&p);
+	g.AddVertex(&q);
+	g.AddVertex(&r);
+	g.AddVertex(&exit_vertex);
+
+	CFGEdgeTypeFallthrough e1, e2;
+	CFGEdgeTypeGoto pq, pr, qr, rq;
+	g.AddEdge(&entry, &p, &e1);
+	g.AddEdge(&p, &q, &pq);
+	g.AddEdge(&p, &r, &pr);
+	g.AddEdge(&q, &r, &qr);
+	g.AddEdge(&r, &q, &rq);
+	g.AddEdge(&r, &exit_vertex, &e2);
+
+	LoopNestingForest loops;
+	loops.Compute(g, &entry);
+
+	ASSERT_EQ(loops.NumLoops(), 1);
+	EXPECT_FALSE(loops.GetLoop(0).m_is_reducible);
+	EXPECT_TRUE(loops.IsInLoop(&q, 0));
+	EXPECT_TRUE(loops.IsInLoop(&r, 0));
+	EXPECT_FALSE(loops.IsInLoop(&p, 0));
+
+	g.RemoveEdge(&e2);
+	g.RemoveEdge(&rq);
+	g.RemoveEdge(&qr);
+	g.RemoveEdge(&pr);
+	g.RemoveEdge(&pq);
+	g.RemoveEdge(&e1);
+}
+
+TEST_F(ControlFlowGraphTest, ResolveLinksInPlace)
+{
+	ControlFlowGraph g;
+	Goto *jump = new Goto(Location(), "target");
+	Label *target = new Label(Location(), "target");
+	LabelMap label_map;
+
+	g.AddVertex(jump);
+	g.AddVertex(target);
+	label_map["target"] = target;
+
+	EXPECT_FALSE(jump->IsLinked());
+	EXPECT_EQ(jump->GetStatementTextDOT(), "GOTO_UNLINKED");
+
+	// Linking adds the edge to the same statement, rather than replacing it.
+	ASSERT_TRUE(jump->ResolveLinks(g, label_map));
+	EXPECT_TRUE(jump->IsLinked());
+	EXPECT_EQ(jump->GetStatementTextDOT(), "GOTO");
+	EXPECT_EQ(g.NumVertices(), 2);
+	ASSERT_EQ(jump->OutDegree(), 1);
+	CFGEdgeTypeFallthrough *e = jump->GetFirstOutEdgeOfType<CFGEdgeTypeFallthrough>();
+	ASSERT_TRUE(e != NULL);
+	EXPECT_EQ(e->Source(), jump);
+	EXPECT_EQ(e->Target(), target);
+
+	g.RemoveEdge(e);
+	delete e;
+	g.RemoveVertex(target);
+	g.RemoveVertex(jump);
+	delete target;
+	delete jump;
+}
+
+TEST_F(ControlFlowGraphTest, RemoveIfRedundant)
+{
+	ControlFlowGraph g;
+	Label *before = new Label(Location(), "before");
+	Label *synthetic = new Label(Location(), "<D.1234>", true);
+	Label *after = new Label(Location(), "after");
+
+	EXPECT_FALSE(before->IsCompilerGenerated());
+	EXPECT_TRUE(synthetic->IsCompilerGenerated());
+
+	g.AddVertex(before);
+	g.AddVertex(synthetic);
+	g.AddVertex(after);
+	CFGEdgeTypeFallthrough *e1 = new CFGEdgeTypeFallthrough;
+	CFGEdgeTypeFallthrough *e2 = new CFGEdgeTypeFallthrough;
+	g.AddEdge(before, synthetic, e1);
+	g.AddEdge(synthetic, after, e2);
+
+	// The ends of the chain have only one edge each, so they aren't redundant.
+	EXPECT_FALSE(RemoveIfRedundant(&g, before));
+	EXPECT_FALSE(RemoveIfRedundant(&g, after));
+
+	// The middle vertex is bypassed, and its in edge now goes straight to its old successor.
+	ASSERT_TRUE(RemoveIfRedundant(&g, synthetic));
+	EXPECT_EQ(g.NumVertices(), 2);
+	EXPECT_EQ(e1->Source(), before);
+	EXPECT_EQ(e1->Target(), after);
+	EXPECT_EQ(after->InDegree(), 1);
+
+	g.RemoveEdge(e1);
+	delete e1;
+	g.RemoveVertex(after);
+	g.RemoveVertex(before);
+	delete after;
+	delete before;
+}
+
+TEST_F(ControlFlowGraphTest, GotoClosedLoop)
+{
+	Function *f = AddFunction("f");
+
+	// head: if(c) goto body; else goto out;  body: ; goto head;  out:
+	StatementBase *head = AddStatement(f, new Label(Location(), "head"));
+	StatementBase *cond = AddStatement(f, new If(Location(), "c", "body", "out"));
+	StatementBase *body = AddStatement(f, new Label(Location(), "body"));
+	StatementBase *noop = AddStatement(f, new NoOp(Location()));
+	AddStatement(f, new Goto(Location(), "head"));
+	StatementBase *out = AddStatement(f, new Label(Location(), "out"));
+	BuildAndLinkFunctions();
+
+	// The Goto is removed as redundant before the back edges are found, so the statement before it closes the loop.
+	EXPECT_EQ(7, f->GetCFGPointer()->NumVertices());
+	EXPECT_EQ(5U, m_statement_lists[0]->size());
+	ASSERT_EQ(1U, f->GetLoopNestingForest().NumLoops());
+	EXPECT_EQ(head, f->GetLoopNestingForest().GetLoop(0).m_header);
+	EXPECT_EQ(cond, head->GetFirstOutEdgeOfType<CFGEdgeTypeFallthrough>()->Target());
+	EXPECT_EQ(noop, body->GetFirstOutEdgeOfType<CFGEdgeTypeFallthrough>()->Target());
+
+	// Its back edge, and the Impossible edge out of the loop through the If's other arm.
+	ASSERT_EQ(2, noop->OutDegree());
+	StatementBase::out_edge_iterator ei, eend;
+	long num_back_edges = 0, num_impossible_edges = 0;
+	noop->OutEdges(&ei, &eend);
+	for(; ei != eend; ++ei)
+	{
+		if((*ei)->IsBackEdge())
+		{
+			EXPECT_EQ(head, (*ei)->Target());
+			++num_back_edges;
+		}
+		else
+		{
+			EXPECT_TRUE((*ei)->IsImpossible());
+			EXPECT_EQ(out, (*ei)->Target());
+			++num_impossible_edges;
+		}
+	}
+	EXPECT_EQ(1, num_back_edges);
+	EXPECT_EQ(1, num_impossible_edges);
+
+	// The loop is left through the If, and out falls through to EXIT.
+	EXPECT_EQ(2, cond->OutDegree());
+	EXPECT_EQ(2, out->InDegree());
+	EXPECT_EQ(f->GetExitVertexDescriptor(), out->GetFirstOutEdgeOfType<CFGEdgeTypeFallthrough>()->Target());
+}
+
+TEST_F(ControlFlowGraphTest, InfiniteLoopReachesExit)
+{
+	Function *f = AddFunction("f");
+
+	// loop: ; goto loop;  There's no decision statement in the loop, and nothing after it.
+	StatementBase *loop = AddStatement(f, new Label(Location(), "loop"));
+	StatementBase *noop = AddStatement(f, new NoOp(Location()));
+	AddStatement(f, new Goto(Location(), "loop"));
+	BuildAndLinkFunctions();
+
+	// The Goto is gone, and the back edge is from the NoOp.  With no way out of the loop to find, its Impossible
+	// edge goes to EXIT.
+	ControlFlowGraph::vertex_descriptor exit_vertex = f->GetExitVertexDescriptor();
+	EXPECT_EQ(2U, m_statement_lists[0]->size());
+	ASSERT_EQ(2, noop->OutDegree());
+	StatementBase::out_edge_iterator ei, eend;
+	long num_back_edges = 0, num_impossible_edges = 0;
+	noop->OutEdges(&ei, &eend);
+	for(; ei != eend; ++ei)
+	{
+		if((*ei)->IsBackEdge())
+		{
+			EXPECT_EQ(loop, (*ei)->Target());
+			++num_back_edges;
+		}
+		else
+		{
+			EXPECT_TRUE((*ei)->IsImpossible());
+			EXPECT_EQ(exit_vertex, (*ei)->Target());
+			++num_impossible_edges;
+		}
+	}
+	EXPECT_EQ(1, num_back_edges);
+	EXPECT_EQ(1, num_impossible_edges);
+
+	// EXIT has that edge and its own self edge, and so post-dominates the loop.
+	EXPECT_EQ(2, exit_vertex->InDegree());
+	EXPECT_EQ(exit_vertex, f->GetPostDominatorTree().GetImmediateDominator(noop));
+}
+
+TEST_F(ControlFlowGraphTest, StructuralHash)
+{
+	Location loc("header.h", 10);
+	Goto a(loc, "<D.1>");
+	Goto same_as_a(loc, "<D.1>");
+	Goto other_target(loc, "<D.2>");
+	Goto other_line(Location("header.h", 11), "<D.1>");
+	Label label(loc, "<D.1>", true);
+	StatementBase::CompilerNameMap names;
+
+	// Copies of the same statement from different translation units hash the same.
+	EXPECT_EQ(a.GetStructuralHash(&names), same_as_a.GetStructuralHash(&names));
+
+	// Anything that would change the shape of the graph changes the hash.
+	EXPECT_NE(a.GetStructuralHash(&names), other_target.GetStructuralHash(&names));
+	EXPECT_NE(a.GetStructuralHash(&names), other_line.GetStructuralHash(&names));
+	EXPECT_NE(a.GetStructuralHash(&names), label.GetStructuralHash(&names));
+}
+
+TEST_F(ControlFlowGraphTest, FingerprintIgnoresCompilerNameNumbering)
+{
+	StatementBase::CompilerNameMap names;
+
+	// Names are numbered by first appearance.  Numbers which aren't part of a name are left alone.
+	EXPECT_EQ("iftmp.#0 = D.#1 + 1.5; goto <D.#1>; f.c", names.Canonicalize("iftmp.3 = D.1234 + 1.5; goto <D.1234>; f.c"));
+	EXPECT_EQ("D.#2", names.Canonicalize("D.99"));
+
+	// The same inline function, as GCC numbers it in two translation units.
+	Location loc("header.h", 10);
+	Goto tu1_goto(loc, "<D.1234>");
+	Label tu1_label(Location("header.h", 12), "<D.1234>", true);
+	Goto tu2_goto(loc, "<D.5678>");
+	Label tu2_label(Location("header.h", 12), "<D.5678>", true);
+	Label tu2_other_label(Location("header.h", 12), "<D.5679>", true);
+
+	std::vector<StatementBase*> tu1_body, tu2_body, other_body;
+	tu1_body.push_back(&tu1_goto);
+	tu1_body.push_back(&tu1_label);
+	tu2_body.push_back(&tu2_goto);
+	tu2_body.push_back(&tu2_label);
+
+	// A jump to a different label than the one that follows isn't the same function.
+	other_body.push_back(&tu2_goto);
+	other_body.push_back(&tu2_other_label);
+
+	EXPECT_EQ(Function::ComputeFingerprint(tu1_body), Function::ComputeFingerprint(tu2_body));
+	EXPECT_NE(Function::ComputeFingerprint(tu1_body), Function::ComputeFingerprint(other_body));
+}
+
+TEST_F(ControlFlowGraphTest, ReachabilitySkeleton)
+{
+	// Entry -> s1 -> call1 -> s2, which either goes through call2 or jumps around it to s3, then Exit.
+	ControlFlowGraph g;
+	Entry entry((Location()));
+	NoOp s1((Location()));
+	FunctionCall call1("f", Location(), "");
+	NoOp s2((Location()));
+	FunctionCall call2("g", Location(), "");
+	NoOp s3((Location()));
+	Exit exit_vertex((Location()));
+
+	g.AddVertex(&entry);
+	g.AddVertex(&s1);
+	g.AddVertex(&call1);
+	g.AddVertex(&s2);
+	g.AddVertex(&call2);
+	g.AddVertex(&s3);
+	g.AddVertex(&exit_vertex);
+
+	CFGEdgeTypeFallthrough e1, e2, e3, e4, e5, e6;
+	CFGEdgeTypeGoto jump;
+	g.AddEdge(&entry, &s1, &e1);
+	g.AddEdge(&s1, &call1, &e2);
+	g.AddEdge(&call1, &s2, &e3);
+	g.AddEdge(&s2, &call2, &e4);
+	g.AddEdge(&s2, &s3, &jump);
+	g.AddEdge(&call2, &s3, &e5);
+	g.AddEdge(&s3, &exit_vertex, &e6);
+
+	BasicBlockGraph bbg;
+	bbg.Build(g, &entry);
+	ReachabilitySkeleton skeleton;
+	skeleton.Build(g, bbg, &exit_vertex);
+
+	// Only Entry, Exit and the calls are left.
+	EXPECT_EQ(skeleton.NumVertices(), 4);
+	EXPECT_TRUE(skeleton.IsSkeletonVertex(&entry));
+	EXPECT_TRUE(skeleton.IsSkeletonVertex(&call1));
+	EXPECT_TRUE(skeleton.IsSkeletonVertex(&call2));
+	EXPECT_TRUE(skeleton.IsSkeletonVertex(&exit_vertex));
+	EXPECT_FALSE(skeleton.IsSkeletonVertex(&s2));
+
+	// Entry only reaches call1 without passing through a call.
+	ASSERT_EQ(skeleton.GetSuccessors(&entry).size(), 1);
+	EXPECT_EQ(skeleton.GetSuccessors(&entry)[0], &call1);
+
+	// call1 reaches call2, or Exit by jumping around it.
+	const std::vector<ControlFlowGraph::vertex_descriptor> &after_call1 = skeleton.GetSuccessors(&call1);
+	ASSERT_EQ(after_call1.size(), 2);
+	EXPECT_TRUE(std::find(after_call1.begin(), after_call1.end(), &call2) != after_call1.end());
+	EXPECT_TRUE(std::find(after_call1.begin(), after_call1.end(), &exit_vertex) != after_call1.end());
+
+	ASSERT_EQ(skeleton.GetSuccessors(&call2).size(), 1);
+	EXPECT_EQ(skeleton.GetSuccessors(&call2)[0], &exit_vertex);
+	EXPECT_TRUE(skeleton.GetSuccessors(&exit_vertex).empty());
+	EXPECT_TRUE(skeleton.GetSuccessors(&s2).empty());
+	EXPECT_EQ(skeleton.NumEdges(), 4);
+
+	g.RemoveEdge(&e6);
+	g.RemoveEdge(&e5);
+	g.RemoveEdge(&jump);
+	g.RemoveEdge(&e4);
+	g.RemoveEdge(&e3);
+	g.RemoveEdge(&e2);
+	g.RemoveEdge(&e1);
+}
+
+TEST_F(ControlFlowGraphTest, ShortestWitnessPath)
+{
+	Function *main_f = AddFunction("main");
+	Function *sink = AddFunction("sink");
+
+	// main() calls sink() at the end of both arms of an if.  The first arm is three statements longer, and then falls into
+	// the second.
+	AddStatement(main_f, new If(Location(), "c", "long", "short"));
+	AddStatement(main_f, new Label(Location(), "long"));
+	AddStatement(main_f, new NoOp(Location()));
+	AddStatement(main_f, new NoOp(Location()));
+	AddStatement(main_f, new NoOp(Location()));
+	AddStatement(main_f, new FunctionCall("sink", Location(), ""));
+	AddStatement(main_f, new Label(Location(), "short"));
+	StatementBase *short_call = AddStatement(main_f, new FunctionCall("sink", Location(), ""));
+	BuildAndLinkFunctions();
+
+	// Entry -> if -> short -> call -> sink's Entry.
+	std::deque<ControlFlowGraph::edge_descriptor> witness;
+	ASSERT_TRUE(shortest_witness_path(main_f->GetEntryVertexDescriptor(), sink->GetEntryVertexDescriptor(), &witness));
+	ASSERT_EQ(4U, witness.size());
+	EXPECT_EQ(main_f->GetEntryVertexDescriptor(), witness.front()->Source());
+	EXPECT_EQ(short_call, witness.back()->Source());
+	EXPECT_EQ(sink->GetEntryVertexDescriptor(), witness.back()->Target());
+	for(std::size_t i = 1; i < witness.size(); ++i)
+	{
+		EXPECT_EQ(witness[i-1]->Target(), witness[i]->Source());
+	}
+
+	// A vertex is reached by the empty path from itself.
+	witness.clear();
+	EXPECT_TRUE(shortest_witness_path(sink->GetEntryVertexDescriptor(), sink->GetEntryVertexDescriptor(), &witness));
+	EXPECT_TRUE(witness.empty());
+}
+
+TEST_F(ControlFlowGraphTest, ShortestWitnessPathMatchesReturns)
+{
+	Function *main_f = AddFunction("main");
+	Function *other = AddFunction("other");
+	Function *helper = AddFunction("helper");
+	Function *sink = AddFunction("sink");
+
+	// main() and other() both call helper(), which calls itself.  Only other() goes on to call sink().
+	AddStatement(main_f, new FunctionCall("helper", Location(), ""));
+	StatementBase *other_calls_helper = AddStatement(other, new FunctionCall("helper", Location(), ""));
+	StatementBase *other_calls_sink = AddStatement(other, new FunctionCall("sink", Location(), ""));
+	AddStatement(helper, new FunctionCall("helper", Location(), ""));
+	BuildAndLinkFunctions();
+
+	// helper()'s Exit returns to other(), but a path from main() can only return to main().
+	std::deque<ControlFlowGraph::edge_descriptor> witness;
+	EXPECT_FALSE(shortest_witness_path(main_f->GetEntryVertexDescriptor(), sink->GetEntryVertexDescriptor(), &witness));
+	EXPECT_TRUE(witness.empty());
+
+	// From other(), the call to helper() is passed over by its fallthrough edge.
+	ASSERT_TRUE(shortest_witness_path(other->GetEntryVertexDescriptor(), sink->GetEntryVertexDescriptor(), &witness));
+	ASSERT_EQ(3U, witness.size());
+	EXPECT_EQ(other_calls_helper, witness[1]->Source());
+	EXPECT_EQ(other_calls_sink, witness[1]->Target());
+	EXPECT_EQ(sink->GetEntryVertexDescriptor(), witness[2]->Target());
+}
+
+TEST_F(ControlFlowGraphTest, ShortestWitnessPathUnreachableSink)
+{
+	Function *main_f = AddFunction("main");
+	Function *a = AddFunction("a");
+	Function *sink = AddFunction("sink");
+
+	// main() calls a(), which calls an undefined function.  Nothing calls sink().
+	AddStatement(main_f, new FunctionCall("a", Location(), ""));
+	AddStatement(a, new FunctionCall("printf", Location(), ""));
+	BuildAndLinkFunctions();
+
+	std::deque<ControlFlowGraph::edge_descriptor> witness;
+	EXPECT_FALSE(shortest_witness_path(main_f->GetEntryVertexDescriptor(), sink->GetEntryVertexDescriptor(), &witness));
+	EXPECT_TRUE(witness.empty());
+
+	// The search still goes down into a().
+	EXPECT_TRUE(shortest_witness_path(main_f->GetEntryVertexDescriptor(), a->GetExitVertexDescriptor(), &witness));
+}
+
+TEST_F(ControlFlowGraphTest, LayeredLayout)
+{
+	// A loop 1 -> {2, 3} -> 4 -> 1, entered from 0, with an edge skipping from 0 straight to 4.
+	LayeredLayout layout;
+	LayeredLayout::VertexAttributes va;
+	LayeredLayout::EdgeAttributes ea;
+
+	for(long i = 0; i < 5; ++i)
+	{
+		std::ostringstream oss;
+		oss << "v" << i;
+		va.m_label_lines.assign(1, oss.str());
+		ASSERT_EQ(i, layout.AddVertex(va));
+	}
+	layout.AddEdge(0, 1, false, ea);
+	layout.AddEdge(1, 2, false, ea);
+	layout.AddEdge(1, 3, false, ea);
+	layout.AddEdge(2, 4, false, ea);
+	layout.AddEdge(3, 4, false, ea);
+	layout.AddEdge(4, 1, true, ea);
+	layout.AddEdge(0, 4, false, ea);
+	layout.Layout();
+
+	// The back edge doesn't push the loop header down.
+	ASSERT_EQ(4, layout.NumLayers());
+	ASSERT_EQ(0, layout.GetLayer(0));
+	ASSERT_EQ(1, layout.GetLayer(1));
+	ASSERT_EQ(2, layout.GetLayer(2));
+	ASSERT_EQ(2, layout.GetLayer(3));
+	ASSERT_EQ(3, layout.GetLayer(4));
+
+	// There's an ordering without crossings, and the sweeps find it.
+	ASSERT_EQ(0, layout.NumCrossings());
+
+	// Vertices on the same layer don't overlap, and are at the same height.
+	ASSERT_NE(layout.GetPositionInLayer(2), layout.GetPositionInLayer(3));
+	ASSERT_GE(std::abs(layout.GetCenter(2).m_x - layout.GetCenter(3).m_x), 40.0);
+	ASSERT_EQ(layout.GetCenter(2).m_y, layout.GetCenter(3).m_y);
+
+	// The long edge goes through a dummy vertex on each of the two layers it crosses.
+	ASSERT_EQ(4U, layout.GetEdgePoints(6).size());
+	ASSERT_LT(layout.GetEdgePoints(6).front().m_y, layout.GetEdgePoints(6).back().m_y);
+
+	// The back edge is drawn from its source at the bottom up to its target.
+	ASSERT_GT(layout.GetEdgePoints(5).front().m_y, layout.GetEdgePoints(5).back().m_y);
+
+	std::ostringstream svg;
+	layout.WriteSVG(svg, "f<1>");
+	ASSERT_NE(std::string::npos, svg.str().find("<title>f&lt;1&gt;</title>"));
+	long num_polylines = 0;
+	for(std::string::size_type pos = svg.str().find("<polyline"); pos != std::string::npos;
+			pos = svg.str().find("<polyline", pos + 1))
+	{
+		++num_polylines;
+	}
+	ASSERT_EQ(7, num_polylines);
+}
+
@@ -37,7 +37,7 @@ void DFSCallStack::PushCallStack(CallStackFrameBase* cfsb)
 void DFSCallStack::PopCallStack()
 {
 	// Remove the function we're returning from from the functions-on-the-call-stack set.
-	m_call_set.erase(m_call_stack.top()->GetPushingCall()->m_target_function);
+	m_call_set.erase(m_call_stack.top()->GetPushingCall()->GetCalledFunction());
 
 	// Delete the CallStackFrameBase object before popping it.
 	delete m_call_stack.top();
@@ -0,0 +1,316 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "DominatorTree.h"
+
+#include "edges/edge_types.h"
+
+/**
+ * Get the vertices adjacent to @a v over intraprocedural edges.
+ *
+ * @param v  The vertex.
+ * @param backwards  If false, get the targets of the out edges of @a v.  If true, get the sources of its in edges.
+ * @param[out] adjacent  Cleared and filled with the adjacent vertices.
+ */
+static void intraprocedural_adjacent_vertices(ControlFlowGraph::vertex_descriptor v, bool backwards,
+		std::vector<ControlFlowGraph::vertex_descriptor> *adjacent)
+{
+	adjacent->clear();
+
+	if(!backwards)
+	{
+		StatementBase::out_edge_iterator eit, eend;
+		v->OutEdges(&eit, &eend);
+		for(; eit != eend; ++eit)
+		{
+			if((dynamic_cast<CFGEdgeTypeFunctionCall*>(*eit) == NULL) && (dynamic_cast<CFGEdgeTypeReturn*>(*eit) == NULL))
+			{
+				adjacent->push_back((*eit)->Target());
+			}
+		}
+	}
+	else
+	{
+		StatementBase::in_edge_iterator eit, eend;
+		v->InEdges(&eit, &eend);
+		for(; eit != eend; ++eit)
+		{
+			if((dynamic_cast<CFGEdgeTypeFunctionCall*>(*eit) == NULL) && (dynamic_cast<CFGEdgeTypeReturn*>(*eit) == NULL))
+			{
+				adjacent->push_back((*eit)->Source());
+			}
+		}
+	}
+}
+
+/**
+ * A frame of the iterative depth-first search in DominatorTree::NumberVertices().
+ */
+struct DominatorDFSFrame
+{
+	ControlFlowGraph::vertex_descriptor m_v;
+	std::vector<ControlFlowGraph::vertex_descriptor> m_succs;
+	std::size_t m_next;
+};
+
+DominatorTree::DominatorTree()
+{
+	m_cfg = NULL;
+	m_modification_count = 0;
+	m_post_dominators = false;
+}
+
+DominatorTree::~DominatorTree()
+{
+}
+
+void DominatorTree::Compute(const ControlFlowGraph &cfg, ControlFlowGraph::vertex_descriptor root, bool post_dominators)
+{
+	m_post_dominators = post_dominators;
+
+	NumberVertices(cfg, root);
+
+	const long n = m_vertices.size();
+
+	// Build the predecessor lists in terms of reverse postorder numbers.  "Predecessor" here is in the direction of the
+	// analysis, so for post-dominators these are the successors in the ControlFlowGraph.
+	std::vector<std::size_t> pred_offsets(n+1, 0);
+	std::vector<long> preds;
+	std::vector<ControlFlowGraph::vertex_descriptor> adjacent;
+	for(long i = 0; i < n; ++i)
+	{
+		pred_offsets[i] = preds.size();
+		intraprocedural_adjacent_vertices(m_vertices[i], !m_post_dominators, &adjacent);
+		for(std::size_t j = 0; j < adjacent.size(); ++j)
+		{
+			long p = GetNumber(adjacent[j]);
+			if(p != -1)
+			{
+				preds.push_back(p);
+			}
+		}
+	}
+	pred_offsets[n] = preds.size();
+
+	// Iterate to the fixed point.  The root is number 0 and is its own immediate dominator.
+	m_idom.assign(n, -1);
+	m_idom[0] = 0;
+	bool changed = true;
+	while(changed)
+	{
+		changed = false;
+		for(long b = 1; b < n; ++b)
+		{
+			long new_idom = -1;
+			for(std::size_t j = pred_offsets[b]; j < pred_offsets[b+1]; ++j)
+			{
+				long p = preds[j];
+				if(m_idom[p] == -1)
+				{
+					// Not processed yet.
+					continue;
+				}
+
+				if(new_idom == -1)
+				{
+					new_idom = p;
+				}
+				else
+				{
+					// Intersect.  Reverse postorder numbers decrease as we walk up the tree.
+					long f1 = p;
+					long f2 = new_idom;
+					while(f1 != f2)
+					{
+						while(f1 > f2)
+						{
+							f1 = m_idom[f1];
+						}
+						while(f2 > f1)
+						{
+							f2 = m_idom[f2];
+						}
+					}
+					new_idom = f1;
+				}
+			}
+
+			if(m_idom[b] != new_idom)
+			{
+				m_idom[b] = new_idom;
+				changed = true;
+			}
+		}
+	}
+
+	NumberTree();
+
+	m_cfg = &cfg;
+	m_modification_count = cfg.GetModificationCount();
+}
+
+bool DominatorTree::IsUpToDate(const ControlFlowGraph &cfg) const
+{
+	return (m_cfg == &cfg) && (m_modification_count == cfg.GetModificationCount());
+}
+
+void DominatorTree::Invalidate()
+{
+	m_cfg = NULL;
+	m_number.clear();
+	m_vertices.clear();
+	m_idom.clear();
+	m_tree_pre.clear();
+	m_tree_last.clear();
+}
+
+ControlFlowGraph::vertex_descriptor DominatorTree::GetImmediateDominator(ControlFlowGraph::vertex_descriptor v) const
+{
+	long i = GetNumber(v);
+
+	if(i <= 0)
+	{
+		// Either the root or not in the tree.
+		return NULL;
+	}
+
+	return m_vertices[m_idom[i]];
+}
+
+bool DominatorTree::Dominates(ControlFlowGraph::vertex_descriptor a, ControlFlowGraph::vertex_descriptor b) const
+{
+	long ai = GetNumber(a);
+	long bi = GetNumber(b);
+
+	if((ai == -1) || (bi == -1))
+	{
+		return false;
+	}
+
+	// a dominates b iff b is in a's subtree.
+	return (m_tree_pre[ai] <= m_tree_pre[bi]) && (m_tree_pre[bi] <= m_tree_last[ai]);
+}
+
+long DominatorTree::GetNumber(ControlFlowGraph::vertex_descriptor v) const
+{
+	if(v->GetIndex() >= m_number.size())
+	{
+		return -1;
+	}
+
+	return m_number[v->GetIndex()];
+}
+
+void DominatorTree::NumberVertices(const ControlFlowGraph &cfg, ControlFlowGraph::vertex_descriptor root)
+{
+	std::vector<char> discovered(cfg.GetVertexIndexUpperBound(), 0);
+	std::vector<ControlFlowGraph::vertex_descriptor> postorder;
+	std::vector<DominatorDFSFrame> stack;
+
+	discovered[root->GetIndex()] = 1;
+	stack.push_back(DominatorDFSFrame());
+	stack.back().m_v = root;
+	stack.back().m_next = 0;
+	intraprocedural_adjacent_vertices(root, m_post_dominators, &stack.back().m_succs);
+
+	while(!stack.empty())
+	{
+		DominatorDFSFrame &top = stack.back();
+
+		if(top.m_next == top.m_succs.size())
+		{
+			// Finished with this vertex.
+			postorder.push_back(top.m_v);
+			stack.pop_back();
+			continue;
+		}
+
+		ControlFlowGraph::vertex_descriptor next = top.m_succs[top.m_next];
+		top.m_next++;
+		if(discovered[next->GetIndex()] == 0)
+		{
+			discovered[next->GetIndex()] = 1;
+			stack.push_back(DominatorDFSFrame());
+			stack.back().m_v = next;
+			stack.back().m_next = 0;
+			intraprocedural_adjacent_vertices(next, m_post_dominators, &stack.back().m_succs);
+		}
+	}
+
+	// Reverse the postorder to get the numbering.
+	m_number.assign(cfg.GetVertexIndexUpperBound(), -1);
+	m_vertices.assign(postorder.rbegin(), postorder.rend());
+	for(std::size_t i = 0; i < m_vertices.size(); ++i)
+	{
+		m_number[m_vertices[i]->GetIndex()] = i;
+	}
+}
+
+void DominatorTree::NumberTree()
+{
+	const long n = m_vertices.size();
+
+	// Build the child lists of the tree.
+	std::vector<std::size_t> child_offsets(n+1, 0);
+	std::vector<long> children(n > 0 ? n-1 : 0);
+	for(long i = 1; i < n; ++i)
+	{
+		child_offsets[m_idom[i]+1]++;
+	}
+	for(long i = 0; i < n; ++i)
+	{
+		child_offsets[i+1] += child_offsets[i];
+	}
+	std::vector<std::size_t> fill(child_offsets.begin(), child_offsets.end()-1);
+	for(long i = 1; i < n; ++i)
+	{
+		children[fill[m_idom[i]]++] = i;
+	}
+
+	// Walk the tree depth-first, assigning each vertex its preorder number on the way down and the last preorder
+	// number of its subtree on the way back up.
+	m_tree_pre.assign(n, -1);
+	m_tree_last.assign(n, -1);
+	if(n == 0)
+	{
+		return;
+	}
+
+	long next_pre = 0;
+	std::vector< std::pair<long, std::size_t> > stack;
+	stack.push_back(std::make_pair(0L, child_offsets[0]));
+	m_tree_pre[0] = next_pre++;
+	while(!stack.empty())
+	{
+		long u = stack.back().first;
+		std::size_t &next_child = stack.back().second;
+
+		if(next_child == child_offsets[u+1])
+		{
+			m_tree_last[u] = next_pre - 1;
+			stack.pop_back();
+			continue;
+		}
+
+		long c = children[next_child];
+		next_child++;
+		m_tree_pre[c] = next_pre++;
+		stack.push_back(std::make_pair(c, child_offsets[c]));
+	}
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#ifndef DOMINATORTREE_H_
+#define DOMINATORTREE_H_
+
+#include <vector>
+
+#include "ControlFlowGraph.h"
+
+/**
+ * Dominator or post-dominator tree of a single Function's ControlFlowGraph.
+ *
+ * The tree is computed with the iterative algorithm of Cooper, Harvey and Kennedy ("A Simple, Fast Dominance
+ * Algorithm"), over a reverse postorder numbering of the vertices reachable from the root.  Only intraprocedural
+ * edges are considered, i.e. FunctionCall and Return edges are ignored.  Impossible edges are included, since they're
+ * what guarantee that every vertex reaches the Exit vertex.
+ *
+ * Once the tree is built, its vertices are numbered with a depth-first preorder walk of the tree, and each vertex
+ * records the last preorder number in its subtree.  "a dominates b" is then just an interval check.
+ */
+class DominatorTree
+{
+public:
+	DominatorTree();
+	~DominatorTree();
+
+	/**
+	 * Compute the tree, replacing any previous one.
+	 *
+	 * @param cfg  The ControlFlowGraph to compute the tree of.
+	 * @param root The root of the tree.  The Function's Entry vertex for dominators, its Exit vertex for post-dominators.
+	 * @param post_dominators  If true, compute the post-dominator tree, i.e. follow the edges backwards.
+	 */
+	void Compute(const ControlFlowGraph &cfg, ControlFlowGraph::vertex_descriptor root, bool post_dominators);
+
+	/**
+	 * @return true if the tree has been computed for @a cfg and @a cfg hasn't been modified since.
+	 */
+	bool IsUpToDate(const ControlFlowGraph &cfg) const;
+
+	/**
+	 * Throw away the tree.  It will be recomputed the next time it's needed.
+	 */
+	void Invalidate();
+
+	/// @name Queries.
+	/// These may only be made on an up-to-date tree.
+	//@{
+
+	/**
+	 * @return true if @a v is reachable from the root, in the direction the tree was computed in.
+	 */
+	bool IsInTree(ControlFlowGraph::vertex_descriptor v) const { return GetNumber(v) != -1; };
+
+	/**
+	 * @return The immediate (post-)dominator of @a v, or NULL if @a v is the root or isn't in the tree.
+	 */
+	ControlFlowGraph::vertex_descriptor GetImmediateDominator(ControlFlowGraph::vertex_descriptor v) const;
+
+	/**
+	 * Determine whether @a a (post-)dominates @a b.  Every vertex in the tree dominates itself.
+	 * Vertices which aren't in the tree dominate and are dominated by nothing.
+	 */
+	bool Dominates(ControlFlowGraph::vertex_descriptor a, ControlFlowGraph::vertex_descriptor b) const;
+
+	/**
+	 * @return true if @a a dominates @a b and @a a != @a b.
+	 */
+	bool StrictlyDominates(ControlFlowGraph::vertex_descriptor a, ControlFlowGraph::vertex_descriptor b) const
+	{
+		return (a != b) && Dominates(a, b);
+	};
+
+	//@}
+
+private:
+
+	/**
+	 * @return The reverse postorder number of @a v, or -1 if it isn't in the tree.
+	 */
+	long GetNumber(ControlFlowGraph::vertex_descriptor v) const;
+
+	/**
+	 * Number the vertices reachable from @a root in reverse postorder.
+	 */
+	void NumberVertices(const ControlFlowGraph &cfg, ControlFlowGraph::vertex_descriptor root);
+
+	/**
+	 * Assign the preorder intervals of the dominator tree.
+	 */
+	void NumberTree();
+
+	/// The ControlFlowGraph the tree was computed for, or NULL if there's no valid tree.
+	const ControlFlowGraph *m_cfg;
+
+	/// The modification count of m_cfg at the time the tree was computed.
+	unsigned long m_modification_count;
+
+	/// Whether this is a post-dominator tree.
+	bool m_post_dominators;
+
+	/// Reverse postorder number of each vertex, indexed by Vertex::GetIndex(), or -1 if the vertex isn't in the tree.
+	std::vector<long> m_number;
+
+	/// @name Per-vertex data, indexed by reverse postorder number.
+	//@{
+
+	/// The vertices.
+	std::vector<ControlFlowGraph::vertex_descriptor> m_vertices;
+
+	/// The number of each vertex's immediate dominator.  The root is its own immediate dominator.
+	std::vector<long> m_idom;
+
+	/// Preorder number of each vertex in the dominator tree.
+	std::vector<long> m_tree_pre;
+
+	/// The largest preorder number in each vertex's subtree.
+	std::vector<long> m_tree_last;
+
+	//@}
+};
+
+#endif /* DOMINATORTREE_H_ */
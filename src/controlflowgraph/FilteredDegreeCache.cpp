@@ -0,0 +1,189 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "FilteredDegreeCache.h"
+
+#include <boost/tuple/tuple.hpp>
+
+#include "edges/edge_types.h"
+
+long filtered_in_degree(ControlFlowGraph::vertex_descriptor v, bool only_decision_predecessors)
+{
+	StatementBase::in_edge_iterator ieit, ieend;
+
+	v->InEdges(&ieit, &ieend);
+
+	long i = 0;
+	bool saw_function_call_already = false;
+	for (; ieit != ieend; ++ieit)
+	{
+		if ((*ieit)->IsBackEdge())
+		{
+			// Always skip anything marked as a back edge.
+			continue;
+		}
+
+		if(only_decision_predecessors)
+		{
+			// Is the predecessor a decision statement?
+			if(!(*ieit)->Source()->IsDecisionStatement())
+			{
+				continue;
+			}
+		}
+
+		// Count up all the incoming edges, with two exceptions:
+		// - Ignore Return edges.  They will always have exactly one matching Fallthrough in edge from a resolved FunctionCall,
+		//   which is what we'll count instead.
+		// - Ignore all but the first CFGEdgeTypeFunctionCall.  The situation here is that we'd be
+		//   looking at a vertex v that's an ENTRY statement, with a predecessor which is a resolved FunctionCall.
+		//   Any particular instance of an ENTRY has at most only one valid FunctionCall edge.
+		//   For our current purposes, we only care about this one.
+		if ((dynamic_cast<CFGEdgeTypeReturn*>(*ieit) == NULL)
+				&& (saw_function_call_already == false))
+		{
+			i++;
+		}
+
+		if (dynamic_cast<CFGEdgeTypeFunctionCall*>(*ieit)
+				!= NULL)
+		{
+			// Multiple incoming function calls only count as one for convergence purposes.
+			saw_function_call_already = true;
+		}
+	}
+
+	return i;
+}
+
+long filtered_out_degree(ControlFlowGraph::vertex_descriptor v)
+{
+	StatementBase::out_edge_iterator eit, eend;
+
+	v->OutEdges(&eit, &eend);
+
+	long i = 0;
+	for (; eit != eend; ++eit)
+	{
+		if ((*eit)->IsBackEdge())
+		{
+			// Skip anything marked as a back edge.
+			continue;
+		}
+		i++;
+	}
+	return i;
+}
+
+ControlFlowGraph::edge_descriptor first_filtered_out_edge(ControlFlowGraph::vertex_descriptor v)
+{
+	StatementBase::out_edge_iterator eit, eend;
+
+	v->OutEdges(&eit, &eend);
+
+	bool saw_function_call_already = false;
+	for (; eit != eend; ++eit)
+	{
+		if ((*eit)->IsBackEdge())
+		{
+			// Always skip anything marked as a back edge.
+			continue;
+		}
+
+		// Same filtering as filtered_in_degree().
+		if ((dynamic_cast<CFGEdgeTypeReturn*>(*eit) == NULL)
+				&& (saw_function_call_already == false))
+		{
+			return *eit;
+		}
+
+		if (dynamic_cast<CFGEdgeTypeFunctionCall*>(*eit)
+				!= NULL)
+		{
+			saw_function_call_already = true;
+		}
+	}
+
+	return ControlFlowGraph::edge_descriptor(NULL);
+}
+
+
+FilteredDegreeCache::FilteredDegreeCache()
+{
+}
+
+FilteredDegreeCache::~FilteredDegreeCache()
+{
+}
+
+void FilteredDegreeCache::Compute(const ControlFlowGraph &cfg)
+{
+	DegreeInfo not_computed = { -1, 0, NULL };
+
+	m_entries.assign(cfg.GetVertexIndexUpperBound(), not_computed);
+
+	ControlFlowGraph::vertex_iterator vit, vend;
+	boost::tie(vit, vend) = vertices(cfg);
+	for(; vit != vend; ++vit)
+	{
+		Update(*vit);
+	}
+}
+
+void FilteredDegreeCache::Update(ControlFlowGraph::vertex_descriptor v)
+{
+	if(v->GetIndex() >= m_entries.size())
+	{
+		DegreeInfo not_computed = { -1, 0, NULL };
+		m_entries.resize(v->GetIndex()+1, not_computed);
+	}
+
+	DegreeInfo &info = m_entries[v->GetIndex()];
+	info.m_in_degree = filtered_in_degree(v);
+	info.m_out_degree = filtered_out_degree(v);
+	info.m_first_out_edge = first_filtered_out_edge(v);
+}
+
+long FilteredDegreeCache::InDegree(ControlFlowGraph::vertex_descriptor v) const
+{
+	const DegreeInfo *info = Lookup(v);
+	return (info != NULL) ? info->m_in_degree : filtered_in_degree(v);
+}
+
+long FilteredDegreeCache::OutDegree(ControlFlowGraph::vertex_descriptor v) const
+{
+	const DegreeInfo *info = Lookup(v);
+	return (info != NULL) ? info->m_out_degree : filtered_out_degree(v);
+}
+
+ControlFlowGraph::edge_descriptor FilteredDegreeCache::FirstOutEdge(ControlFlowGraph::vertex_descriptor v) const
+{
+	const DegreeInfo *info = Lookup(v);
+	return (info != NULL) ? info->m_first_out_edge : first_filtered_out_edge(v);
+}
+
+const FilteredDegreeCache::DegreeInfo* FilteredDegreeCache::Lookup(ControlFlowGraph::vertex_descriptor v) const
+{
+	if((v->GetIndex() < m_entries.size()) && (m_entries[v->GetIndex()].m_in_degree != -1))
+	{
+		return &m_entries[v->GetIndex()];
+	}
+
+	return NULL;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#ifndef FILTEREDDEGREECACHE_H_
+#define FILTEREDDEGREECACHE_H_
+
+#include <vector>
+
+#include "ControlFlowGraph.h"
+
+/**
+ * Compute the number of in edges of @a v, ignoring back edges, Return edges, and all but the
+ * first FunctionCall edge.
+ *
+ * @param v  The vertex to examine.
+ * @param only_decision_predecessors  If true, only count edges whose source is a decision statement.
+ * @return The filtered in degree of @a v.
+ */
+long filtered_in_degree(ControlFlowGraph::vertex_descriptor v, bool only_decision_predecessors = false);
+
+/**
+ * Compute the number of out edges of @a v which aren't back edges.
+ */
+long filtered_out_degree(ControlFlowGraph::vertex_descriptor v);
+
+/**
+ * Find the first out edge of @a v which would be counted by filtered_in_degree() at its target.
+ *
+ * @return The edge, or NULL if @a v has no such out edge.
+ */
+ControlFlowGraph::edge_descriptor first_filtered_out_edge(ControlFlowGraph::vertex_descriptor v);
+
+/**
+ * Dense per-Graph cache of the filtered in degree, filtered out degree, and first filtered out edge of each vertex.
+ *
+ * The filtered_*() functions above walk the edge lists of a vertex with a dynamic_cast or two per edge.  Since the
+ * traversals which need these values visit each vertex at least once, and the values don't change after the control
+ * flow graph is built and linked, it's much cheaper to compute them all once and look them up by Vertex index.
+ */
+class FilteredDegreeCache
+{
+public:
+	FilteredDegreeCache();
+	~FilteredDegreeCache();
+
+	/**
+	 * Compute and cache the filtered degrees of every vertex in @a cfg.
+	 *
+	 * @param cfg  The ControlFlowGraph to compute the degrees of.
+	 */
+	void Compute(const ControlFlowGraph &cfg);
+
+	/**
+	 * Recompute the cached values of a single vertex, e.g. after an edge has been added to it.
+	 * The vertex may have been added to the graph after the last call to Compute().
+	 *
+	 * @param v  The vertex to recompute.
+	 */
+	void Update(ControlFlowGraph::vertex_descriptor v);
+
+	/// @name Cache lookups.
+	/// If @a v hasn't been cached, these fall back to computing the value directly.
+	//@{
+	long InDegree(ControlFlowGraph::vertex_descriptor v) const;
+	long OutDegree(ControlFlowGraph::vertex_descriptor v) const;
+	ControlFlowGraph::edge_descriptor FirstOutEdge(ControlFlowGraph::vertex_descriptor v) const;
+	//@}
+
+private:
+
+	/**
+	 * The cached values for one vertex.
+	 */
+	struct DegreeInfo
+	{
+		/// The filtered in degree, or -1 if this entry hasn't been computed.
+		long m_in_degree;
+		long m_out_degree;
+		ControlFlowGraph::edge_descriptor m_first_out_edge;
+	};
+
+	const DegreeInfo* Lookup(ControlFlowGraph::vertex_descriptor v) const;
+
+	/// The cache, indexed by Vertex::GetIndex().
+	std::vector<DegreeInfo> m_entries;
+};
+
+#endif /* FILTEREDDEGREECACHE_H_ */
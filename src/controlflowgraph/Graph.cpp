@@ -30,6 +30,8 @@ Graph::Graph()
 {
 	// Initialize the vertex_index generator.
 	InitVertexIDGenerator();
+
+	m_modification_count = 0;
 }
 
 Graph::~Graph()
@@ -49,11 +51,13 @@ void Graph::AddVertex(Vertex* v)
 		// Either way, we'll throw an exception.
 		BOOST_THROW_EXCEPTION( duplicate_add() );
 	}
+	m_modification_count++;
 }
 
 void Graph::RemoveVertex(Vertex* v)
 {
 	m_vertices.erase(v);
+	m_modification_count++;
 }
 
 void Graph::ReplaceVertex(Vertex* old_vertex, Vertex* new_vertex)
@@ -74,6 +78,7 @@ void Graph::AddEdge(Vertex *source, Vertex *target, Edge* e)
 	target->AddInEdge(e);
 	e->SetSourceAndTarget(source, target);
 	m_edges.insert(e);
+	m_modification_count++;
 }
 
 void Graph::RemoveEdge(Edge* e)
@@ -82,6 +87,7 @@ void Graph::RemoveEdge(Edge* e)
 	e->Target()->RemoveInEdge(e);
 	e->ClearSourceAndTarget();
 	m_edges.erase(e);
+	m_modification_count++;
 }
 
 void Graph::Vertices(std::pair<Graph::vertex_iterator, Graph::vertex_iterator> *iterator_pair) const
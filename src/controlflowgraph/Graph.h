@@ -219,7 +219,25 @@ public:
 	virtual void Vertices(std::pair<Graph::vertex_iterator, Graph::vertex_iterator> *iterator_pair) const;
 	vertices_size_type NumVertices() const { return m_vertices.size(); };
 
+	/**
+	 * Return a value which is strictly greater than the index of any Vertex ever added to this Graph.
+	 * Vertex indexes are never reused, so after vertex removals this may be larger than NumVertices().
+	 * Use this to size dense arrays indexed by Vertex::GetIndex().
+	 *
+	 * @return One more than the largest Vertex index assigned by this Graph.
+	 */
+	vertex_index_type GetVertexIndexUpperBound() const { return m_vertex_id_state; };
+
 	Graph::edges_size_type NumEdges() const { return m_edges.size(); };
+
+	/**
+	 * Return the number of structural changes (vertex or edge additions or removals) made to this Graph so far.
+	 * Caches of information derived from the Graph can compare this with the value at the time they were computed
+	 * to tell whether they're stale.
+	 *
+	 * @return The modification count of this Graph.
+	 */
+	unsigned long GetModificationCount() const { return m_modification_count; };
 	Graph::edge_iterator EdgeListBegin() const;
 	Graph::edge_iterator EdgeListEnd() const;
 
@@ -257,6 +275,9 @@ protected:
 
 	/// The Vertex ID generator state.
 	VertexID m_vertex_id_state;
+
+	/// Count of vertex and edge additions and removals.
+	unsigned long m_modification_count;
 };
 
 
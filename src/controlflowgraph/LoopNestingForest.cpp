@@ -0,0 +1,369 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "LoopNestingForest.h"
+
+#include <boost/tuple/tuple.hpp>
+
+#include "edges/edge_types.h"
+
+/**
+ * A frame of the iterative depth-first search in LoopNestingForest::Search().
+ */
+struct LoopSearchFrame
+{
+	ControlFlowGraph::vertex_descriptor m_v;
+	std::vector<ControlFlowGraph::edge_descriptor> m_out_edges;
+	std::size_t m_next;
+};
+
+/**
+ * Push a search frame for @a v onto @a stack, collecting its intraprocedural out edges.
+ */
+static void push_loop_search_frame(std::vector<LoopSearchFrame> *stack, ControlFlowGraph::vertex_descriptor v)
+{
+	stack->push_back(LoopSearchFrame());
+	LoopSearchFrame &frame = stack->back();
+	frame.m_v = v;
+	frame.m_next = 0;
+
+	StatementBase::out_edge_iterator eit, eend;
+	v->OutEdges(&eit, &eend);
+	for(; eit != eend; ++eit)
+	{
+		if((dynamic_cast<CFGEdgeTypeFunctionCall*>(*eit) == NULL) && (dynamic_cast<CFGEdgeTypeReturn*>(*eit) == NULL))
+		{
+			frame.m_out_edges.push_back(*eit);
+		}
+	}
+}
+
+const LoopNestingForest::loop_index_type LoopNestingForest::NO_LOOP;
+
+LoopNestingForest::LoopNestingForest()
+{
+}
+
+LoopNestingForest::~LoopNestingForest()
+{
+}
+
+void LoopNestingForest::Compute(const ControlFlowGraph &cfg, ControlFlowGraph::vertex_descriptor entry)
+{
+	std::size_t num_indices = cfg.GetVertexIndexUpperBound();
+
+	m_traversed.assign(num_indices, 0);
+	m_path_position.assign(num_indices, 0);
+	m_innermost_header.assign(num_indices, ControlFlowGraph::vertex_descriptor(NULL));
+	m_is_header.assign(num_indices, 0);
+	m_is_irreducible.assign(num_indices, 0);
+	m_tree_edge.assign(num_indices, ControlFlowGraph::edge_descriptor(NULL));
+	m_preorder.clear();
+	m_back_edges.clear();
+
+	Search(entry);
+
+	// Pick up anything not reachable from the entry vertex, e.g. dead code.
+	ControlFlowGraph::vertex_iterator vit, vend;
+	boost::tie(vit, vend) = vertices(cfg);
+	for(; vit != vend; ++vit)
+	{
+		if(m_traversed[(*vit)->GetIndex()] == 0)
+		{
+			Search(*vit);
+		}
+	}
+
+	BuildLoops();
+
+	// The path positions and the preorder are only needed during the search.
+	m_path_position.clear();
+	m_preorder.clear();
+}
+
+ControlFlowGraph::edge_descriptor LoopNestingForest::GetDFSTreeEdge(ControlFlowGraph::vertex_descriptor v) const
+{
+	if(v->GetIndex() >= m_tree_edge.size())
+	{
+		return NULL;
+	}
+
+	return m_tree_edge[v->GetIndex()];
+}
+
+LoopNestingForest::loop_index_type LoopNestingForest::GetInnermostLoop(ControlFlowGraph::vertex_descriptor v) const
+{
+	if(v->GetIndex() >= m_innermost_loop.size())
+	{
+		return NO_LOOP;
+	}
+
+	return m_innermost_loop[v->GetIndex()];
+}
+
+long LoopNestingForest::GetLoopDepth(ControlFlowGraph::vertex_descriptor v) const
+{
+	loop_index_type l = GetInnermostLoop(v);
+
+	return (l == NO_LOOP) ? 0 : m_loops[l].m_depth;
+}
+
+bool LoopNestingForest::IsLoopHeader(ControlFlowGraph::vertex_descriptor v) const
+{
+	loop_index_type l = GetInnermostLoop(v);
+
+	return (l != NO_LOOP) && (m_loops[l].m_header == v);
+}
+
+bool LoopNestingForest::IsInLoop(ControlFlowGraph::vertex_descriptor v, loop_index_type l) const
+{
+	loop_index_type vl = GetInnermostLoop(v);
+
+	if(vl == NO_LOOP)
+	{
+		return false;
+	}
+
+	// v is in l iff v's innermost loop is in l's subtree of the loop forest.
+	return (m_loop_pre[l] <= m_loop_pre[vl]) && (m_loop_pre[vl] <= m_loop_last[l]);
+}
+
+void LoopNestingForest::GetLoopBody(const ControlFlowGraph &cfg, loop_index_type l,
+		std::vector<ControlFlowGraph::vertex_descriptor> *body) const
+{
+	ControlFlowGraph::vertex_iterator vit, vend;
+	boost::tie(vit, vend) = vertices(cfg);
+	for(; vit != vend; ++vit)
+	{
+		if(IsInLoop(*vit, l))
+		{
+			body->push_back(*vit);
+		}
+	}
+}
+
+void LoopNestingForest::TagLoopHeader(ControlFlowGraph::vertex_descriptor b, ControlFlowGraph::vertex_descriptor h)
+{
+	if((b == h) || (h == NULL))
+	{
+		return;
+	}
+
+	ControlFlowGraph::vertex_descriptor cur1 = b;
+	ControlFlowGraph::vertex_descriptor cur2 = h;
+	while(m_innermost_header[cur1->GetIndex()] != NULL)
+	{
+		ControlFlowGraph::vertex_descriptor ih = m_innermost_header[cur1->GetIndex()];
+		if(ih == cur2)
+		{
+			return;
+		}
+
+		if(m_path_position[ih->GetIndex()] < m_path_position[cur2->GetIndex()])
+		{
+			// cur2 is nested inside ih.  Splice it into the chain.
+			m_innermost_header[cur1->GetIndex()] = cur2;
+			cur1 = cur2;
+			cur2 = ih;
+		}
+		else
+		{
+			cur1 = ih;
+		}
+	}
+	m_innermost_header[cur1->GetIndex()] = cur2;
+}
+
+void LoopNestingForest::Search(ControlFlowGraph::vertex_descriptor root)
+{
+	std::vector<LoopSearchFrame> stack;
+
+	m_traversed[root->GetIndex()] = 1;
+	m_preorder.push_back(root);
+	push_loop_search_frame(&stack, root);
+	m_path_position[root->GetIndex()] = stack.size();
+
+	while(!stack.empty())
+	{
+		LoopSearchFrame &top = stack.back();
+		ControlFlowGraph::vertex_descriptor v = top.m_v;
+
+		if(top.m_next == top.m_out_edges.size())
+		{
+			// Done with v.  Take it off the path, and pass its innermost header up to its parent.
+			m_path_position[v->GetIndex()] = 0;
+			stack.pop_back();
+			if(!stack.empty())
+			{
+				TagLoopHeader(stack.back().m_v, m_innermost_header[v->GetIndex()]);
+			}
+			continue;
+		}
+
+		ControlFlowGraph::edge_descriptor e = top.m_out_edges[top.m_next];
+		top.m_next++;
+		ControlFlowGraph::vertex_descriptor b = e->Target();
+
+		if(m_traversed[b->GetIndex()] == 0)
+		{
+			// Tree edge.
+			m_traversed[b->GetIndex()] = 1;
+			m_tree_edge[b->GetIndex()] = e;
+			m_preorder.push_back(b);
+			push_loop_search_frame(&stack, b);
+			m_path_position[b->GetIndex()] = stack.size();
+		}
+		else if(m_path_position[b->GetIndex()] > 0)
+		{
+			// b is on the current path, so this is a back edge and b is a loop header.
+			m_back_edges.push_back(e);
+			if(!e->IsImpossible())
+			{
+				m_is_header[b->GetIndex()] = 1;
+				TagLoopHeader(v, b);
+			}
+		}
+		else if(m_innermost_header[b->GetIndex()] != NULL)
+		{
+			// b has already been fully searched and is in a loop.
+			ControlFlowGraph::vertex_descriptor h = m_innermost_header[b->GetIndex()];
+			if(m_path_position[h->GetIndex()] > 0)
+			{
+				// We're inside that loop too.
+				TagLoopHeader(v, h);
+			}
+			else
+			{
+				// We're entering h's loop somewhere other than its header, so it's irreducible.  Walk out until we
+				// find an enclosing loop we're in, marking each loop on the way irreducible too.
+				m_is_irreducible[h->GetIndex()] = 1;
+				while(m_innermost_header[h->GetIndex()] != NULL)
+				{
+					h = m_innermost_header[h->GetIndex()];
+					if(m_path_position[h->GetIndex()] > 0)
+					{
+						TagLoopHeader(v, h);
+						break;
+					}
+					m_is_irreducible[h->GetIndex()] = 1;
+				}
+			}
+		}
+	}
+}
+
+void LoopNestingForest::BuildLoops()
+{
+	m_loops.clear();
+	m_innermost_loop.assign(m_traversed.size(), NO_LOOP);
+
+	// Create the loops in search preorder, so every loop comes after the loops enclosing it.
+	for(std::size_t i = 0; i < m_preorder.size(); ++i)
+	{
+		ControlFlowGraph::vertex_descriptor h = m_preorder[i];
+		if(m_is_header[h->GetIndex()] == 0)
+		{
+			continue;
+		}
+
+		Loop loop;
+		loop.m_header = h;
+		loop.m_parent = NO_LOOP;
+		loop.m_depth = 1;
+		loop.m_is_reducible = (m_is_irreducible[h->GetIndex()] == 0);
+		loop.m_num_vertices = 0;
+		m_innermost_loop[h->GetIndex()] = m_loops.size();
+		m_loops.push_back(loop);
+	}
+
+	for(std::size_t l = 0; l < m_loops.size(); ++l)
+	{
+		ControlFlowGraph::vertex_descriptor parent_header = m_innermost_header[m_loops[l].m_header->GetIndex()];
+		if(parent_header != NULL)
+		{
+			m_loops[l].m_parent = m_innermost_loop[parent_header->GetIndex()];
+			m_loops[l].m_depth = m_loops[m_loops[l].m_parent].m_depth + 1;
+		}
+	}
+
+	// Now the vertices which aren't headers.
+	for(std::size_t i = 0; i < m_preorder.size(); ++i)
+	{
+		ControlFlowGraph::vertex_descriptor v = m_preorder[i];
+		if((m_is_header[v->GetIndex()] == 0) && (m_innermost_header[v->GetIndex()] != NULL))
+		{
+			m_innermost_loop[v->GetIndex()] = m_innermost_loop[m_innermost_header[v->GetIndex()]->GetIndex()];
+		}
+	}
+
+	// Count the vertices of each loop, adding the nested loops' counts to their parents.  Children always come
+	// after their parents, so a reverse walk sees each loop's full count before passing it up.
+	for(std::size_t i = 0; i < m_preorder.size(); ++i)
+	{
+		loop_index_type l = m_innermost_loop[m_preorder[i]->GetIndex()];
+		if(l != NO_LOOP)
+		{
+			m_loops[l].m_num_vertices++;
+		}
+	}
+	for(loop_index_type l = m_loops.size() - 1; l >= 0; --l)
+	{
+		if(m_loops[l].m_parent != NO_LOOP)
+		{
+			m_loops[m_loops[l].m_parent].m_num_vertices += m_loops[l].m_num_vertices;
+		}
+	}
+
+	// Number the loop forest in preorder, and record the last number in each loop's subtree.
+	std::vector< std::vector<loop_index_type> > children(m_loops.size());
+	std::vector<loop_index_type> stack;
+	for(loop_index_type l = m_loops.size() - 1; l >= 0; --l)
+	{
+		// Push in reverse so the loops come off the stack in order.
+		if(m_loops[l].m_parent == NO_LOOP)
+		{
+			stack.push_back(l);
+		}
+		else
+		{
+			children[m_loops[l].m_parent].push_back(l);
+		}
+	}
+
+	m_loop_pre.assign(m_loops.size(), -1);
+	m_loop_last.assign(m_loops.size(), -1);
+	long next_pre = 0;
+	while(!stack.empty())
+	{
+		loop_index_type l = stack.back();
+
+		if(m_loop_pre[l] == -1)
+		{
+			// First visit.  Leave l on the stack underneath its children.
+			m_loop_pre[l] = next_pre++;
+			stack.insert(stack.end(), children[l].begin(), children[l].end());
+		}
+		else
+		{
+			// Back from the children.
+			m_loop_last[l] = next_pre - 1;
+			stack.pop_back();
+		}
+	}
+}
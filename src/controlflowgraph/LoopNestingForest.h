@@ -0,0 +1,186 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#ifndef LOOPNESTINGFOREST_H_
+#define LOOPNESTINGFOREST_H_
+
+#include <vector>
+
+#include "ControlFlowGraph.h"
+
+/**
+ * The loops of a single Function's ControlFlowGraph and how they nest.
+ *
+ * The forest is found with one iterative depth-first search, using the algorithm of Wei, Mao, Zou and Chen ("A New
+ * Algorithm for Identifying Loops in Decompilation").  Each vertex is tagged with the header of the innermost loop
+ * containing it while the search unwinds, and loops which can be entered other than through their header are marked
+ * irreducible.  The back edges of the search come out as a by-product.
+ *
+ * Only intraprocedural edges are followed.  Back edges which are Impossible, e.g. the self edges of the Entry and
+ * Exit vertices, are reported as back edges but don't form loops.
+ */
+class LoopNestingForest
+{
+public:
+
+	/// Index of a loop in the forest.
+	typedef long loop_index_type;
+
+	/// Loop index value meaning "not in any loop".
+	static const loop_index_type NO_LOOP = -1;
+
+	/**
+	 * A single loop.
+	 */
+	struct Loop
+	{
+		/// The loop header.  For an irreducible loop, this is the entry the search happened to find first.
+		ControlFlowGraph::vertex_descriptor m_header;
+
+		/// The innermost loop enclosing this one, or NO_LOOP if this is an outermost loop.
+		loop_index_type m_parent;
+
+		/// Nesting depth.  Outermost loops have depth 1.
+		long m_depth;
+
+		/// false if the loop has more than one entry.
+		bool m_is_reducible;
+
+		/// Number of vertices in the loop, including those of any nested loops.
+		long m_num_vertices;
+	};
+
+	LoopNestingForest();
+	~LoopNestingForest();
+
+	/**
+	 * Find the loops of @a cfg.
+	 *
+	 * The search starts at @a entry, then continues from any vertices not reachable from it.
+	 *
+	 * @param cfg  The ControlFlowGraph to analyze.
+	 * @param entry  The Entry vertex of @a cfg.
+	 */
+	void Compute(const ControlFlowGraph &cfg, ControlFlowGraph::vertex_descriptor entry);
+
+	/**
+	 * @return The back edges found by the last Compute(), in the order the search found them.
+	 */
+	const std::vector<ControlFlowGraph::edge_descriptor>& GetBackEdges() const { return m_back_edges; };
+
+	/**
+	 * @return The edge by which the depth-first search first reached @a v, or NULL for the vertices it started from.
+	 * Only valid until the next change to the graph's edges.
+	 */
+	ControlFlowGraph::edge_descriptor GetDFSTreeEdge(ControlFlowGraph::vertex_descriptor v) const;
+
+	/// @name Loop queries.
+	//@{
+	std::size_t NumLoops() const { return m_loops.size(); };
+	const Loop& GetLoop(loop_index_type l) const { return m_loops[l]; };
+
+	/**
+	 * @return The innermost loop containing @a v, or NO_LOOP.  A loop header is in its own loop.
+	 */
+	loop_index_type GetInnermostLoop(ControlFlowGraph::vertex_descriptor v) const;
+
+	/**
+	 * @return The number of loops containing @a v.
+	 */
+	long GetLoopDepth(ControlFlowGraph::vertex_descriptor v) const;
+
+	/**
+	 * @return true if @a v is the header of a loop.
+	 */
+	bool IsLoopHeader(ControlFlowGraph::vertex_descriptor v) const;
+
+	/**
+	 * @return true if @a v is in loop @a l, or in a loop nested within it.
+	 */
+	bool IsInLoop(ControlFlowGraph::vertex_descriptor v, loop_index_type l) const;
+
+	/**
+	 * Collect the vertices of loop @a l, including those of loops nested within it.
+	 *
+	 * @param cfg  The ControlFlowGraph the forest was computed for.
+	 * @param l  The loop.
+	 * @param[out] body  The vertices are appended to this list.
+	 */
+	void GetLoopBody(const ControlFlowGraph &cfg, loop_index_type l, std::vector<ControlFlowGraph::vertex_descriptor> *body) const;
+	//@}
+
+private:
+
+	/**
+	 * Record @a h as a loop header enclosing @a b, merging it into @a b's chain of enclosing headers so that
+	 * the chain stays ordered by depth-first search path position.
+	 */
+	void TagLoopHeader(ControlFlowGraph::vertex_descriptor b, ControlFlowGraph::vertex_descriptor h);
+
+	/**
+	 * Search from @a root, which hasn't been visited yet.
+	 */
+	void Search(ControlFlowGraph::vertex_descriptor root);
+
+	/**
+	 * Turn the per-vertex header tags into the Loop list and number the loops for the membership queries.
+	 */
+	void BuildLoops();
+
+	/// @name Per-vertex search state, indexed by Vertex::GetIndex().
+	//@{
+
+	/// Non-zero once the search has reached the vertex.
+	std::vector<char> m_traversed;
+
+	/// 1-based position of the vertex on the current search path, or 0 if it isn't on the path.
+	std::vector<long> m_path_position;
+
+	/// The header of the innermost loop containing the vertex, not counting its own loop if it's a header.
+	std::vector<ControlFlowGraph::vertex_descriptor> m_innermost_header;
+
+	/// Non-zero if the vertex is a loop header.
+	std::vector<char> m_is_header;
+
+	/// Non-zero if the vertex is the header of an irreducible loop.
+	std::vector<char> m_is_irreducible;
+
+	/// See GetDFSTreeEdge().
+	std::vector<ControlFlowGraph::edge_descriptor> m_tree_edge;
+
+	/// The loop each vertex is innermost in, or NO_LOOP.
+	std::vector<loop_index_type> m_innermost_loop;
+
+	//@}
+
+	/// Vertices in the order the search first reached them.  Only kept during Compute().
+	std::vector<ControlFlowGraph::vertex_descriptor> m_preorder;
+
+	std::vector<ControlFlowGraph::edge_descriptor> m_back_edges;
+
+	std::vector<Loop> m_loops;
+
+	/// @name Preorder interval of each loop in the loop forest, indexed by loop.
+	//@{
+	std::vector<long> m_loop_pre;
+	std::vector<long> m_loop_last;
+	//@}
+};
+
+#endif /* LOOPNESTINGFOREST_H_ */
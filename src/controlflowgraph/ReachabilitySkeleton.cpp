@@ -0,0 +1,169 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "ReachabilitySkeleton.h"
+
+#include <algorithm>
+
+#include <boost/foreach.hpp>
+
+#include "BasicBlockGraph.h"
+#include "edges/CFGEdgeTypeBase.h"
+
+const std::vector<ControlFlowGraph::vertex_descriptor> ReachabilitySkeleton::m_no_successors;
+
+/**
+ * Push the successors of @a block which haven't been visited by search @a search onto @a stack, skipping Back and
+ * Impossible edges.
+ */
+static void push_successor_blocks(const BasicBlockGraph::BasicBlock &block, long search, std::vector<long> *visited_by,
+		std::vector<BasicBlockGraph::block_index_type> *stack)
+{
+	BOOST_FOREACH(const BasicBlockGraph::BlockEdge &be, block.m_succs)
+	{
+		if(be.m_edge->IsBackEdge() || be.m_edge->IsImpossible() || ((*visited_by)[be.m_other_block] == search))
+		{
+			continue;
+		}
+
+		(*visited_by)[be.m_other_block] = search;
+		stack->push_back(be.m_other_block);
+	}
+}
+
+ReachabilitySkeleton::ReachabilitySkeleton()
+{
+	m_num_edges = 0;
+}
+
+ReachabilitySkeleton::~ReachabilitySkeleton()
+{
+}
+
+void ReachabilitySkeleton::Build(const ControlFlowGraph &cfg, const BasicBlockGraph &blocks,
+		ControlFlowGraph::vertex_descriptor exit)
+{
+	m_vertices.clear();
+	m_successors.clear();
+	m_num_edges = 0;
+	m_skeleton_index_of.assign(cfg.GetVertexIndexUpperBound(), -1);
+
+	if(blocks.NumBlocks() == 0)
+	{
+		return;
+	}
+
+	// The vertices are Entry, which leads the entry block, the FunctionCalls, and Exit.
+	AddVertex(blocks.GetBlock(blocks.GetEntryBlock()).GetLeader());
+	for(BasicBlockGraph::block_index_type b = 0; b < static_cast<BasicBlockGraph::block_index_type>(blocks.NumBlocks()); ++b)
+	{
+		const BasicBlockGraph::BasicBlock &block = blocks.GetBlock(b);
+		BOOST_FOREACH(std::size_t position, block.m_function_calls)
+		{
+			AddVertex(block.m_statements[position]);
+		}
+	}
+	if(blocks.GetBlockIndex(exit) != BasicBlockGraph::NO_BLOCK)
+	{
+		AddVertex(exit);
+	}
+
+	// For each vertex, find the skeleton vertices reachable from it without passing through another FunctionCall.
+	// The searches stop at the first FunctionCall in each block, so they don't go far.  The blocks are marked with the
+	// index of the vertex whose search visited them, so the marks never need to be cleared.
+	std::vector<long> visited_by(blocks.NumBlocks(), -1);
+	std::vector<BasicBlockGraph::block_index_type> stack;
+
+	for(std::size_t i = 0; i < m_vertices.size(); ++i)
+	{
+		ControlFlowGraph::vertex_descriptor v = m_vertices[i];
+		std::vector<ControlFlowGraph::vertex_descriptor> &successors = m_successors[i];
+
+		if(v == exit)
+		{
+			// Nothing follows Exit.
+			continue;
+		}
+
+		BasicBlockGraph::block_index_type b = blocks.GetBlockIndex(v);
+		const BasicBlockGraph::BasicBlock &block = blocks.GetBlock(b);
+
+		// If there's another call after v in its own block, that's the only successor.
+		std::vector<std::size_t>::const_iterator next_call = std::upper_bound(block.m_function_calls.begin(),
+				block.m_function_calls.end(), blocks.GetPositionInBlock(v));
+		if(next_call != block.m_function_calls.end())
+		{
+			successors.push_back(block.m_statements[*next_call]);
+		}
+		else if(block.GetLastStatement() == exit)
+		{
+			successors.push_back(exit);
+		}
+		else
+		{
+			// Otherwise, carry on from the end of v's block.
+			push_successor_blocks(block, i, &visited_by, &stack);
+		}
+
+		while(!stack.empty())
+		{
+			const BasicBlockGraph::BasicBlock &cblock = blocks.GetBlock(stack.back());
+			stack.pop_back();
+
+			if(!cblock.m_function_calls.empty())
+			{
+				// The first call in the block is as far as we go.
+				successors.push_back(cblock.m_statements[cblock.m_function_calls.front()]);
+			}
+			else if(cblock.GetLastStatement() == exit)
+			{
+				successors.push_back(exit);
+			}
+			else
+			{
+				push_successor_blocks(cblock, i, &visited_by, &stack);
+			}
+		}
+
+		m_num_edges += successors.size();
+	}
+}
+
+bool ReachabilitySkeleton::IsSkeletonVertex(ControlFlowGraph::vertex_descriptor v) const
+{
+	return (v->GetIndex() < m_skeleton_index_of.size()) && (m_skeleton_index_of[v->GetIndex()] != -1);
+}
+
+const std::vector<ControlFlowGraph::vertex_descriptor>& ReachabilitySkeleton::GetSuccessors(
+		ControlFlowGraph::vertex_descriptor v) const
+{
+	if(!IsSkeletonVertex(v))
+	{
+		return m_no_successors;
+	}
+
+	return m_successors[m_skeleton_index_of[v->GetIndex()]];
+}
+
+void ReachabilitySkeleton::AddVertex(ControlFlowGraph::vertex_descriptor v)
+{
+	m_skeleton_index_of[v->GetIndex()] = m_vertices.size();
+	m_vertices.push_back(v);
+	m_successors.push_back(std::vector<ControlFlowGraph::vertex_descriptor>());
+}
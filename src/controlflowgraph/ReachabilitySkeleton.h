@@ -0,0 +1,99 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#ifndef REACHABILITYSKELETON_H_
+#define REACHABILITYSKELETON_H_
+
+#include <vector>
+
+#include "ControlFlowGraph.h"
+
+class BasicBlockGraph;
+
+/**
+ * Projection of a Function's ControlFlowGraph down to only the vertices which matter for call reachability.
+ *
+ * The vertices of the skeleton are the Entry vertex, the Exit vertex, and the FunctionCall statements.  There's an
+ * edge from skeleton vertex u to skeleton vertex v if v can be reached from u without passing through another
+ * FunctionCall.  As in shortest_witness_path(), Back and Impossible edges aren't followed.  Every path in the
+ * ControlFlowGraph from Entry through some sequence of calls has a corresponding path in the skeleton, so
+ * interprocedural reachability questions can be answered by searching the skeletons alone and descending at each
+ * resolved call into the callee's skeleton.
+ *
+ * The skeleton is built from the Function's BasicBlockGraph once the ControlFlowGraph is in its final form.  It only
+ * looks at intraprocedural edges, so it isn't affected by linking.
+ */
+class ReachabilitySkeleton
+{
+public:
+	ReachabilitySkeleton();
+	~ReachabilitySkeleton();
+
+	/**
+	 * Build the skeleton of the ControlFlowGraph underlying @a blocks, discarding any existing skeleton.
+	 *
+	 * @param cfg    The ControlFlowGraph @a blocks was built from.
+	 * @param blocks The basic blocks of @a cfg.
+	 * @param exit   The Exit vertex of @a cfg.
+	 */
+	void Build(const ControlFlowGraph &cfg, const BasicBlockGraph &blocks, ControlFlowGraph::vertex_descriptor exit);
+
+	/**
+	 * @return true if @a v is a vertex of the skeleton.
+	 */
+	bool IsSkeletonVertex(ControlFlowGraph::vertex_descriptor v) const;
+
+	/**
+	 * @return The skeleton vertices which can be reached from skeleton vertex @a v without passing through another
+	 *  FunctionCall.  Empty if @a v isn't a skeleton vertex.
+	 */
+	const std::vector<ControlFlowGraph::vertex_descriptor>& GetSuccessors(ControlFlowGraph::vertex_descriptor v) const;
+
+	/**
+	 * @return The skeleton vertices, Entry first.
+	 */
+	const std::vector<ControlFlowGraph::vertex_descriptor>& GetVertices() const { return m_vertices; };
+
+	/// @name Size of the skeleton.
+	//@{
+	std::size_t NumVertices() const { return m_vertices.size(); };
+	std::size_t NumEdges() const { return m_num_edges; };
+	//@}
+
+private:
+
+	/// Add @a v to the skeleton, with no successors yet.
+	void AddVertex(ControlFlowGraph::vertex_descriptor v);
+
+	/// The skeleton vertices, Entry first.
+	std::vector<ControlFlowGraph::vertex_descriptor> m_vertices;
+
+	/// The successors of each skeleton vertex, in the same order as m_vertices.
+	std::vector< std::vector<ControlFlowGraph::vertex_descriptor> > m_successors;
+
+	/// The position in m_vertices of each statement, or -1 if it isn't a skeleton vertex.  Indexed by Vertex::GetIndex().
+	std::vector<long> m_skeleton_index_of;
+
+	std::size_t m_num_edges;
+
+	/// Returned by GetSuccessors() for vertices not in the skeleton.
+	static const std::vector<ControlFlowGraph::vertex_descriptor> m_no_successors;
+};
+
+#endif /* REACHABILITYSKELETON_H_ */
@@ -27,69 +27,110 @@
 #include "../ControlFlowGraph.h"
 #include "../GraphAdapter.h"
 #include "../../Function.h"
-#include "../visitors/BackEdgeFixupVisitor.h"
+#include "../LoopNestingForest.h"
 #include "../edges/CFGEdgeTypeImpossible.h"
 
 
-void FixupBackEdges(ControlFlowGraph *g, ControlFlowGraph::vertex_descriptor entry)
+/**
+ * Search the depth-first search tree path from the source of back edge @a e up to its target for the first decision
+ * statement we can find, and return the target of one of its other out edges.  This is primarily for adding a "proxy"
+ * edge to replace the back edge for certain purposes, such as printing and searching the CFG.
+ *
+ * @todo Make sure the one we find actually is the one which breaks us out of the loop.
+ *
+ * @return The vertex found, or NULL if there's no decision statement on the path.
+ */
+static ControlFlowGraph::vertex_descriptor find_forward_target_for_back_edge(const LoopNestingForest &loops,
+		ControlFlowGraph::edge_descriptor e)
 {
-	// Check that BackEdgeFixupVisitor models DFSVisitorConcept.
-	BOOST_CONCEPT_ASSERT((boost::DFSVisitorConcept< BackEdgeFixupVisitor<ControlFlowGraph>, ControlFlowGraph >));
+	ControlFlowGraph::vertex_descriptor u = e->Source();
+	ControlFlowGraph::vertex_descriptor v = e->Target();
+	ControlFlowGraph::vertex_descriptor w;
 
-	// The vector we'll use to collect up all the info we need to fix up the graph's back edges.
-	std::vector<BackEdgeFixupVisitor<ControlFlowGraph>::BackEdgeFixupInfo> back_edges;
+	// Walk back up the path by which the search got here until we reach the target of the back edge.
+	// We're looking for a way out of the cycle.
+	do
+	{
+		// Get the tree edge into this vertex.
+		ControlFlowGraph::edge_descriptor tree_edge = loops.GetDFSTreeEdge(u);
+		if(tree_edge == NULL)
+		{
+			break;
+		}
+		w = tree_edge->Source();
 
-	// Define a visitor which will find all the back edges and send back the info
-	// we need to fix them up.
-	BackEdgeFixupVisitor<ControlFlowGraph> back_edge_finder(back_edges);
+		if(w->IsDecisionStatement())
+		{
+			// It's a decision statement, this might be the way out.  Take the first out edge other than the one
+			// we came down.
+			/// @todo Make this more robust.  As far as I know, this isn't guaranteed to be the right way out, or even *a* way out.
+			StatementBase::out_edge_iterator eit, eend;
+			w->OutEdges(&eit, &eend);
+			for(; eit != eend; ++eit)
+			{
+				if(*eit != tree_edge)
+				{
+					return (*eit)->Target();
+				}
+			}
+			break;
+		}
 
-	//typedef boost::color_traits<boost::default_color_type> T_COLOR;
-	typedef boost::default_color_type T_COLOR;
-	typedef std::map<ControlFlowGraph::vertex_descriptor, T_COLOR> T_COLORMAP;
-	T_COLORMAP color_map;
-	typedef boost::associative_property_map<T_COLORMAP> T_COLOR_PROPERTY_MAP;
-	T_COLOR_PROPERTY_MAP color_property_map(color_map);
+		// Otherwise, continue until we find a decision statement which might lead us out of here.
+		u = w;
+	} while(w != v);
 
-	// Check if the color_property_map fulfills the concept.
-	BOOST_CONCEPT_ASSERT((boost::ReadWritePropertyMapConcept< T_COLOR_PROPERTY_MAP, ControlFlowGraph::vertex_descriptor >));
+	return NULL;
+}
 
-	// Set the back_edge_finder visitor loose on the function's CFG, with its
-	// search strategy being a simple depth-first search.
-	// Locate all the back edges, and send the fix-up info back to the back_edges
-	// std::vector<> above.
-	boost::depth_first_search(*g, back_edge_finder, color_property_map, entry);
-	//boost::depth_first_search(g, boost::visitor(back_edge_finder));
+void FixupBackEdges(ControlFlowGraph *g, ControlFlowGraph::vertex_descriptor entry,
+		ControlFlowGraph::vertex_descriptor exit, LoopNestingForest *loops)
+{
+	// Find the loops, and with them the back edges.
+	loops->Compute(*g, entry);
 
+	const std::vector<ControlFlowGraph::edge_descriptor> &back_edges = loops->GetBackEdges();
 
-	dlog_cfg << "Number of back edges found: " << back_edges.size() << std::endl;
+	dlog_cfg << "Number of back edges found: " << back_edges.size() << ", loops found: " << loops->NumLoops() << std::endl;
+
+	// Find the Impossible edge targets before we start adding edges, which would invalidate the search tree.
+	std::vector<ControlFlowGraph::vertex_descriptor> impossible_targets(back_edges.size());
+	for(std::size_t i = 0; i < back_edges.size(); ++i)
+	{
+		ControlFlowGraph::edge_descriptor e = back_edges[i];
+		impossible_targets[i] = (e->Source() == e->Target()) ? NULL : find_forward_target_for_back_edge(*loops, e);
+	}
 
 	// Mark the edges we found as back edges.
-	BOOST_FOREACH(BackEdgeFixupVisitor<ControlFlowGraph>::BackEdgeFixupInfo fixinfo, back_edges)
+	for(std::size_t i = 0; i < back_edges.size(); ++i)
 	{
-		ControlFlowGraph::edge_descriptor e = fixinfo.m_back_edge;
+		ControlFlowGraph::edge_descriptor e = back_edges[i];
 
 		// Change this edge type to a back edge.
 		e->MarkAsBackEdge(true);
 
-		// Skip the rest if this is a self edge.
-		if(fixinfo.m_impossible_target_vertex == boost::graph_traits<ControlFlowGraph>::null_vertex())
+		// Skip the rest if this is one of the ENTRY and EXIT self edges, or the source has another way out.
+		ControlFlowGraph::vertex_descriptor src = e->Source();
+		if(e->IsImpossible() || (src->OutDegree() != 1))
 		{
-			dlog_cfg << "Self edge, no further action: " << e << std::endl;
+			dlog_cfg << "No further action: " << e << std::endl;
 			continue;
 		}
 
-		// If the source node of this back edge now has no non-back-edge out-edges,
-		// add a CFGEdgeTypeImpossible edge to it, so topological sorting works correctly.
-		ControlFlowGraph::vertex_descriptor src;
-		src = /*boost::*/source(e, *g);
-		if (/*boost::*/out_degree(src, *g) == 1)
+		// The source node of this back edge has no non-back-edge out-edges, so add a CFGEdgeTypeImpossible edge
+		// from it, so topological sorting works correctly.  If there's no decision statement in the loop which
+		// might lead out of it, it's an infinite loop, and the edge goes to EXIT, so EXIT still post-dominates
+		// every vertex of the function.
+		ControlFlowGraph::vertex_descriptor target = impossible_targets[i];
+		if(target == NULL)
 		{
-			g->AddEdge(src, fixinfo.m_impossible_target_vertex, new CFGEdgeTypeImpossible);
-
-			dlog_cfg << "Retargetting back edge " << e->GetIndex()
-					<< " to "
-					<< fixinfo.m_impossible_target_vertex->GetIndex() << std::endl;
+			target = exit;
 		}
+		g->AddEdge(src, target, new CFGEdgeTypeImpossible);
+
+		dlog_cfg << "Retargetting back edge " << e->GetIndex()
+				<< " to "
+				<< target->GetIndex() << std::endl;
 	}
 
 	dlog_cfg << "Back edge fixup complete." << std::endl;
@@ -299,74 +340,42 @@ void ControlFlowGraphBase::StructureCompoundConditionals(Function *f)
 }
 #endif
 
-void RemoveRedundantNodes(ControlFlowGraph *g)
+bool RemoveIfRedundant(ControlFlowGraph *g, ControlFlowGraph::vertex_descriptor v)
 {
-	// We'll collect up the vertices to be removed in this vector.
-	std::vector<typename boost::graph_traits<ControlFlowGraph>::vertex_descriptor> vertices_to_remove;
-
-	typename boost::graph_traits<ControlFlowGraph>::vertex_iterator it, it2;
-
-	boost::tie(it, it2) = vertices(*g);
-
-	// Iterate over all vertices.
-	for(;it != it2; ++it)
+	// A vertex with exactly one way in and one way out adds nothing to the graph.
+	if(in_degree(v, *g) != 1 || out_degree(v, *g) != 1)
 	{
-		StatementBase *sbp = *it;
-
-		if(sbp->IsType<Goto>() || (sbp->IsType<Label>() && (dynamic_cast<Label*>(sbp)->GetIdentifier())[0] == '<'))
-		{
-			// This is a Goto or a compiler-generated Label (i.e. "<D.1234>").  Check if it's redundant.
-			/// @todo Find a better way to handle the detection of compiler-generated Labels.
-			if(/*boost::*/in_degree(*it, *g)==1 && /*boost::*/out_degree(*it, *g)==1)
-			{
-				// It's redundant.
-
-				ControlFlowGraph::in_edge_iterator in_eit;
-				ControlFlowGraph::out_edge_iterator out_eit;
-				ControlFlowGraph::edge_descriptor in_edge, out_edge;
-
-				boost::tie(in_eit, boost::tuples::ignore) = /*boost::*/in_edges(*it, *g);
-				boost::tie(out_eit, boost::tuples::ignore) = /*boost::*/out_edges(*it, *g);
-				in_edge = *in_eit;
-				out_edge = *out_eit;
-
-				ControlFlowGraph::vertex_descriptor source_vertex_desc, target_vertex_desc;
-
-				// Get the vertex descriptors.
-				source_vertex_desc = /*boost::*/source(in_edge, *g);
-				target_vertex_desc = /*boost::*/target(out_edge, *g);
+		return false;
+	}
 
-				// Point the incoming edge to the target of our outgoing edge, bypassing us.
-				in_edge->ChangeTarget(target_vertex_desc);
+	ControlFlowGraph::in_edge_iterator in_eit;
+	ControlFlowGraph::out_edge_iterator out_eit;
+	ControlFlowGraph::edge_descriptor in_edge, out_edge;
 
-				// Remove our outgoing edge.
-				//g->RemoveEdge(out_edge);
-				remove_edge(out_edge, *g);
+	boost::tie(in_eit, boost::tuples::ignore) = in_edges(v, *g);
+	boost::tie(out_eit, boost::tuples::ignore) = out_edges(v, *g);
+	in_edge = *in_eit;
+	out_edge = *out_eit;
 
-				// We should now have no edges.
-				if(/*boost::*/in_degree(*it, *g) != 0 || out_degree(*it, *g))
-				{
-					std::cerr << "STILL HAS EDGES" << std::endl;
-				}
-				else
-				{
-					// Schedule this vertex to be deleted.
-					vertices_to_remove.push_back(*it);
-				}
-			}
-		}
+	// Point the incoming edge to the target of our outgoing edge, bypassing us.  This leaves the in and out
+	// degrees of every other vertex unchanged.
+	in_edge->ChangeTarget(target(out_edge, *g));
 
-	}
+	// Remove our outgoing edge.  Nothing else refers to it now, so delete it too.
+	remove_edge(out_edge, *g);
+	delete out_edge;
 
-	// Remove all the vertices we found.
-	BOOST_FOREACH(ControlFlowGraph::vertex_descriptor i, vertices_to_remove)
+	// We should now have no edges.
+	if(in_degree(v, *g) != 0 || out_degree(v, *g) != 0)
 	{
-		//g->RemoveVertex(i);
-		remove_vertex(i, *g);
-		delete i;
+		std::cerr << "STILL HAS EDGES" << std::endl;
+		return false;
 	}
 
-	dlog_cfg << "INFO: Redundant vertices removed: " << vertices_to_remove.size() << std::endl;
+	remove_vertex(v, *g);
+	delete v;
+
+	return true;
 }
 
 
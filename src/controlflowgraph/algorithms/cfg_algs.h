@@ -23,15 +23,23 @@
 #include "../ControlFlowGraph.h"
 
 class Function;
+class LoopNestingForest;
 
 /**
  * Traverses the ControlFlowGraph of the Function starting at the Vertex specified by @a entry
  * and marks all back edges as such.
  *
+ * The back edges are found by computing the loop nesting forest of the graph.  Where the source of a
+ * back edge has no other way out, an Impossible edge is added from it to a vertex outside the loop, or
+ * to @a exit if there's no decision statement in the loop which could lead out of it.
+ *
  * @param g Reference to the ControlFlowGraph to process.
  * @param entry  Descriptor of the Entry vertex to start at.
+ * @param exit  Descriptor of the Exit vertex.
+ * @param[out] loops  The LoopNestingForest to compute.
  */
-void FixupBackEdges(ControlFlowGraph *g, ControlFlowGraph::vertex_descriptor entry);
+void FixupBackEdges(ControlFlowGraph *g, ControlFlowGraph::vertex_descriptor entry,
+		ControlFlowGraph::vertex_descriptor exit, LoopNestingForest *loops);
 
 void InsertMergeNodes(Function *f);
 
@@ -39,6 +47,15 @@ void SplitCriticalEdges(Function *f);
 
 void StructureCompoundConditionals(Function *f);
 
-void RemoveRedundantNodes(ControlFlowGraph *g);
+/**
+ * Remove vertex @a v from @a g if it has exactly one in edge and one out edge, by retargeting its in edge to
+ * the target of its out edge.  The in and out degrees of all other vertices are left unchanged, so this can be
+ * applied to candidate vertices one at a time in any order.  Deletes @a v if it's removed.
+ *
+ * @param g  The ControlFlowGraph to remove @a v from.
+ * @param v  The candidate vertex.
+ * @return true if @a v was redundant and has been removed.
+ */
+bool RemoveIfRedundant(ControlFlowGraph *g, ControlFlowGraph::vertex_descriptor v);
 
 #endif // CFG_ALGS_H
@@ -0,0 +1,422 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "dataflow.h"
+
+#include <queue>
+#include <functional>
+
+#include <coflo_exceptions.hpp>
+
+#include "../edges/edge_types.h"
+#include "../statements/FunctionCall.h"
+#include "../../Function.h"
+
+
+DataflowProblem::DataflowProblem()
+{
+}
+
+DataflowProblem::~DataflowProblem()
+{
+}
+
+void DataflowProblem::GetBoundaryValue(bitset_type * /*boundary*/) const
+{
+	// By default nothing holds at the boundary.
+}
+
+
+/**
+ * A stack entry for the iterative depth-first search in DataflowSolver::NumberVertices().
+ */
+struct DataflowDFSFrame
+{
+	DataflowDFSFrame(ControlFlowGraph::vertex_descriptor v, ControlFlowGraph *cfg, long number)
+	{
+		m_cfg = cfg;
+		m_number = number;
+		v->OutEdges(&m_ei, &m_eend);
+	};
+
+	ControlFlowGraph *m_cfg;
+	long m_number;
+	StatementBase::out_edge_iterator m_ei;
+	StatementBase::out_edge_iterator m_eend;
+};
+
+/**
+ * Build compressed adjacency arrays from a list of (source, target) pairs.
+ */
+static void build_adjacency(std::size_t num_vertices, const std::vector< std::pair<long, long> > &edges,
+		bool reverse, std::vector<std::size_t> *offsets, std::vector<long> *adjacent)
+{
+	offsets->assign(num_vertices+1, 0);
+	adjacent->resize(edges.size());
+
+	// Count the edges of each vertex.
+	for(std::size_t i = 0; i < edges.size(); ++i)
+	{
+		long from = reverse ? edges[i].second : edges[i].first;
+		(*offsets)[from+1]++;
+	}
+
+	// Turn the counts into offsets.
+	for(std::size_t i = 0; i < num_vertices; ++i)
+	{
+		(*offsets)[i+1] += (*offsets)[i];
+	}
+
+	// Drop each edge into its slot.
+	std::vector<std::size_t> next(offsets->begin(), offsets->end()-1);
+	for(std::size_t i = 0; i < edges.size(); ++i)
+	{
+		long from = reverse ? edges[i].second : edges[i].first;
+		long to = reverse ? edges[i].first : edges[i].second;
+		(*adjacent)[next[from]++] = to;
+	}
+}
+
+
+DataflowSolver::DataflowSolver(const DataflowProblem &problem) : m_problem(problem)
+{
+	m_interprocedural = false;
+	m_num_transfers = 0;
+}
+
+DataflowSolver::~DataflowSolver()
+{
+}
+
+void DataflowSolver::Solve(ControlFlowGraph &cfg, ControlFlowGraph::vertex_descriptor entry,
+		ControlFlowGraph::vertex_descriptor exit)
+{
+	Clear();
+	m_interprocedural = false;
+	NumberVertices(&cfg, entry);
+	Iterate(entry, exit);
+}
+
+void DataflowSolver::SolveInterprocedural(const Function *root)
+{
+	Clear();
+	m_interprocedural = true;
+	NumberVertices(root->GetCFGPointer(), root->GetEntryVertexDescriptor());
+	Iterate(root->GetEntryVertexDescriptor(), root->GetExitVertexDescriptor());
+}
+
+bool DataflowSolver::IsInSolution(ControlFlowGraph::vertex_descriptor v) const
+{
+	return GetVertexNumber(v) != -1;
+}
+
+const DataflowSolver::bitset_type& DataflowSolver::GetIn(ControlFlowGraph::vertex_descriptor v) const
+{
+	long i = GetVertexNumber(v);
+	if(i == -1)
+	{
+		BOOST_THROW_EXCEPTION(vertex_not_found());
+	}
+	return m_in[i];
+}
+
+const DataflowSolver::bitset_type& DataflowSolver::GetOut(ControlFlowGraph::vertex_descriptor v) const
+{
+	long i = GetVertexNumber(v);
+	if(i == -1)
+	{
+		BOOST_THROW_EXCEPTION(vertex_not_found());
+	}
+	return m_out[i];
+}
+
+void DataflowSolver::Clear()
+{
+	m_cfg_blocks.clear();
+	m_vertex_number.clear();
+	m_vertices.clear();
+	m_pred_offsets.clear();
+	m_preds.clear();
+	m_succ_offsets.clear();
+	m_succs.clear();
+	m_in.clear();
+	m_out.clear();
+	m_num_transfers = 0;
+}
+
+bool DataflowSolver::FollowEdge(CFGEdgeTypeBase *e, ControlFlowGraph *source_cfg, ControlFlowGraph **target_cfg) const
+{
+	if(e->IsImpossible() || e->IsType<CFGEdgeTypeFunctionCallBypass>())
+	{
+		return false;
+	}
+
+	CFGEdgeTypeFunctionCall *fc = dynamic_cast<CFGEdgeTypeFunctionCall*>(e);
+	if(fc != NULL)
+	{
+		*target_cfg = fc->m_target_cfg;
+		return m_interprocedural;
+	}
+
+	if(e->IsType<CFGEdgeTypeReturn>())
+	{
+		// Return edges are added separately once we know which call sites are reachable.
+		return false;
+	}
+
+	*target_cfg = source_cfg;
+	return true;
+}
+
+std::size_t DataflowSolver::GetSlot(const ControlFlowGraph *cfg, ControlFlowGraph::vertex_descriptor v)
+{
+	std::map< const ControlFlowGraph*, std::pair<std::size_t, std::size_t> >::iterator it;
+
+	it = m_cfg_blocks.find(cfg);
+	if(it == m_cfg_blocks.end())
+	{
+		// First vertex we've seen from this graph.  Give it a block.
+		std::pair<std::size_t, std::size_t> block(m_vertex_number.size(), cfg->GetVertexIndexUpperBound());
+		m_vertex_number.resize(block.first + block.second, -1);
+		it = m_cfg_blocks.insert(std::make_pair(cfg, block)).first;
+	}
+
+	return it->second.first + v->GetIndex();
+}
+
+long DataflowSolver::GetVertexNumber(ControlFlowGraph::vertex_descriptor v) const
+{
+	const ControlFlowGraph *cfg;
+
+	if(m_cfg_blocks.empty())
+	{
+		return -1;
+	}
+	else if(!m_interprocedural)
+	{
+		cfg = m_cfg_blocks.begin()->first;
+	}
+	else
+	{
+		cfg = v->GetOwningFunction()->GetCFGPointer();
+	}
+
+	std::map< const ControlFlowGraph*, std::pair<std::size_t, std::size_t> >::const_iterator it;
+	it = m_cfg_blocks.find(cfg);
+	if(it == m_cfg_blocks.end() || v->GetIndex() >= it->second.second)
+	{
+		return -1;
+	}
+
+	return m_vertex_number[it->second.first + v->GetIndex()];
+}
+
+void DataflowSolver::NumberVertices(ControlFlowGraph *root_cfg, ControlFlowGraph::vertex_descriptor root)
+{
+	// Edges between vertices, in discovery numbers.
+	std::vector< std::pair<long, long> > edges;
+	// Discovery number to vertex.
+	std::vector<ControlFlowGraph::vertex_descriptor> discovered;
+	// Discovery numbers in postorder.
+	std::vector<long> postorder;
+	std::vector<DataflowDFSFrame> dfs_stack;
+
+	m_vertex_number[GetSlot(root_cfg, root)] = 0;
+	discovered.push_back(root);
+	dfs_stack.push_back(DataflowDFSFrame(root, root_cfg, 0));
+
+	while(!dfs_stack.empty())
+	{
+		DataflowDFSFrame &top = dfs_stack.back();
+
+		if(top.m_ei == top.m_eend)
+		{
+			// All successors have been discovered.
+			postorder.push_back(top.m_number);
+			dfs_stack.pop_back();
+			continue;
+		}
+
+		CFGEdgeTypeBase *e = *(top.m_ei);
+		++(top.m_ei);
+
+		ControlFlowGraph *target_cfg;
+		if(!FollowEdge(e, top.m_cfg, &target_cfg))
+		{
+			continue;
+		}
+
+		long source_number = top.m_number;
+		std::size_t slot = GetSlot(target_cfg, e->Target());
+		long target_number = m_vertex_number[slot];
+
+		if(target_number == -1)
+		{
+			// Haven't seen this vertex before.
+			target_number = discovered.size();
+			m_vertex_number[slot] = target_number;
+			discovered.push_back(e->Target());
+			// Note that this invalidates top.
+			dfs_stack.push_back(DataflowDFSFrame(e->Target(), target_cfg, target_number));
+		}
+
+		edges.push_back(std::make_pair(source_number, target_number));
+	}
+
+	if(m_interprocedural)
+	{
+		// Now add the Return edges which lead back to call sites we reached.
+		for(std::size_t i = 0; i < discovered.size(); ++i)
+		{
+			StatementBase::out_edge_iterator ei, eend;
+			discovered[i]->OutEdges(&ei, &eend);
+			for(; ei != eend; ++ei)
+			{
+				CFGEdgeTypeReturn *ret = dynamic_cast<CFGEdgeTypeReturn*>(*ei);
+				if(ret == NULL)
+				{
+					continue;
+				}
+
+				long call_site_number = GetVertexNumber(ret->m_function_call);
+				long return_site_number = GetVertexNumber(ret->Target());
+				if(call_site_number != -1 && return_site_number != -1)
+				{
+					edges.push_back(std::make_pair(long(i), return_site_number));
+				}
+			}
+		}
+	}
+
+	// Renumber everything in reverse postorder.
+	std::size_t n = discovered.size();
+	std::vector<long> rpo_number(n);
+	m_vertices.resize(n);
+	for(std::size_t i = 0; i < n; ++i)
+	{
+		rpo_number[postorder[i]] = n - 1 - i;
+		m_vertices[n - 1 - i] = discovered[postorder[i]];
+	}
+	for(std::size_t i = 0; i < m_vertex_number.size(); ++i)
+	{
+		if(m_vertex_number[i] != -1)
+		{
+			m_vertex_number[i] = rpo_number[m_vertex_number[i]];
+		}
+	}
+	for(std::size_t i = 0; i < edges.size(); ++i)
+	{
+		edges[i].first = rpo_number[edges[i].first];
+		edges[i].second = rpo_number[edges[i].second];
+	}
+
+	build_adjacency(n, edges, false, &m_succ_offsets, &m_succs);
+	build_adjacency(n, edges, true, &m_pred_offsets, &m_preds);
+}
+
+void DataflowSolver::Iterate(ControlFlowGraph::vertex_descriptor entry, ControlFlowGraph::vertex_descriptor exit)
+{
+	const long n = m_vertices.size();
+	const bool forward = m_problem.IsForward();
+	const bool meet_is_union = m_problem.IsMeetUnion();
+
+	// The identity of the meet operator.
+	bitset_type top(m_problem.GetNumFacts());
+	if(!meet_is_union)
+	{
+		top.set();
+	}
+
+	bitset_type boundary(m_problem.GetNumFacts());
+	m_problem.GetBoundaryValue(&boundary);
+
+	m_in.assign(n, top);
+	m_out.assign(n, top);
+
+	// Set up the direction-dependent views of the arrays.
+	std::vector<bitset_type> &flow_in = forward ? m_in : m_out;
+	std::vector<bitset_type> &flow_out = forward ? m_out : m_in;
+	const std::vector<std::size_t> &flow_pred_offsets = forward ? m_pred_offsets : m_succ_offsets;
+	const std::vector<long> &flow_preds = forward ? m_preds : m_succs;
+	const std::vector<std::size_t> &flow_succ_offsets = forward ? m_succ_offsets : m_pred_offsets;
+	const std::vector<long> &flow_succs = forward ? m_succs : m_preds;
+	long boundary_vertex = GetVertexNumber(forward ? entry : exit);
+
+	// The worklist holds positions in the iteration order, so that the lowest position is always processed first.
+	// Forward problems iterate in reverse postorder, backward problems in postorder.
+	std::priority_queue<long, std::vector<long>, std::greater<long> > worklist;
+	std::vector<bool> on_worklist(n, true);
+	for(long p = 0; p < n; ++p)
+	{
+		worklist.push(p);
+	}
+
+	bitset_type meet(m_problem.GetNumFacts());
+	bitset_type result(m_problem.GetNumFacts());
+
+	while(!worklist.empty())
+	{
+		long p = worklist.top();
+		worklist.pop();
+		long i = forward ? p : (n - 1 - p);
+		on_worklist[i] = false;
+
+		// Compute the meet over the predecessors in the direction of flow.
+		if(i == boundary_vertex)
+		{
+			meet = boundary;
+		}
+		else
+		{
+			meet = top;
+			for(std::size_t j = flow_pred_offsets[i]; j < flow_pred_offsets[i+1]; ++j)
+			{
+				if(meet_is_union)
+				{
+					meet |= flow_out[flow_preds[j]];
+				}
+				else
+				{
+					meet &= flow_out[flow_preds[j]];
+				}
+			}
+		}
+		flow_in[i] = meet;
+
+		// Apply the transfer function.
+		result.reset();
+		m_problem.Transfer(m_vertices[i], meet, &result);
+		++m_num_transfers;
+
+		if(result != flow_out[i])
+		{
+			// Changed, so the successors need to be revisited.
+			flow_out[i] = result;
+			for(std::size_t j = flow_succ_offsets[i]; j < flow_succ_offsets[i+1]; ++j)
+			{
+				long s = flow_succs[j];
+				if(!on_worklist[s])
+				{
+					on_worklist[s] = true;
+					worklist.push(forward ? s : (n - 1 - s));
+				}
+			}
+		}
+	}
+}
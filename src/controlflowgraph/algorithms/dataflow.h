@@ -0,0 +1,214 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ * Generic bit-vector dataflow analysis framework.
+ */
+
+#ifndef DATAFLOW_H
+#define DATAFLOW_H
+
+#include <map>
+#include <vector>
+#include <utility>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "../ControlFlowGraph.h"
+
+class Function;
+
+/**
+ * Abstract base class for bit-vector dataflow problems.
+ *
+ * A problem defines the number of facts (i.e. the width of the bit vectors), the direction of the analysis,
+ * the meet operator, the value at the boundary vertex, and the transfer function of each vertex.  Derive from this
+ * and pass an instance to a DataflowSolver to compute the fixed point.
+ */
+class DataflowProblem
+{
+public:
+	/// The type of the bit vectors which hold the dataflow facts.
+	typedef boost::dynamic_bitset<> bitset_type;
+
+	DataflowProblem();
+	virtual ~DataflowProblem();
+
+	/**
+	 * @return The number of facts, i.e. the number of bits in each vertex's bit vectors.
+	 */
+	virtual std::size_t GetNumFacts() const = 0;
+
+	/**
+	 * @return true if facts flow in the direction of the control flow edges (e.g. reaching definitions),
+	 * false if they flow against them (e.g. liveness).  Defaults to true.
+	 */
+	virtual bool IsForward() const { return true; };
+
+	/**
+	 * @return true if the meet operator is set union (a "may" problem), false if it's set intersection
+	 * (a "must" problem).  Defaults to true.
+	 */
+	virtual bool IsMeetUnion() const { return true; };
+
+	/**
+	 * Get the facts which hold on entry to the Entry vertex (forward problems) or on exit from the
+	 * Exit vertex (backward problems).  Defaults to no facts.
+	 *
+	 * @param[out] boundary  Bit vector to set.  It will already be sized to GetNumFacts() bits, all zero.
+	 */
+	virtual void GetBoundaryValue(bitset_type *boundary) const;
+
+	/**
+	 * The transfer function of vertex @a v.
+	 *
+	 * For forward problems, @a in is the set of facts holding before @a v executes, and @a out must be set
+	 * to the facts holding after.  For backward problems it's the other way around.
+	 *
+	 * @param v    The vertex whose transfer function to apply.
+	 * @param in   The facts flowing into @a v.
+	 * @param[out] out  The facts flowing out of @a v.  Will already be sized to GetNumFacts() bits.
+	 */
+	virtual void Transfer(ControlFlowGraph::vertex_descriptor v, const bitset_type &in, bitset_type *out) const = 0;
+};
+
+/**
+ * Worklist solver for DataflowProblems.
+ *
+ * The solver first numbers the vertices reachable from the starting vertex in reverse postorder, and builds compact
+ * predecessor/successor arrays in terms of those numbers.  It then iterates a priority worklist, ordered by reverse
+ * postorder for forward problems and by postorder for backward problems, until no vertex's facts change.  The facts
+ * themselves are kept in two dense arrays of bit vectors indexed by the vertex numbers.
+ *
+ * Impossible and FunctionCallBypass edges are never followed.  In intraprocedural mode FunctionCall and Return edges
+ * are ignored too, so the facts flow over a call site's Fallthrough edge as if the call were an ordinary statement.
+ * In interprocedural mode the solver also follows FunctionCall edges into the called Functions, and Return edges
+ * back to the call sites it reached.  The call site's Fallthrough edge is kept, so interprocedural problems should
+ * account for facts reaching the return site both around and through the call.
+ */
+class DataflowSolver
+{
+public:
+	typedef DataflowProblem::bitset_type bitset_type;
+
+	DataflowSolver(const DataflowProblem &problem);
+	~DataflowSolver();
+
+	/**
+	 * Solve the problem over a single control flow graph.
+	 *
+	 * @param cfg   The ControlFlowGraph to analyze.
+	 * @param entry The vertex to start at.  The boundary value applies here for forward problems.
+	 * @param exit  The vertex at which the boundary value applies for backward problems.
+	 */
+	void Solve(ControlFlowGraph &cfg, ControlFlowGraph::vertex_descriptor entry, ControlFlowGraph::vertex_descriptor exit);
+
+	/**
+	 * Solve the problem over @a root and all Functions it transitively calls.
+	 * Only calls which have been linked are followed, so materialize @a root transitively first
+	 * (see Program::MaterializeFunction()).
+	 *
+	 * @param root The Function to start the analysis at.
+	 */
+	void SolveInterprocedural(const Function *root);
+
+	/// @name Result accessors.
+	/// The facts are in program order regardless of the direction of the problem, i.e. GetIn() is the set
+	/// of facts holding immediately before @a v, and GetOut() those holding immediately after it.
+	//@{
+
+	/**
+	 * @return true if @a v was reached by the last Solve() and so has facts associated with it.
+	 */
+	bool IsInSolution(ControlFlowGraph::vertex_descriptor v) const;
+
+	const bitset_type& GetIn(ControlFlowGraph::vertex_descriptor v) const;
+	const bitset_type& GetOut(ControlFlowGraph::vertex_descriptor v) const;
+
+	/**
+	 * @return The number of transfer function evaluations the last Solve() needed to reach the fixed point.
+	 */
+	long GetNumTransfers() const { return m_num_transfers; };
+
+	//@}
+
+private:
+
+	void Clear();
+
+	/**
+	 * Number the vertices reachable from @a root in reverse postorder and build the adjacency arrays.
+	 */
+	void NumberVertices(ControlFlowGraph *root_cfg, ControlFlowGraph::vertex_descriptor root);
+
+	/**
+	 * Decide whether the solver should follow edge @a e.
+	 *
+	 * @param e The edge.
+	 * @param source_cfg The ControlFlowGraph containing the source vertex of @a e.
+	 * @param[out] target_cfg The ControlFlowGraph containing the target vertex of @a e.
+	 * @return true if the edge should be followed.
+	 */
+	bool FollowEdge(CFGEdgeTypeBase *e, ControlFlowGraph *source_cfg, ControlFlowGraph **target_cfg) const;
+
+	/**
+	 * Get the slot of vertex @a v of @a cfg in m_vertex_number, allocating a block for @a cfg if necessary.
+	 */
+	std::size_t GetSlot(const ControlFlowGraph *cfg, ControlFlowGraph::vertex_descriptor v);
+
+	/**
+	 * @return The number of @a v, or -1 if it isn't in the solution.
+	 */
+	long GetVertexNumber(ControlFlowGraph::vertex_descriptor v) const;
+
+	void Iterate(ControlFlowGraph::vertex_descriptor entry, ControlFlowGraph::vertex_descriptor exit);
+
+	/// The problem being solved.
+	const DataflowProblem &m_problem;
+
+	/// Whether to follow FunctionCall and Return edges.
+	bool m_interprocedural;
+
+	/// Map of each ControlFlowGraph visited to the base and size of its block in m_vertex_number.
+	std::map< const ControlFlowGraph*, std::pair<std::size_t, std::size_t> > m_cfg_blocks;
+
+	/// The number of each vertex, indexed by its block base plus its Vertex::GetIndex(), or -1 if it wasn't reached.
+	std::vector<long> m_vertex_number;
+
+	/// The vertices, indexed by number.  Numbers are assigned in reverse postorder.
+	std::vector<ControlFlowGraph::vertex_descriptor> m_vertices;
+
+	/// @name Compressed adjacency arrays.
+	/// The predecessors of vertex number i are m_preds[m_pred_offsets[i]] through m_preds[m_pred_offsets[i+1]-1],
+	/// and similarly for the successors.
+	//@{
+	std::vector<std::size_t> m_pred_offsets;
+	std::vector<long> m_preds;
+	std::vector<std::size_t> m_succ_offsets;
+	std::vector<long> m_succs;
+	//@}
+
+	/// @name The facts, indexed by vertex number.
+	//@{
+	std::vector<bitset_type> m_in;
+	std::vector<bitset_type> m_out;
+	//@}
+
+	long m_num_transfers;
+};
+
+#endif // DATAFLOW_H
@@ -0,0 +1,735 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "layered_layout.h"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <utility>
+
+#include <boost/foreach.hpp>
+
+/// @name Drawing metrics, in pixels.
+//@{
+static const double f_char_width = 7.0;
+static const double f_line_height = 14.0;
+static const double f_vertex_padding = 8.0;
+static const double f_min_vertex_width = 40.0;
+static const double f_dummy_width = 8.0;
+static const double f_vertex_separation = 20.0;
+static const double f_layer_separation = 40.0;
+static const double f_margin = 12.0;
+static const double f_title_height = 24.0;
+//@}
+
+/// Upper limit on the number of barycenter sweeps, alternating downward and upward.
+static const long f_max_crossing_reduction_sweeps = 8;
+
+/// Number of passes pulling the vertices toward their neighbors during coordinate assignment.
+static const long f_coordinate_passes = 4;
+
+/**
+ * Sort helper for ordering the vertices of a layer by barycenter.  The barycenters are indexed by each vertex's
+ * position in the layer before the sort.
+ */
+struct barycenter_less
+{
+	barycenter_less(const std::vector<double> &barycenter, const std::vector<long> &position)
+		: m_barycenter(barycenter), m_position(position) {};
+
+	bool operator()(long a, long b) const { return m_barycenter[m_position[a]] < m_barycenter[m_position[b]]; };
+
+	const std::vector<double> &m_barycenter;
+	const std::vector<long> &m_position;
+};
+
+/**
+ * @return @a text with the characters which are special in XML escaped.
+ */
+static std::string xml_escape(const std::string &text)
+{
+	std::string retval;
+
+	BOOST_FOREACH(char c, text)
+	{
+		switch(c)
+		{
+			case '&': retval += "&amp;"; break;
+			case '<': retval += "&lt;"; break;
+			case '>': retval += "&gt;"; break;
+			case '"': retval += "&quot;"; break;
+			default: retval += c; break;
+		}
+	}
+
+	return retval;
+}
+
+/**
+ * @return The SVG stroke-dasharray for Graphviz line style @a style, or an empty string for a solid line.
+ */
+static std::string dasharray_for_style(const std::string &style)
+{
+	if(style == "dashed")
+	{
+		return "6,4";
+	}
+	else if(style == "dotted")
+	{
+		return "1,3";
+	}
+
+	return std::string();
+}
+
+LayeredLayout::LayeredLayout()
+{
+	m_num_real_vertices = 0;
+	m_num_layers = 0;
+	m_num_crossings = 0;
+}
+
+LayeredLayout::~LayeredLayout()
+{
+}
+
+long LayeredLayout::AddVertex(const VertexAttributes &attributes)
+{
+	std::size_t longest_line = 0;
+	BOOST_FOREACH(const std::string &line, attributes.m_label_lines)
+	{
+		longest_line = std::max(longest_line, line.size());
+	}
+
+	double width = std::max(f_min_vertex_width, longest_line * f_char_width + 2 * f_vertex_padding);
+	double height = std::max<std::size_t>(attributes.m_label_lines.size(), 1) * f_line_height + 2 * f_vertex_padding;
+
+	// The text has to fit inside the shape, which for these is smaller than the bounding box.
+	if(attributes.m_shape == "diamond")
+	{
+		width *= 1.6;
+		height *= 1.6;
+	}
+	else if((attributes.m_shape == "ellipse") || (attributes.m_shape == "oval"))
+	{
+		width *= 1.3;
+		height *= 1.3;
+	}
+
+	m_vertex_attributes.push_back(attributes);
+	m_width.push_back(width);
+	m_height.push_back(height);
+	m_num_real_vertices = m_vertex_attributes.size();
+
+	return m_num_real_vertices - 1;
+}
+
+void LayeredLayout::AddEdge(long source, long target, bool is_back_edge, const EdgeAttributes &attributes)
+{
+	Edge e;
+
+	e.m_source = source;
+	e.m_target = target;
+	e.m_is_back_edge = is_back_edge;
+	e.m_attributes = attributes;
+
+	m_edges.push_back(e);
+}
+
+void LayeredLayout::Layout()
+{
+	// Discard any dummy vertices from a previous layout.
+	m_width.resize(m_num_real_vertices);
+	m_height.resize(m_num_real_vertices);
+
+	AssignLayers();
+	SplitLongEdges();
+	ReduceCrossings();
+	AssignCoordinates();
+}
+
+void LayeredLayout::AssignLayers()
+{
+	const long n = m_num_real_vertices;
+	std::vector< std::vector<long> > successors(n);
+	std::vector<long> in_degree(n, 0);
+
+	// The DAG is the graph with the back edges reversed.  Self loops don't affect the layering.
+	BOOST_FOREACH(const Edge &e, m_edges)
+	{
+		long u = e.m_is_back_edge ? e.m_target : e.m_source;
+		long v = e.m_is_back_edge ? e.m_source : e.m_target;
+		if(u != v)
+		{
+			successors[u].push_back(v);
+			in_degree[v]++;
+		}
+	}
+
+	// Kahn's algorithm.  If it runs out of sources before it runs out of vertices there's a cycle the back edges
+	// didn't break, so start again from the lowest-numbered vertex not yet ordered.
+	std::vector<long> order;
+	std::vector<long> order_position(n, -1);
+	std::deque<long> sources;
+	long next_unordered = 0;
+	for(long v = 0; v < n; ++v)
+	{
+		if(in_degree[v] == 0)
+		{
+			sources.push_back(v);
+		}
+	}
+	while(static_cast<long>(order.size()) < n)
+	{
+		if(sources.empty())
+		{
+			while(order_position[next_unordered] != -1)
+			{
+				++next_unordered;
+			}
+			sources.push_back(next_unordered);
+		}
+
+		long u = sources.front();
+		sources.pop_front();
+		if(order_position[u] != -1)
+		{
+			// Forced earlier to break a cycle.
+			continue;
+		}
+		order_position[u] = order.size();
+		order.push_back(u);
+
+		BOOST_FOREACH(long v, successors[u])
+		{
+			if((--in_degree[v] == 0) && (order_position[v] == -1))
+			{
+				sources.push_back(v);
+			}
+		}
+	}
+
+	// Longest path layering, in Kahn's order.  Any edge pointing backwards in the order is one of the cycle-breaking
+	// edges, and is treated as reversed.
+	std::vector< std::vector<long> > downward(n);
+	BOOST_FOREACH(const Edge &e, m_edges)
+	{
+		long u = e.m_source;
+		long v = e.m_target;
+		if(u == v)
+		{
+			continue;
+		}
+		if(order_position[u] > order_position[v])
+		{
+			std::swap(u, v);
+		}
+		downward[u].push_back(v);
+	}
+
+	m_layer.assign(n, 0);
+	m_num_layers = (n > 0) ? 1 : 0;
+	BOOST_FOREACH(long u, order)
+	{
+		BOOST_FOREACH(long v, downward[u])
+		{
+			m_layer[v] = std::max(m_layer[v], m_layer[u] + 1);
+			m_num_layers = std::max(m_num_layers, m_layer[v] + 1);
+		}
+	}
+}
+
+void LayeredLayout::SplitLongEdges()
+{
+	const long n = m_num_real_vertices;
+
+	m_layer.resize(n);
+	m_down.assign(n, std::vector<long>());
+	m_up.assign(n, std::vector<long>());
+	m_edge_chain.assign(m_edges.size(), std::vector<long>());
+
+	for(std::size_t ei = 0; ei < m_edges.size(); ++ei)
+	{
+		const Edge &e = m_edges[ei];
+		std::vector<long> &chain = m_edge_chain[ei];
+
+		long top = e.m_source;
+		long bottom = e.m_target;
+		if(m_layer[top] > m_layer[bottom])
+		{
+			std::swap(top, bottom);
+		}
+
+		chain.push_back(top);
+		if(top == bottom)
+		{
+			// Self loop.
+			continue;
+		}
+
+		for(long l = m_layer[top] + 1; l < m_layer[bottom]; ++l)
+		{
+			long dummy = m_layer.size();
+			m_layer.push_back(l);
+			m_width.push_back(f_dummy_width);
+			m_height.push_back(0);
+			m_down.push_back(std::vector<long>());
+			m_up.push_back(std::vector<long>());
+			chain.push_back(dummy);
+		}
+		chain.push_back(bottom);
+
+		for(std::size_t i = 0; i+1 < chain.size(); ++i)
+		{
+			m_down[chain[i]].push_back(chain[i+1]);
+			m_up[chain[i+1]].push_back(chain[i]);
+		}
+	}
+}
+
+void LayeredLayout::ReduceCrossings()
+{
+	const long n = m_layer.size();
+
+	// Start from the order a depth-first search from the top reaches the vertices in.  That keeps each branch's
+	// vertices together, which is usually most of the way there for a control flow graph.
+	m_layers.assign(m_num_layers, std::vector<long>());
+	m_position.assign(n, -1);
+	std::vector<bool> visited(n, false);
+	for(long root = 0; root < n; ++root)
+	{
+		if(visited[root] || !m_up[root].empty())
+		{
+			continue;
+		}
+
+		std::vector<long> stack(1, root);
+		visited[root] = true;
+		while(!stack.empty())
+		{
+			long u = stack.back();
+			stack.pop_back();
+			m_position[u] = m_layers[m_layer[u]].size();
+			m_layers[m_layer[u]].push_back(u);
+
+			BOOST_REVERSE_FOREACH(long v, m_down[u])
+			{
+				if(!visited[v])
+				{
+					visited[v] = true;
+					stack.push_back(v);
+				}
+			}
+		}
+	}
+	for(long v = 0; v < n; ++v)
+	{
+		// Anything left is only reachable through a cycle of edges between vertices on the same layer, which
+		// can't happen, but be safe.
+		if(!visited[v])
+		{
+			m_position[v] = m_layers[m_layer[v]].size();
+			m_layers[m_layer[v]].push_back(v);
+		}
+	}
+
+	std::vector< std::vector<long> > best_layers(m_layers);
+	long best_crossings = CountAllCrossings();
+
+	for(long sweep = 0; (sweep < f_max_crossing_reduction_sweeps) && (best_crossings > 0); ++sweep)
+	{
+		if(sweep % 2 == 0)
+		{
+			for(long l = 1; l < m_num_layers; ++l)
+			{
+				SortLayerByBarycenter(l, true);
+			}
+		}
+		else
+		{
+			for(long l = m_num_layers - 2; l >= 0; --l)
+			{
+				SortLayerByBarycenter(l, false);
+			}
+		}
+
+		long crossings = CountAllCrossings();
+		if(crossings < best_crossings)
+		{
+			best_crossings = crossings;
+			best_layers = m_layers;
+		}
+	}
+
+	m_layers.swap(best_layers);
+	for(long l = 0; l < m_num_layers; ++l)
+	{
+		for(std::size_t i = 0; i < m_layers[l].size(); ++i)
+		{
+			m_position[m_layers[l][i]] = i;
+		}
+	}
+	m_num_crossings = best_crossings;
+}
+
+void LayeredLayout::SortLayerByBarycenter(long l, bool downward)
+{
+	std::vector<long> &layer = m_layers[l];
+
+	// Only this layer's vertices need barycenters, so index them by position rather than by vertex.  Allocating one
+	// for every vertex in the graph would make each sweep quadratic.
+	std::vector<double> barycenter(layer.size(), 0);
+
+	BOOST_FOREACH(long v, layer)
+	{
+		const std::vector<long> &neighbors = downward ? m_up[v] : m_down[v];
+		if(neighbors.empty())
+		{
+			// Nothing to pull it anywhere, so leave it where it is.
+			barycenter[m_position[v]] = m_position[v];
+			continue;
+		}
+
+		double sum = 0;
+		BOOST_FOREACH(long w, neighbors)
+		{
+			sum += m_position[w];
+		}
+		barycenter[m_position[v]] = sum / neighbors.size();
+	}
+
+	std::stable_sort(layer.begin(), layer.end(), barycenter_less(barycenter, m_position));
+
+	for(std::size_t i = 0; i < layer.size(); ++i)
+	{
+		m_position[layer[i]] = i;
+	}
+}
+
+long LayeredLayout::CountCrossings(long l) const
+{
+	// Two segments cross if their ends are in opposite orders on the two layers.  Sort the segments by their upper
+	// ends, and count the inversions in their lower ends with a Fenwick tree.
+	std::vector< std::pair<long, long> > segments;
+	BOOST_FOREACH(long u, m_layers[l])
+	{
+		BOOST_FOREACH(long v, m_down[u])
+		{
+			segments.push_back(std::make_pair(m_position[u], m_position[v]));
+		}
+	}
+	std::sort(segments.begin(), segments.end());
+
+	const long lower_layer_size = m_layers[l+1].size();
+	std::vector<long> tree(lower_layer_size + 1, 0);
+	long crossings = 0;
+	long inserted = 0;
+	for(std::size_t i = 0; i < segments.size(); ++i)
+	{
+		// Count the segments already inserted whose lower end is to the right of this one's.
+		long at_or_left = 0;
+		for(long j = segments[i].second + 1; j > 0; j -= j & -j)
+		{
+			at_or_left += tree[j];
+		}
+		crossings += inserted - at_or_left;
+
+		for(long j = segments[i].second + 1; j <= lower_layer_size; j += j & -j)
+		{
+			tree[j]++;
+		}
+		++inserted;
+	}
+
+	return crossings;
+}
+
+long LayeredLayout::CountAllCrossings() const
+{
+	long crossings = 0;
+
+	for(long l = 0; l+1 < m_num_layers; ++l)
+	{
+		crossings += CountCrossings(l);
+	}
+
+	return crossings;
+}
+
+void LayeredLayout::AssignCoordinates()
+{
+	const long n = m_layer.size();
+
+	m_x.assign(n, 0);
+	m_y.assign(n, 0);
+
+	// Stack the layers, each as tall as its tallest vertex.
+	double top = f_margin + f_title_height;
+	for(long l = 0; l < m_num_layers; ++l)
+	{
+		double layer_height = 0;
+		BOOST_FOREACH(long v, m_layers[l])
+		{
+			layer_height = std::max(layer_height, m_height[v]);
+		}
+		BOOST_FOREACH(long v, m_layers[l])
+		{
+			m_y[v] = top + layer_height / 2;
+		}
+		top += layer_height + f_layer_separation;
+	}
+
+	// Pack each layer to start with.
+	for(long l = 0; l < m_num_layers; ++l)
+	{
+		double x = 0;
+		BOOST_FOREACH(long v, m_layers[l])
+		{
+			m_x[v] = x + m_width[v] / 2;
+			x += m_width[v] + f_vertex_separation;
+		}
+	}
+
+	// Then pull each vertex toward the mean of its neighbors on the layer above, and then below, alternately.  Each
+	// layer is placed by pushing the vertices apart from the left and from the right where they'd overlap, and taking
+	// the average of the two.  That keeps the order and the separation, and doesn't favor either side.
+	for(long pass = 0; pass < f_coordinate_passes; ++pass)
+	{
+		bool downward = (pass % 2 == 0);
+		for(long i = 0; i < m_num_layers; ++i)
+		{
+			const std::vector<long> &layer = m_layers[downward ? i : m_num_layers - 1 - i];
+			const long size = layer.size();
+			if(size == 0)
+			{
+				continue;
+			}
+
+			std::vector<double> desired(size), from_left(size), from_right(size);
+			for(long k = 0; k < size; ++k)
+			{
+				const std::vector<long> &neighbors = downward ? m_up[layer[k]] : m_down[layer[k]];
+				desired[k] = m_x[layer[k]];
+				if(!neighbors.empty())
+				{
+					double sum = 0;
+					BOOST_FOREACH(long w, neighbors)
+					{
+						sum += m_x[w];
+					}
+					desired[k] = sum / neighbors.size();
+				}
+			}
+
+			for(long k = 0; k < size; ++k)
+			{
+				from_left[k] = desired[k];
+				if(k > 0)
+				{
+					double min_x = from_left[k-1] + (m_width[layer[k-1]] + m_width[layer[k]]) / 2 + f_vertex_separation;
+					from_left[k] = std::max(from_left[k], min_x);
+				}
+			}
+			for(long k = size - 1; k >= 0; --k)
+			{
+				from_right[k] = desired[k];
+				if(k < size - 1)
+				{
+					double max_x = from_right[k+1] - (m_width[layer[k+1]] + m_width[layer[k]]) / 2 - f_vertex_separation;
+					from_right[k] = std::min(from_right[k], max_x);
+				}
+			}
+			for(long k = 0; k < size; ++k)
+			{
+				m_x[layer[k]] = (from_left[k] + from_right[k]) / 2;
+			}
+		}
+	}
+
+	// Move the drawing to the origin.
+	double min_x = 0, max_x = 0, max_y = f_margin + f_title_height;
+	for(long v = 0; v < n; ++v)
+	{
+		if((v == 0) || (m_x[v] - m_width[v] / 2 < min_x))
+		{
+			min_x = m_x[v] - m_width[v] / 2;
+		}
+	}
+	for(long v = 0; v < n; ++v)
+	{
+		m_x[v] += f_margin - min_x;
+		max_x = std::max(max_x, m_x[v] + m_width[v] / 2);
+		max_y = std::max(max_y, m_y[v] + m_height[v] / 2);
+	}
+	m_size = Point(max_x + f_margin, max_y + f_margin);
+
+	// Route the edges straight through their dummy vertices, leaving the bottom of the upper vertex and entering the
+	// top of the lower one.
+	m_edge_points.assign(m_edges.size(), std::vector<Point>());
+	for(std::size_t ei = 0; ei < m_edges.size(); ++ei)
+	{
+		const std::vector<long> &chain = m_edge_chain[ei];
+		std::vector<Point> &points = m_edge_points[ei];
+
+		if(chain.size() == 1)
+		{
+			// A self loop, drawn as a loop off the right side.
+			long v = chain.front();
+			points.push_back(Point(m_x[v] + m_width[v] / 2, m_y[v]));
+			continue;
+		}
+
+		for(std::size_t i = 0; i < chain.size(); ++i)
+		{
+			long v = chain[i];
+			double y = m_y[v];
+			if(i == 0)
+			{
+				y += m_height[v] / 2;
+			}
+			else if(i == chain.size() - 1)
+			{
+				y -= m_height[v] / 2;
+			}
+			points.push_back(Point(m_x[v], y));
+		}
+
+		if(chain.front() != m_edges[ei].m_source)
+		{
+			// Drawn against its direction.
+			std::reverse(points.begin(), points.end());
+		}
+	}
+}
+
+void LayeredLayout::WriteSVG(std::ostream &out, const std::string &title) const
+{
+	// One arrowhead marker per edge color, so the heads match the lines.
+	std::map<std::string, std::string> marker_ids;
+	BOOST_FOREACH(const Edge &e, m_edges)
+	{
+		if(marker_ids.count(e.m_attributes.m_color) == 0)
+		{
+			std::ostringstream oss;
+			oss << "arrowhead" << marker_ids.size();
+			marker_ids[e.m_attributes.m_color] = oss.str();
+		}
+	}
+
+	out << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n";
+	out << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << m_size.m_x << "pt\" height=\"" << m_size.m_y
+		<< "pt\" viewBox=\"0 0 " << m_size.m_x << " " << m_size.m_y << "\">\n";
+	out << "<title>" << xml_escape(title) << "</title>\n";
+	out << "<defs>\n";
+	for(std::map<std::string, std::string>::const_iterator it = marker_ids.begin(); it != marker_ids.end(); ++it)
+	{
+		out << "<marker id=\"" << it->second << "\" viewBox=\"0 0 10 10\" refX=\"10\" refY=\"5\" markerWidth=\"8\""
+			" markerHeight=\"8\" orient=\"auto\"><path d=\"M 0 0 L 10 5 L 0 10 z\" fill=\"" << xml_escape(it->first)
+			<< "\"/></marker>\n";
+	}
+	out << "</defs>\n";
+	out << "<g font-family=\"Helvetica,sans-serif\" font-size=\"12\">\n";
+	out << "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
+	out << "<text x=\"" << f_margin << "\" y=\"" << f_margin + 12 << "\" font-size=\"14\">" << xml_escape(title)
+		<< "</text>\n";
+
+	// Edges first, so the vertices are drawn over their ends.
+	for(std::size_t ei = 0; ei < m_edges.size(); ++ei)
+	{
+		const EdgeAttributes &attributes = m_edges[ei].m_attributes;
+		const std::vector<Point> &points = m_edge_points[ei];
+		std::string dasharray = dasharray_for_style(attributes.m_style);
+		Point label_position;
+
+		out << "<g class=\"edge\">";
+		if(points.size() == 1)
+		{
+			const Point &p = points.front();
+			out << "<path d=\"M " << p.m_x << " " << p.m_y - 4 << " C " << p.m_x + 30 << " " << p.m_y - 20 << " "
+				<< p.m_x + 30 << " " << p.m_y + 20 << " " << p.m_x << " " << p.m_y + 4 << "\"";
+			label_position = Point(p.m_x + 32, p.m_y);
+		}
+		else
+		{
+			out << "<polyline points=\"";
+			for(std::size_t i = 0; i < points.size(); ++i)
+			{
+				out << (i == 0 ? "" : " ") << points[i].m_x << "," << points[i].m_y;
+			}
+			out << "\"";
+
+			// Label the middle segment.
+			const Point &a = points[(points.size() - 1) / 2];
+			const Point &b = points[(points.size() - 1) / 2 + 1];
+			label_position = Point((a.m_x + b.m_x) / 2 + 4, (a.m_y + b.m_y) / 2);
+		}
+		out << " fill=\"none\" stroke=\"" << xml_escape(attributes.m_color) << "\"";
+		if(!dasharray.empty())
+		{
+			out << " stroke-dasharray=\"" << dasharray << "\"";
+		}
+		out << " marker-end=\"url(#" << marker_ids.find(attributes.m_color)->second << ")\"/>";
+		if(!attributes.m_label.empty())
+		{
+			out << "<text x=\"" << label_position.m_x << "\" y=\"" << label_position.m_y << "\" font-size=\"10\" fill=\""
+				<< xml_escape(attributes.m_color) << "\">" << xml_escape(attributes.m_label) << "</text>";
+		}
+		out << "</g>\n";
+	}
+
+	for(long v = 0; v < m_num_real_vertices; ++v)
+	{
+		const VertexAttributes &attributes = m_vertex_attributes[v];
+		const double x = m_x[v], y = m_y[v], hw = m_width[v] / 2, hh = m_height[v] / 2;
+		const std::string color = xml_escape(attributes.m_color);
+
+		out << "<g class=\"node\">";
+		if(attributes.m_shape == "diamond")
+		{
+			out << "<polygon points=\"" << x << "," << y - hh << " " << x + hw << "," << y << " " << x << "," << y + hh
+				<< " " << x - hw << "," << y << "\"";
+		}
+		else if((attributes.m_shape == "ellipse") || (attributes.m_shape == "oval"))
+		{
+			out << "<ellipse cx=\"" << x << "\" cy=\"" << y << "\" rx=\"" << hw << "\" ry=\"" << hh << "\"";
+		}
+		else
+		{
+			out << "<rect x=\"" << x - hw << "\" y=\"" << y - hh << "\" width=\"" << m_width[v] << "\" height=\""
+				<< m_height[v] << "\"";
+		}
+		out << " fill=\"white\" stroke=\"" << color << "\"/>";
+
+		// Center the lines of the label vertically, each on its baseline.
+		double baseline = y - (attributes.m_label_lines.size() * f_line_height) / 2 + f_line_height - 3;
+		BOOST_FOREACH(const std::string &line, attributes.m_label_lines)
+		{
+			out << "<text x=\"" << x << "\" y=\"" << baseline << "\" text-anchor=\"middle\">" << xml_escape(line)
+				<< "</text>";
+			baseline += f_line_height;
+		}
+		out << "</g>\n";
+	}
+
+	out << "</g>\n";
+	out << "</svg>\n";
+}
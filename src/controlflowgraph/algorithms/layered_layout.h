@@ -0,0 +1,218 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ * Layered (Sugiyama-style) graph layout and SVG output.
+ */
+
+#ifndef LAYERED_LAYOUT_H
+#define LAYERED_LAYOUT_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/**
+ * Layered drawing of a directed graph, for rendering control flow graphs without Graphviz.
+ *
+ * The graph is described to the layout in terms of dense vertex indices, so it doesn't depend on the ControlFlowGraph
+ * itself.  Layout() then runs the classic Sugiyama phases:
+ *  -# Edges marked as back edges are reversed, which leaves a DAG as long as the back edges were marked correctly.
+ *     Any cycles which remain are broken at whichever edges point backwards in Kahn's order.
+ *  -# Each vertex is put on a layer by longest path from the sources, taken in Kahn's topological order.
+ *  -# Edges spanning more than one layer are split with dummy vertices, one per layer crossed.
+ *  -# Crossings are reduced by alternating downward and upward barycenter sweeps.  The ordering with the fewest
+ *     crossings seen is kept.
+ *  -# Each layer is placed left to right with its vertices pulled toward the barycenters of their neighbors, and the
+ *     layers are stacked top to bottom.
+ *
+ * Edges are drawn as straight segments through their dummy vertices.
+ *
+ * All coordinates are in SVG user units (pixels), with the origin at the top left of the drawing.
+ */
+class LayeredLayout
+{
+public:
+
+	/// The appearance of a vertex.
+	struct VertexAttributes
+	{
+		VertexAttributes() : m_color("black"), m_shape("rectangle") {};
+
+		/// The lines of text to draw in the vertex.
+		std::vector<std::string> m_label_lines;
+
+		/// The SVG color name of the outline.
+		std::string m_color;
+
+		/// The shape, as a Graphviz shape name.  "diamond", "ellipse" and "oval" are drawn as such, anything else
+		/// as a rectangle.
+		std::string m_shape;
+	};
+
+	/// The appearance of an edge.
+	struct EdgeAttributes
+	{
+		EdgeAttributes() : m_color("black"), m_style("solid") {};
+
+		std::string m_label;
+
+		/// The SVG color name of the line.
+		std::string m_color;
+
+		/// The line style, as a Graphviz style name: "solid", "dashed" or "dotted".
+		std::string m_style;
+	};
+
+	/// A point in the drawing.
+	struct Point
+	{
+		Point() : m_x(0), m_y(0) {};
+		Point(double x, double y) : m_x(x), m_y(y) {};
+		double m_x, m_y;
+	};
+
+	LayeredLayout();
+	~LayeredLayout();
+
+	/**
+	 * Add a vertex to the graph.  Its size is estimated from its label.
+	 *
+	 * @return The index of the new vertex.  These are assigned in order from 0.
+	 */
+	long AddVertex(const VertexAttributes &attributes);
+
+	/**
+	 * Add an edge from vertex @a source to vertex @a target.
+	 *
+	 * @param is_back_edge  true if this edge closes a loop.  Back edges point up the drawing instead of down.
+	 */
+	void AddEdge(long source, long target, bool is_back_edge, const EdgeAttributes &attributes);
+
+	/**
+	 * Lay out the graph.  Must be called after all the vertices and edges have been added, and before any of the
+	 * layout accessors or WriteSVG().
+	 */
+	void Layout();
+
+	/**
+	 * Write the laid-out graph as a standalone SVG document.
+	 *
+	 * @param out  The stream to write to.
+	 * @param title  The title of the drawing, shown at the top left.
+	 */
+	void WriteSVG(std::ostream &out, const std::string &title) const;
+
+	/// @name Layout results.
+	//@{
+
+	/// @return The number of layers.
+	long NumLayers() const { return m_num_layers; };
+
+	/// @return The layer vertex @a v was placed on, 0 being the top.
+	long GetLayer(long v) const { return m_layer[v]; };
+
+	/// @return The position of vertex @a v within its layer, 0 being the leftmost.
+	long GetPositionInLayer(long v) const { return m_position[v]; };
+
+	/// @return The center of vertex @a v.
+	Point GetCenter(long v) const { return Point(m_x[v], m_y[v]); };
+
+	/// @return The points edge @a e is drawn through, from its source to its target.
+	const std::vector<Point>& GetEdgePoints(long e) const { return m_edge_points[e]; };
+
+	/// @return The number of edge crossings in the final ordering, counting the segments through dummy vertices.
+	long NumCrossings() const { return m_num_crossings; };
+
+	/// @return The size of the whole drawing.
+	Point GetSize() const { return m_size; };
+	//@}
+
+private:
+
+	/// An edge as given to AddEdge().
+	struct Edge
+	{
+		long m_source;
+		long m_target;
+		bool m_is_back_edge;
+		EdgeAttributes m_attributes;
+	};
+
+	/// Assign m_layer by longest path over the DAG left once the back edges are reversed.
+	void AssignLayers();
+
+	/// Split the edges into one-layer segments, creating the dummy vertices.  Fills in m_down and m_up.
+	void SplitLongEdges();
+
+	/// Order the vertices within each layer to reduce crossings.  Fills in m_layers and m_position.
+	void ReduceCrossings();
+
+	/// Assign coordinates to all the vertices, real and dummy.
+	void AssignCoordinates();
+
+	/// Reorder layer @a l by the barycenters of each vertex's neighbors in the adjacent layer, above if @a downward.
+	void SortLayerByBarycenter(long l, bool downward);
+
+	/// @return The number of crossings between the segments from layer @a l to layer @a l + 1.
+	long CountCrossings(long l) const;
+
+	/// @return The total number of crossings in the current ordering.
+	long CountAllCrossings() const;
+
+	/// @name The graph as added.
+	//@{
+	std::vector<VertexAttributes> m_vertex_attributes;
+	std::vector<Edge> m_edges;
+	//@}
+
+	/// Number of real vertices.  The dummy vertices follow them.
+	long m_num_real_vertices;
+
+	/// Width and height of each vertex, real and dummy.
+	std::vector<double> m_width, m_height;
+
+	/// Layer of each vertex.
+	std::vector<long> m_layer;
+
+	long m_num_layers;
+
+	/// The one-layer segments, as neighbors of each vertex in the layer below and above.
+	std::vector< std::vector<long> > m_down, m_up;
+
+	/// For each edge, the chain of vertices it's drawn through in drawing order (top to bottom), including its end
+	/// vertices.
+	std::vector< std::vector<long> > m_edge_chain;
+
+	/// The vertices in each layer, left to right.
+	std::vector< std::vector<long> > m_layers;
+
+	/// Index of each vertex within m_layers[m_layer[v]].
+	std::vector<long> m_position;
+
+	/// Centers of the vertices.
+	std::vector<double> m_x, m_y;
+
+	std::vector< std::vector<Point> > m_edge_points;
+
+	long m_num_crossings;
+
+	Point m_size;
+};
+
+#endif /* LAYERED_LAYOUT_H */
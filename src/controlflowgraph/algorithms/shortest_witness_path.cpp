@@ -0,0 +1,239 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "shortest_witness_path.h"
+
+#include <map>
+#include <vector>
+
+#include "../ControlFlowGraph.h"
+#include "../edges/edge_types.h"
+#include "../statements/FunctionCall.h"
+#include "../../Function.h"
+
+/// Parent state value for states which haven't been discovered yet.
+static const long NOT_DISCOVERED = -1;
+
+/// Context index meaning "no context".
+static const long NO_CONTEXT = -1;
+
+/**
+ * A call context of the breadth-first witness search.
+ */
+struct WitnessSearchContext
+{
+	WitnessSearchContext(long parent_context, FunctionCall *pushing_call, std::size_t base)
+	{
+		m_parent_context = parent_context;
+		m_pushing_call = pushing_call;
+		m_base = base;
+	};
+
+	/// Index of the context the call was made from, or NO_CONTEXT for the outermost context.
+	long m_parent_context;
+
+	/// The call which created this context, or NULL for the outermost context.
+	FunctionCall *m_pushing_call;
+
+	/// Offset of this context's block in the flat state arrays.
+	std::size_t m_base;
+};
+
+/**
+ * An entry in the breadth-first search queue.
+ */
+struct WitnessSearchQueueEntry
+{
+	WitnessSearchQueueEntry(long state, long context, ControlFlowGraph::vertex_descriptor v)
+	{
+		m_state = state;
+		m_context = context;
+		m_v = v;
+	};
+
+	long m_state;
+	long m_context;
+	ControlFlowGraph::vertex_descriptor m_v;
+};
+
+/**
+ * Helper class holding the contexts and the flat state arrays of the search.
+ */
+class WitnessSearchState
+{
+public:
+
+	/**
+	 * Create a new context for searching @a cfg and allocate its block of the state arrays.
+	 *
+	 * @return The index of the new context.
+	 */
+	long AddContext(long parent_context, FunctionCall *pushing_call, const ControlFlowGraph *cfg)
+	{
+		std::size_t base = m_parent_edge.size();
+		std::size_t block_size = cfg->GetVertexIndexUpperBound();
+
+		m_parent_edge.resize(base + block_size, ControlFlowGraph::edge_descriptor(NULL));
+		m_parent_state.resize(base + block_size, NOT_DISCOVERED);
+		m_contexts.push_back(WitnessSearchContext(parent_context, pushing_call, base));
+
+		if(pushing_call != NULL)
+		{
+			m_call_site_context[pushing_call] = m_contexts.size() - 1;
+		}
+
+		return m_contexts.size() - 1;
+	};
+
+	/**
+	 * @return The context already created for @a call, or NO_CONTEXT if the search hasn't entered the callee
+	 * through it yet.
+	 */
+	long FindContext(FunctionCall *call) const
+	{
+		std::map<FunctionCall*, long>::const_iterator it = m_call_site_context.find(call);
+
+		if(it == m_call_site_context.end())
+		{
+			return NO_CONTEXT;
+		}
+		return it->second;
+	};
+
+	long GetState(long context, ControlFlowGraph::vertex_descriptor v) const
+	{
+		return m_contexts[context].m_base + v->GetIndex();
+	};
+
+	/// One entry per context.
+	std::vector<WitnessSearchContext> m_contexts;
+
+	/// The context created for each call site the search has entered a callee through.
+	std::map<FunctionCall*, long> m_call_site_context;
+
+	/// The edge by which each (vertex, context) state was first discovered.
+	std::vector<ControlFlowGraph::edge_descriptor> m_parent_edge;
+
+	/// The state from which each (vertex, context) state was first discovered.
+	std::vector<long> m_parent_state;
+};
+
+
+bool shortest_witness_path(ControlFlowGraph::vertex_descriptor source,
+		ControlFlowGraph::vertex_descriptor sink,
+		std::deque<ControlFlowGraph::edge_descriptor> *witness)
+{
+	WitnessSearchState s;
+	std::deque<WitnessSearchQueueEntry> queue;
+	long sink_state = NOT_DISCOVERED;
+
+	// The outermost context is the Function containing the source vertex.
+	long root_context = s.AddContext(NO_CONTEXT, NULL, source->GetOwningFunction()->GetCFGPointer());
+	long root_state = s.GetState(root_context, source);
+
+	// The root is its own parent.
+	s.m_parent_state[root_state] = root_state;
+	queue.push_back(WitnessSearchQueueEntry(root_state, root_context, source));
+
+	if(source == sink)
+	{
+		sink_state = root_state;
+	}
+
+	while(!queue.empty() && sink_state == NOT_DISCOVERED)
+	{
+		WitnessSearchQueueEntry u = queue.front();
+		queue.pop_front();
+
+		StatementBase::out_edge_iterator ei, eend;
+		u.m_v->OutEdges(&ei, &eend);
+		for(; ei != eend; ++ei)
+		{
+			CFGEdgeTypeBase *e = *ei;
+			long v_context = u.m_context;
+
+			if(e->IsBackEdge() || e->IsImpossible() || e->IsType<CFGEdgeTypeFunctionCallBypass>())
+			{
+				continue;
+			}
+
+			CFGEdgeTypeFunctionCall *fc = dynamic_cast<CFGEdgeTypeFunctionCall*>(e);
+			if(fc != NULL)
+			{
+				if(s.FindContext(fc->m_function_call) != NO_CONTEXT)
+				{
+					// The callee has already been entered through this call, by a path no longer than this one.
+					// The call's fallthrough edge covers the rest.
+					continue;
+				}
+
+				v_context = s.AddContext(u.m_context, fc->m_function_call, fc->m_target_cfg);
+			}
+			else
+			{
+				CFGEdgeTypeReturn *ret = dynamic_cast<CFGEdgeTypeReturn*>(e);
+				if(ret != NULL)
+				{
+					if(ret->m_function_call != s.m_contexts[u.m_context].m_pushing_call)
+					{
+						// Not a return to the call which brought us here.
+						continue;
+					}
+
+					v_context = s.m_contexts[u.m_context].m_parent_context;
+				}
+			}
+
+			ControlFlowGraph::vertex_descriptor v = e->Target();
+			long v_state = s.GetState(v_context, v);
+
+			if(s.m_parent_state[v_state] != NOT_DISCOVERED)
+			{
+				// Already discovered by an equal or shorter path.
+				continue;
+			}
+
+			s.m_parent_state[v_state] = u.m_state;
+			s.m_parent_edge[v_state] = e;
+
+			if(v == sink)
+			{
+				sink_state = v_state;
+				break;
+			}
+
+			queue.push_back(WitnessSearchQueueEntry(v_state, v_context, v));
+		}
+	}
+
+	if(sink_state == NOT_DISCOVERED)
+	{
+		return false;
+	}
+
+	// Walk the parent links back to the root to recover the path.
+	std::deque<ControlFlowGraph::edge_descriptor> path;
+	for(long state = sink_state; state != root_state; state = s.m_parent_state[state])
+	{
+		path.push_front(s.m_parent_edge[state]);
+	}
+	witness->insert(witness->end(), path.begin(), path.end());
+
+	return true;
+}
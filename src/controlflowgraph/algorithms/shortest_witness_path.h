@@ -0,0 +1,58 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#ifndef SHORTEST_WITNESS_PATH_H
+#define SHORTEST_WITNESS_PATH_H
+
+#include <deque>
+
+#include "../ControlFlowGraph.h"
+
+/**
+ * Find a shortest interprocedurally-valid path from @a source to @a sink in the linked
+ * control flow graph of the program.
+ *
+ * The search is breadth-first over (vertex, call context) pairs.  The call context of a vertex is
+ * the resolved FunctionCall through which the search entered the vertex's Function, or the
+ * outermost context for the Function containing @a source.  Return edges are only followed when
+ * they match the call of the current context, and lead back to the context that call was made
+ * from, so the resulting path never returns to a call site it didn't come from.  The outermost
+ * context has no caller to return to.  Back edges, Impossible edges and FunctionCallBypass edges
+ * are ignored, as in ControlFlowGraphTraversalDFS.
+ *
+ * Each call site gets a single context, the first time the search reaches it.  Reaching the same
+ * call again later, from a different context, can't lead anywhere new by a shorter path: the
+ * callee has already been searched from an earlier point, and the call's own fallthrough edge
+ * reaches its return point directly.  The number of contexts is therefore bounded by the number
+ * of call sites, and recursion needs no special handling.
+ *
+ * Each context gets its own block of a flat parent-edge array, indexed by Vertex::GetIndex(), so
+ * there's no per-vertex allocation during the search.
+ *
+ * @param source The vertex to start the search from.  Its owning Function determines the outermost context.
+ * @param sink  The vertex to find.
+ * @param[out] witness  If a path is found, the edges of the path from @a source to @a sink, in order,
+ *   are appended to this deque.
+ * @return true if @a sink is reachable from @a source, false otherwise.
+ */
+bool shortest_witness_path(ControlFlowGraph::vertex_descriptor source,
+		ControlFlowGraph::vertex_descriptor sink,
+		std::deque<ControlFlowGraph::edge_descriptor> *witness);
+
+#endif // SHORTEST_WITNESS_PATH_H
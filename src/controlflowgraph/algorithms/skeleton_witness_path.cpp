@@ -0,0 +1,200 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/** @file */
+
+#include "skeleton_witness_path.h"
+
+#include <vector>
+
+#include <boost/foreach.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "../ControlFlowGraph.h"
+#include "../ReachabilitySkeleton.h"
+#include "../edges/edge_types.h"
+#include "../statements/Entry.h"
+#include "../statements/FunctionCall.h"
+#include "../../Function.h"
+
+/**
+ * @return The linked FunctionCall edge out of @a v, or NULL if @a v isn't a call or hasn't been linked.
+ */
+static CFGEdgeTypeFunctionCall* get_call_edge(ControlFlowGraph::vertex_descriptor v)
+{
+	if(!v->IsFunctionCall())
+	{
+		return NULL;
+	}
+
+	return v->GetFirstOutEdgeOfType<CFGEdgeTypeFunctionCall>();
+}
+
+/**
+ * Find the ControlFlowGraph edges making up skeleton edge @a u -> @a v, i.e. a shortest intraprocedural path from
+ * @a u to @a v which doesn't pass through any other FunctionCall, and append them to @a path.
+ *
+ * @return true if the path was found.
+ */
+static bool expand_skeleton_edge(ControlFlowGraph::vertex_descriptor u, ControlFlowGraph::vertex_descriptor v,
+		std::deque<ControlFlowGraph::edge_descriptor> *path)
+{
+	boost::unordered_map<ControlFlowGraph::vertex_descriptor, ControlFlowGraph::edge_descriptor> parent_edge;
+	std::deque<ControlFlowGraph::vertex_descriptor> queue;
+	bool found = false;
+
+	parent_edge[u] = NULL;
+	queue.push_back(u);
+
+	while(!queue.empty() && !found)
+	{
+		ControlFlowGraph::vertex_descriptor w = queue.front();
+		queue.pop_front();
+
+		StatementBase::out_edge_iterator ei, eend;
+		w->OutEdges(&ei, &eend);
+		for(; ei != eend; ++ei)
+		{
+			CFGEdgeTypeBase *e = *ei;
+
+			// Only the edges the skeleton was built from.
+			if(e->IsBackEdge() || e->IsImpossible() || e->IsType<CFGEdgeTypeFunctionCallBypass>()
+					|| e->IsType<CFGEdgeTypeFunctionCall>() || e->IsType<CFGEdgeTypeReturn>())
+			{
+				continue;
+			}
+
+			ControlFlowGraph::vertex_descriptor x = e->Target();
+			if(parent_edge.count(x) != 0)
+			{
+				continue;
+			}
+
+			parent_edge[x] = e;
+
+			if(x == v)
+			{
+				found = true;
+				break;
+			}
+
+			if(!x->IsFunctionCall())
+			{
+				// Don't go past any other calls.
+				queue.push_back(x);
+			}
+		}
+	}
+
+	if(!found)
+	{
+		return false;
+	}
+
+	std::deque<ControlFlowGraph::edge_descriptor> edges;
+	for(ControlFlowGraph::vertex_descriptor x = v; x != u; x = parent_edge[x]->Source())
+	{
+		edges.push_front(parent_edge[x]);
+	}
+	path->insert(path->end(), edges.begin(), edges.end());
+
+	return true;
+}
+
+bool skeleton_witness_path(ControlFlowGraph::vertex_descriptor source,
+		ControlFlowGraph::vertex_descriptor sink,
+		std::deque<ControlFlowGraph::edge_descriptor> *witness)
+{
+	// The skeleton vertex from which each skeleton vertex was first discovered.
+	boost::unordered_map<ControlFlowGraph::vertex_descriptor, ControlFlowGraph::vertex_descriptor> parent;
+	std::deque<ControlFlowGraph::vertex_descriptor> queue;
+	bool found = (source == sink);
+
+	// The root is its own parent.
+	parent[source] = source;
+	queue.push_back(source);
+
+	while(!queue.empty() && !found)
+	{
+		ControlFlowGraph::vertex_descriptor u = queue.front();
+		queue.pop_front();
+
+		// The skeleton successors, and the callee's Entry if this is a linked call.
+		std::vector<ControlFlowGraph::vertex_descriptor> next =
+				u->GetOwningFunction()->GetReachabilitySkeleton().GetSuccessors(u);
+		CFGEdgeTypeFunctionCall *call_edge = get_call_edge(u);
+		if(call_edge != NULL)
+		{
+			next.insert(next.begin(), call_edge->Target());
+		}
+
+		BOOST_FOREACH(ControlFlowGraph::vertex_descriptor v, next)
+		{
+			if(parent.count(v) != 0)
+			{
+				// Already discovered by a path with an equal or smaller number of skeleton edges.
+				continue;
+			}
+
+			parent[v] = u;
+
+			if(v == sink)
+			{
+				found = true;
+				break;
+			}
+
+			queue.push_back(v);
+		}
+	}
+
+	if(!found)
+	{
+		return false;
+	}
+
+	// Walk the parent links back to the root to recover the skeleton path.
+	std::deque<ControlFlowGraph::vertex_descriptor> skeleton_path;
+	for(ControlFlowGraph::vertex_descriptor v = sink; v != source; v = parent[v])
+	{
+		skeleton_path.push_front(v);
+	}
+	skeleton_path.push_front(source);
+
+	// Expand it into ControlFlowGraph edges.
+	std::deque<ControlFlowGraph::edge_descriptor> path;
+	for(std::size_t i = 1; i < skeleton_path.size(); ++i)
+	{
+		ControlFlowGraph::vertex_descriptor u = skeleton_path[i-1];
+		ControlFlowGraph::vertex_descriptor v = skeleton_path[i];
+
+		if(v->IsType<Entry>())
+		{
+			// Nothing within a Function leads to its Entry, so this is a call.
+			path.push_back(get_call_edge(u));
+		}
+		else if(!expand_skeleton_edge(u, v, &path))
+		{
+			// Shouldn't happen, the skeleton is built from the same edges.
+			return false;
+		}
+	}
+	witness->insert(witness->end(), path.begin(), path.end());
+
+	return true;
+}
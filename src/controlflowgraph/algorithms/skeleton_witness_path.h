@@ -0,0 +1,51 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/** @file */
+
+#ifndef SKELETON_WITNESS_PATH_H
+#define SKELETON_WITNESS_PATH_H
+
+#include <deque>
+
+#include "../ControlFlowGraph.h"
+
+/**
+ * Find a path from @a source to @a sink in the linked control flow graph of the program, searching only the
+ * ReachabilitySkeletons of the Functions involved.
+ *
+ * The search is breadth-first over the skeleton vertices, descending into a callee's skeleton at each resolved
+ * FunctionCall which has been linked.  A return never reaches anything the call's own skeleton successors don't, so
+ * return edges aren't needed, and each skeleton vertex only has to be visited once.  The result is the same
+ * reachability answer shortest_witness_path() would give, for a fraction of the work.  The path found has the fewest
+ * skeleton edges, which isn't necessarily the fewest ControlFlowGraph edges.
+ *
+ * Once @a sink has been found, each skeleton edge of the path is expanded back into the ControlFlowGraph edges it
+ * stands for, so the witness can be reported the same way as one from shortest_witness_path().
+ *
+ * @param source The vertex to start the search from.  Must be a vertex of its Function's ReachabilitySkeleton.
+ * @param sink  The vertex to find.  Must be a vertex of its Function's ReachabilitySkeleton.
+ * @param[out] witness  If a path is found, the edges of the path from @a source to @a sink, in order,
+ *   are appended to this deque.
+ * @return true if @a sink is reachable from @a source, false otherwise.
+ */
+bool skeleton_witness_path(ControlFlowGraph::vertex_descriptor source,
+		ControlFlowGraph::vertex_descriptor sink,
+		std::deque<ControlFlowGraph::edge_descriptor> *witness);
+
+#endif // SKELETON_WITNESS_PATH_H
@@ -21,16 +21,27 @@
 
 #include <boost/foreach.hpp>
 #include <boost/regex.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 
 #include "RuleBase.h"
 #include "RuleReachability.h"
+#include "ResultsSink.h"
 
 #include "Program.h"
+#include "ProgramImage.h"
 #include "Function.h"
 
 /// Regex for function-calls-function constraint "f1() -x f2()".
 static const boost::regex f_fxf_regex("([[:alpha:]_][[:alnum:]_]+)\\(\\) -x ([[:alpha:]_][[:alnum:]_]+)\\(\\)");
 
+/**
+ * @return The number of seconds since @a start.
+ */
+static double seconds_since(const boost::posix_time::ptime &start)
+{
+	return (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds() / 1.0e6;
+}
+
 Analyzer::Analyzer() { }
 
 Analyzer::Analyzer(const Analyzer& orig) { }
@@ -44,6 +55,10 @@ void Analyzer::AddConstraints(const std::vector< std::string > &vector_of_constr
 	std::cerr << "INFO: Adding constraints..." << std::endl;
 	BOOST_FOREACH(std::string s, vector_of_constraint_strings)
 	{
+		Constraint constraint;
+		constraint.m_text = s;
+		constraint.m_rule = NULL;
+
 		// Parse the next constraint.
 		if(boost::regex_match(s.c_str(), capture_results, f_fxf_regex))
 		{
@@ -56,36 +71,167 @@ void Analyzer::AddConstraints(const std::vector< std::string > &vector_of_constr
 			if(f1 == NULL)
 			{
 				std::cerr << "ERROR: Can't find function: " << capture_results[1] << std::endl;
+				constraint.m_error = "Can't find function: " + capture_results[1];
 			}
 			else if(f2 == NULL)
 			{
 				std::cerr << "ERROR: Can't find function: " << capture_results[2] << std::endl;
+				constraint.m_error = "Can't find function: " + capture_results[2];
 			}
 			else
 			{
 				std::cerr << "INFO: Adding constraint: "
 						<< f1->GetIdentifier() << "() -x "
 						<< f2->GetIdentifier() << "()" << std::endl;
-				RuleReachability *rule = new RuleReachability(*m_program->GetControlFlowGraphPtr(), f1, f2);
-				m_constraints.push_back(rule);
+
+				// Only the Functions on some call path from f1 to f2 can matter to the search, so only build those.
+				long slice_size = m_program->MaterializeCallPaths(f1, f2);
+				std::cerr << "INFO: Constraint depends on " << slice_size << " of "
+						<< m_program->GetNumberOfFunctionDefinitions() << " functions." << std::endl;
+
+				constraint.m_rule = new RuleReachability(*m_program->GetControlFlowGraphPtr(), f1, f2);
 			}
 		}
 		else
 		{
 			std::cerr << "ERROR: Can't parse constraint: " << s << std::endl;
+			constraint.m_error = "Can't parse constraint";
 		}
+
+		m_constraints.push_back(constraint);
 	}
 }
 
-bool Analyzer::Analyze()
+bool Analyzer::Analyze(ResultsSink *sink)
 {
+	bool retval = true;
+
+	sink->Begin();
+
 	// Run all analyses.
-	BOOST_FOREACH(RuleBase *constraint, m_constraints)
+	BOOST_FOREACH(const Constraint &constraint, m_constraints)
 	{
-		constraint->RunRule();
+		RuleResult result;
+		result.m_constraint = constraint.m_text;
+
+		if(constraint.m_rule == NULL)
+		{
+			result.m_message = constraint.m_error;
+			retval = false;
+		}
+		else
+		{
+			boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+			if(!constraint.m_rule->RunRule(&result))
+			{
+				retval = false;
+			}
+			result.m_seconds = seconds_since(start);
+		}
+
+		sink->Write(result);
 	}
 
-	/// @todo Make this real.
-	return true;
+	sink->End();
+
+	return retval;
+}
+
+bool Analyzer::AnalyzeImage(const ProgramImage &image, const std::vector< std::string > &vector_of_constraint_strings,
+		ResultsSink *sink)
+{
+	boost::cmatch capture_results;
+	bool retval = true;
+
+	sink->Begin();
+
+	BOOST_FOREACH(std::string s, vector_of_constraint_strings)
+	{
+		RuleResult result;
+		result.m_constraint = s;
+
+		if(!boost::regex_match(s.c_str(), capture_results, f_fxf_regex))
+		{
+			std::cerr << "ERROR: Can't parse constraint: " << s << std::endl;
+			result.m_message = "Can't parse constraint";
+			sink->Write(result);
+			retval = false;
+			continue;
+		}
+
+		ProgramImage::function_index_type f1 = image.LookupFunction(capture_results[1]);
+		ProgramImage::function_index_type f2 = image.LookupFunction(capture_results[2]);
+
+		if(f1 == ProgramImage::NO_FUNCTION)
+		{
+			std::cerr << "ERROR: Can't find function: " << capture_results[1] << std::endl;
+			result.m_message = "Can't find function: " + capture_results[1];
+			sink->Write(result);
+			retval = false;
+			continue;
+		}
+		else if(f2 == ProgramImage::NO_FUNCTION)
+		{
+			std::cerr << "ERROR: Can't find function: " << capture_results[2] << std::endl;
+			result.m_message = "Can't find function: " + capture_results[2];
+			sink->Write(result);
+			retval = false;
+			continue;
+		}
+
+		boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+		const ProgramImage::ImageFunction &source = image.GetFunction(f1);
+		std::vector<ProgramImage::vertex_type> path;
+
+		if(!image.FindPath(f1, f2, &path))
+		{
+			result.m_status = RuleResult::NOT_VIOLATED;
+			result.m_seconds = seconds_since(start);
+			sink->Write(result);
+			continue;
+		}
+
+		// The path ends at the sink's Entry, so the violating statement is the call just before it.  A Function
+		// trivially reaches itself, and then, as in RuleReachability, the violating statement is its Entry.
+		const ProgramImage::ImageVertex &violating = image.GetVertex(path[(path.size() < 2) ? 0 : path.size()-2]);
+		result.m_status = RuleResult::VIOLATED;
+		result.m_function = source.m_identifier;
+		result.m_function_file_path = source.m_definition_file_path;
+		result.m_location = violating.m_location;
+		if(violating.m_kind == ProgramImage::ImageVertex::CALL)
+		{
+			result.m_statement = violating.m_identifier + "( " + violating.m_params + " )";
+		}
+		else
+		{
+			result.m_statement = "ENTRY";
+		}
+
+		// Collect the call chain, one level deeper for each Function entered, as RuleReachability does.
+		long depth = 0;
+		BOOST_FOREACH(const ProgramImage::vertex_type &v, path)
+		{
+			const ProgramImage::ImageVertex &iv = image.GetVertex(v);
+			if(iv.m_kind == ProgramImage::ImageVertex::ENTRY)
+			{
+				depth++;
+			}
+			else if(iv.m_kind == ProgramImage::ImageVertex::CALL)
+			{
+				WitnessStep step;
+				step.m_location = iv.m_location;
+				step.m_text = iv.m_identifier + "( " + iv.m_params + " )";
+				step.m_depth = depth;
+				result.m_witness.push_back(step);
+			}
+		}
+
+		result.m_seconds = seconds_since(start);
+		sink->Write(result);
+	}
+
+	sink->End();
+
+	return retval;
 }
 
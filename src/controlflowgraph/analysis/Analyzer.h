@@ -26,6 +26,8 @@
 #include "../ControlFlowGraph.h"
 
 class Program;
+class ProgramImage;
+class ResultsSink;
 class RuleBase;
 
 class Analyzer
@@ -40,15 +42,45 @@ public:
 	
 	void AttachToProgram(Program *p) { m_program = p; };
 	
-	bool Analyze();
+	/**
+	 * Check the constraints added by AddConstraints(), writing each one's result to @a sink as soon as it's known.
+	 *
+	 * @return true if all the constraints could be checked.
+	 */
+	bool Analyze(ResultsSink *sink);
+
+	/**
+	 * Check the constraints in @a vector_of_constraint_strings against the linked ProgramImage @a image, as
+	 * "coflo --merge" does.  The image only has the Functions' reachability skeletons, so a violation is reported as
+	 * the chain of calls leading to it, without the decisions taken along the way.  Otherwise the results are the same
+	 * as Analyze() would give, including a constraint whose two functions are the same being violated.
+	 *
+	 * @param sink  Where to write each constraint's result.
+	 * @return true if all the constraints could be checked.
+	 */
+	bool AnalyzeImage(const ProgramImage &image, const std::vector< std::string > &vector_of_constraint_strings,
+			ResultsSink *sink);
 	
 private:
 
+	/// A constraint added by AddConstraints().
+	struct Constraint
+	{
+		/// The constraint as given.
+		std::string m_text;
+
+		/// The rule which checks it, or NULL if it couldn't be set up.
+		RuleBase *m_rule;
+
+		/// If m_rule is NULL, why.
+		std::string m_error;
+	};
+
 	/// Pointer to the program to analyze.
 	Program *m_program;
 	
 	/// The list of constraints to check m_program against.
-	std::vector< RuleBase* > m_constraints;
+	std::vector< Constraint > m_constraints;
 };
 
 #endif	/* ANALYZER_H */
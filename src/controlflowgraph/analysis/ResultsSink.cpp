@@ -0,0 +1,284 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "ResultsSink.h"
+
+#include <iostream>
+#include <fstream>
+
+#include <boost/foreach.hpp>
+
+// Include the config.h file generated by configure.
+#include "../config.h"
+
+#include "JSON.h"
+#include "debug_utils/output_sink.hpp"
+
+/// The id of the reachability rule in SARIF output.
+static const char f_reachability_rule_id[] = "coflo-reachability";
+
+/**
+ * Write @a location as a JSON object with "file", "line" and, if it has one, "column" members.
+ */
+static void write_json_location(std::ostream &os, const Location &location)
+{
+	os << "{\"file\":" << json_quote(location.GetPassedFilePath()) << ",\"line\":" << location.GetLineNumber();
+	if(location.GetColumn() != -1)
+	{
+		os << ",\"column\":" << location.GetColumn();
+	}
+	os << "}";
+}
+
+/**
+ * Write @a location as a SARIF physicalLocation object.  SARIF line and column numbers start at 1, so any which
+ * aren't known are left out.
+ */
+static void write_sarif_physical_location(std::ostream &os, const Location &location)
+{
+	os << "{\"artifactLocation\":{\"uri\":" << json_quote(location.GetPassedFilePath()) << "}";
+	if(location.GetLineNumber() > 0)
+	{
+		os << ",\"region\":{\"startLine\":" << location.GetLineNumber();
+		if(location.GetColumn() > 0)
+		{
+			os << ",\"startColumn\":" << location.GetColumn();
+		}
+		os << "}";
+	}
+	os << "}";
+}
+
+ResultsSink::ResultsSink(output_sink &sink) : m_sink(&sink), m_owned_file(NULL), m_owned_sink(NULL)
+{
+}
+
+ResultsSink::~ResultsSink()
+{
+	delete m_owned_sink;
+	delete m_owned_file;
+}
+
+ResultsSink* ResultsSink::Create(const std::string &format, const std::string &path)
+{
+	std::ofstream *file = NULL;
+	output_sink *sink = &output_sink::standard_output();
+	ResultsSink *retval;
+
+	if((format != "text") && (format != "ndjson") && (format != "sarif"))
+	{
+		std::cerr << "ERROR: Unknown results format \"" << format << "\"." << std::endl;
+		return NULL;
+	}
+
+	if(!path.empty())
+	{
+		file = new std::ofstream(path.c_str(), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+		if(!file->is_open())
+		{
+			std::cerr << "ERROR: Couldn't open results file \"" << path << "\"." << std::endl;
+			delete file;
+			return NULL;
+		}
+		sink = new output_sink(*file);
+	}
+
+	if(format == "text")
+	{
+		retval = new TextResultsSink(*sink);
+	}
+	else if(format == "ndjson")
+	{
+		retval = new NDJSONResultsSink(*sink);
+	}
+	else
+	{
+		retval = new SARIFResultsSink(*sink);
+	}
+
+	if(file != NULL)
+	{
+		retval->m_owned_file = file;
+		retval->m_owned_sink = sink;
+	}
+
+	return retval;
+}
+
+void ResultsSink::Begin()
+{
+	FormatBegin(m_buffer);
+	Commit();
+}
+
+void ResultsSink::Write(const RuleResult &result)
+{
+	FormatResult(m_buffer, result);
+	Commit();
+}
+
+void ResultsSink::End()
+{
+	FormatEnd(m_buffer);
+	Commit();
+}
+
+const char* ResultsSink::GetStatusName(RuleResult::Status status)
+{
+	switch(status)
+	{
+		case RuleResult::VIOLATED: return "violated";
+		case RuleResult::NOT_VIOLATED: return "not_violated";
+		default: return "inconclusive";
+	}
+}
+
+void ResultsSink::Commit()
+{
+	const std::string &record = m_buffer.str();
+
+	if(!record.empty())
+	{
+		m_sink->write(record.data(), record.size());
+	}
+	m_buffer.str("");
+}
+
+void TextResultsSink::FormatResult(std::ostream &os, const RuleResult &result)
+{
+	switch(result.m_status)
+	{
+		case RuleResult::VIOLATED:
+		{
+			std::string location = result.m_location.asGNUCompilerMessageLocation();
+			os << result.m_function_file_path << ": In function " << result.m_function << ":\n";
+			os << location << ": warning: constraint violation: path exists in control flow graph to "
+					<< result.m_statement << "\n";
+			os << location << ": warning: violating path follows\n";
+			BOOST_FOREACH(const WitnessStep &step, result.m_witness)
+			{
+				os << step.m_location.asGNUCompilerMessageLocation() << ": warning: ";
+				for(long i = 0; i < step.m_depth; ++i)
+				{
+					os << "    ";
+				}
+				os << step.m_text << "\n";
+			}
+			break;
+		}
+		case RuleResult::NOT_VIOLATED:
+			os << "Couldn't find a violation of constraint: " << result.m_constraint << "\n";
+			break;
+		default:
+			os << "Couldn't check constraint: " << result.m_constraint << ": " << result.m_message << "\n";
+			break;
+	}
+}
+
+void NDJSONResultsSink::FormatResult(std::ostream &os, const RuleResult &result)
+{
+	os << "{\"constraint\":" << json_quote(result.m_constraint)
+			<< ",\"status\":\"" << GetStatusName(result.m_status) << "\""
+			<< ",\"seconds\":" << result.m_seconds;
+
+	if(result.m_status == RuleResult::VIOLATED)
+	{
+		os << ",\"function\":" << json_quote(result.m_function)
+				<< ",\"function_file\":" << json_quote(result.m_function_file_path)
+				<< ",\"location\":";
+		write_json_location(os, result.m_location);
+		os << ",\"statement\":" << json_quote(result.m_statement) << ",\"witness\":[";
+		for(std::size_t i = 0; i < result.m_witness.size(); ++i)
+		{
+			const WitnessStep &step = result.m_witness[i];
+			os << (i == 0 ? "" : ",") << "{\"location\":";
+			write_json_location(os, step.m_location);
+			os << ",\"depth\":" << step.m_depth << ",\"text\":" << json_quote(step.m_text) << "}";
+		}
+		os << "]";
+	}
+	else if(result.m_status == RuleResult::INCONCLUSIVE)
+	{
+		os << ",\"message\":" << json_quote(result.m_message);
+	}
+
+	os << "}\n";
+}
+
+void SARIFResultsSink::FormatBegin(std::ostream &os)
+{
+	os << "{\"version\":\"2.1.0\",\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\",\"runs\":[{"
+			"\"tool\":{\"driver\":{\"name\":" << json_quote(PACKAGE_NAME) << ",\"version\":" << json_quote(PACKAGE_VERSION)
+			<< ",\"informationUri\":" << json_quote(PACKAGE_URL)
+			<< ",\"rules\":[{\"id\":\"" << f_reachability_rule_id << "\",\"shortDescription\":{\"text\":"
+			"\"A function must not be able to reach another function.\"}}]}},\n\"results\":[\n";
+}
+
+void SARIFResultsSink::FormatResult(std::ostream &os, const RuleResult &result)
+{
+	if(m_num_results > 0)
+	{
+		os << ",\n";
+	}
+	++m_num_results;
+
+	os << "{\"ruleId\":\"" << f_reachability_rule_id << "\"";
+
+	switch(result.m_status)
+	{
+		case RuleResult::VIOLATED:
+		{
+			os << ",\"kind\":\"fail\",\"level\":\"warning\",\"message\":{\"text\":"
+					<< json_quote("constraint violation: path exists in control flow graph to " + result.m_statement)
+					<< "},\"locations\":[{\"physicalLocation\":";
+			write_sarif_physical_location(os, result.m_location);
+			os << "}],\"codeFlows\":[{\"threadFlows\":[{\"locations\":[";
+			for(std::size_t i = 0; i < result.m_witness.size(); ++i)
+			{
+				const WitnessStep &step = result.m_witness[i];
+				os << (i == 0 ? "" : ",") << "{\"location\":{\"physicalLocation\":";
+				write_sarif_physical_location(os, step.m_location);
+				os << ",\"message\":{\"text\":" << json_quote(step.m_text) << "}},\"nestingLevel\":" << step.m_depth << "}";
+			}
+			os << "]}]}]";
+			break;
+		}
+		case RuleResult::NOT_VIOLATED:
+			os << ",\"kind\":\"pass\",\"level\":\"none\",\"message\":{\"text\":"
+					<< json_quote("No violation of constraint: " + result.m_constraint) << "}";
+			break;
+		default:
+			os << ",\"kind\":\"open\",\"level\":\"none\",\"message\":{\"text\":"
+					<< json_quote("Couldn't check constraint: " + result.m_constraint + ": " + result.m_message) << "}";
+			break;
+	}
+
+	os << ",\"properties\":{\"constraint\":" << json_quote(result.m_constraint)
+			<< ",\"status\":\"" << GetStatusName(result.m_status) << "\",\"seconds\":" << result.m_seconds;
+	if(result.m_status == RuleResult::VIOLATED)
+	{
+		os << ",\"function\":" << json_quote(result.m_function);
+	}
+	os << "}}";
+}
+
+void SARIFResultsSink::FormatEnd(std::ostream &os)
+{
+	os << "\n]}]}\n";
+}
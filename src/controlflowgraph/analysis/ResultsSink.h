@@ -0,0 +1,198 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#ifndef RESULTSSINK_H
+#define RESULTSSINK_H
+
+#include <iosfwd>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Location.h"
+
+class output_sink;
+
+/**
+ * One step of the witness path of a constraint violation: a function call, or a decision and the way it went.
+ *
+ * Only results checked against the control flow graphs themselves have decision steps.  The shard images
+ * "coflo --merge" checks hold just the calls, so its witnesses are the call chain alone.
+ */
+struct WitnessStep
+{
+	WitnessStep() : m_depth(0) {};
+
+	Location m_location;
+
+	/// The statement, as text.
+	std::string m_text;
+
+	/// How many Functions deep into the call chain the statement is, 1 being the Function the path starts in.
+	long m_depth;
+};
+
+/**
+ * The outcome of checking one constraint.
+ */
+struct RuleResult
+{
+	enum Status
+	{
+		/// A violation was found.
+		VIOLATED,
+		/// The constraint holds.
+		NOT_VIOLATED,
+		/// The constraint couldn't be checked, e.g. because a function it names doesn't exist.
+		INCONCLUSIVE
+	};
+
+	RuleResult() : m_status(INCONCLUSIVE), m_seconds(0) {};
+
+	/// The constraint, as given on the command line.
+	std::string m_constraint;
+
+	Status m_status;
+
+	/// For inconclusive results, why.
+	std::string m_message;
+
+	/// @name For violations.
+	//@{
+	/// The Function the violating path starts in, and the file it's defined in.
+	std::string m_function;
+	std::string m_function_file_path;
+
+	/// The location and text of the violating statement.
+	Location m_location;
+	std::string m_statement;
+
+	/// The violating path, from m_function to the violating statement.
+	std::vector<WitnessStep> m_witness;
+	//@}
+
+	/// How long the check took, in seconds.
+	double m_seconds;
+};
+
+/**
+ * Abstract base class for the writers of constraint-checking results.
+ *
+ * Each RuleResult is formatted into an in-memory buffer and handed to the output_sink in a single write, which is
+ * flushed as soon as the result is complete.  A consumer reading the output as it's produced sees each rule's result
+ * as soon as the rule finishes, without the output being flushed once per line.
+ */
+class ResultsSink
+{
+public:
+	virtual ~ResultsSink();
+
+	/**
+	 * Create a sink writing results in the given format.
+	 *
+	 * @param format  "text", "ndjson" or "sarif".
+	 * @param path  The file to write to, or empty for standard output.
+	 * @return The new sink, or NULL if @a format isn't known or the file can't be opened.
+	 */
+	static ResultsSink* Create(const std::string &format, const std::string &path);
+
+	/// Start the output.  Must be called once, before any Write().
+	void Begin();
+
+	/// Write the result of one rule.
+	void Write(const RuleResult &result);
+
+	/// Finish the output.  Must be called once, after the last Write().
+	void End();
+
+protected:
+
+	/// Construct a sink writing to @a sink.
+	explicit ResultsSink(output_sink &sink);
+
+	/// @name Formatting hooks for the derived classes.  Each appends its output to @a os.
+	//@{
+	virtual void FormatBegin(std::ostream &/*os*/) {};
+	virtual void FormatResult(std::ostream &os, const RuleResult &result) = 0;
+	virtual void FormatEnd(std::ostream &/*os*/) {};
+	//@}
+
+	/// @return The name of @a status, as used in the machine-readable formats.
+	static const char* GetStatusName(RuleResult::Status status);
+
+private:
+
+	/// Write out whatever's in m_buffer.
+	void Commit();
+
+	/// Where the results go.
+	output_sink *m_sink;
+
+	/// If the results go to a file, the file and its output_sink.
+	std::ofstream *m_owned_file;
+	output_sink *m_owned_sink;
+
+	/// The output of the record currently being formatted.
+	std::ostringstream m_buffer;
+};
+
+/**
+ * Writes results as gcc-style warning text.
+ */
+class TextResultsSink : public ResultsSink
+{
+public:
+	explicit TextResultsSink(output_sink &sink) : ResultsSink(sink) {};
+
+protected:
+	virtual void FormatResult(std::ostream &os, const RuleResult &result);
+};
+
+/**
+ * Writes results as newline-delimited JSON, one object per rule.
+ */
+class NDJSONResultsSink : public ResultsSink
+{
+public:
+	explicit NDJSONResultsSink(output_sink &sink) : ResultsSink(sink) {};
+
+protected:
+	virtual void FormatResult(std::ostream &os, const RuleResult &result);
+};
+
+/**
+ * Writes results as a SARIF 2.1.0 log, with one run whose results are added as each rule finishes.
+ */
+class SARIFResultsSink : public ResultsSink
+{
+public:
+	explicit SARIFResultsSink(output_sink &sink) : ResultsSink(sink), m_num_results(0) {};
+
+protected:
+	virtual void FormatBegin(std::ostream &os);
+	virtual void FormatResult(std::ostream &os, const RuleResult &result);
+	virtual void FormatEnd(std::ostream &os);
+
+private:
+
+	/// Number of results written so far, for separating them.
+	long m_num_results;
+};
+
+#endif /* RESULTSSINK_H */
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+#include "ResultsSink.h"
+#include "debug_utils/output_sink.hpp"
+
+/// A violation of "a() -x c()", through a call to b() which calls c().
+static RuleResult make_violation()
+{
+	RuleResult result;
+	WitnessStep step;
+
+	result.m_constraint = "a() -x c()";
+	result.m_status = RuleResult::VIOLATED;
+	result.m_function = "a";
+	result.m_function_file_path = "a.c";
+	result.m_location = Location("b.c", 7, 2);
+	result.m_statement = "c( \"x\" )";
+	result.m_seconds = 0.5;
+
+	step.m_location = Location("a.c", 3, 5);
+	step.m_text = "b(  )";
+	step.m_depth = 1;
+	result.m_witness.push_back(step);
+	step.m_location = Location("b.c", 7, 2);
+	step.m_text = "c( \"x\" )";
+	step.m_depth = 2;
+	result.m_witness.push_back(step);
+
+	return result;
+}
+
+TEST(ResultsSinkTest, TextMatchesCompilerWarnings)
+{
+	std::ostringstream out;
+	output_sink out_sink(out);
+	TextResultsSink sink(out_sink);
+	RuleResult holds;
+
+	holds.m_constraint = "c() -x a()";
+	holds.m_status = RuleResult::NOT_VIOLATED;
+
+	sink.Begin();
+	sink.Write(make_violation());
+	sink.Write(holds);
+	sink.End();
+
+	ASSERT_EQ("a.c: In function a:\n"
+			"b.c:7:2: warning: constraint violation: path exists in control flow graph to c( \"x\" )\n"
+			"b.c:7:2: warning: violating path follows\n"
+			"a.c:3:5: warning:     b(  )\n"
+			"b.c:7:2: warning:         c( \"x\" )\n"
+			"Couldn't find a violation of constraint: c() -x a()\n", out.str());
+}
+
+TEST(ResultsSinkTest, NDJSONWritesOneRecordPerLine)
+{
+	std::ostringstream out;
+	output_sink out_sink(out);
+	NDJSONResultsSink sink(out_sink);
+	RuleResult inconclusive;
+
+	inconclusive.m_constraint = "a() -x missing()";
+	inconclusive.m_message = "Can't find function: missing";
+
+	sink.Begin();
+	sink.Write(make_violation());
+	// Each record is written as soon as it's complete.
+	std::string first_record = out.str();
+	ASSERT_EQ(1, std::count(first_record.begin(), first_record.end(), '\n'));
+	sink.Write(inconclusive);
+	sink.End();
+
+	std::istringstream lines(out.str());
+	std::string line;
+	std::getline(lines, line);
+	ASSERT_EQ("{\"constraint\":\"a() -x c()\",\"status\":\"violated\",\"seconds\":0.5,\"function\":\"a\",\"function_file\":\"a.c\","
+			"\"location\":{\"file\":\"b.c\",\"line\":7,\"column\":2},\"statement\":\"c( \\\"x\\\" )\",\"witness\":["
+			"{\"location\":{\"file\":\"a.c\",\"line\":3,\"column\":5},\"depth\":1,\"text\":\"b(  )\"},"
+			"{\"location\":{\"file\":\"b.c\",\"line\":7,\"column\":2},\"depth\":2,\"text\":\"c( \\\"x\\\" )\"}]}", line);
+	std::getline(lines, line);
+	ASSERT_EQ("{\"constraint\":\"a() -x missing()\",\"status\":\"inconclusive\",\"seconds\":0,"
+			"\"message\":\"Can't find function: missing\"}", line);
+	ASSERT_FALSE(std::getline(lines, line));
+}
+
+TEST(ResultsSinkTest, SARIFSeparatesAndClosesResults)
+{
+	std::ostringstream out;
+	output_sink out_sink(out);
+	SARIFResultsSink sink(out_sink);
+	RuleResult holds;
+
+	holds.m_constraint = "c() -x a()";
+	holds.m_status = RuleResult::NOT_VIOLATED;
+
+	sink.Begin();
+	sink.Write(make_violation());
+	sink.Write(holds);
+	sink.End();
+
+	std::string log = out.str();
+	ASSERT_EQ(0U, log.find("{\"version\":\"2.1.0\""));
+	ASSERT_NE(std::string::npos, log.find("\"kind\":\"fail\",\"level\":\"warning\""));
+	ASSERT_NE(std::string::npos, log.find("\"threadFlows\":[{\"locations\":[{\"location\":{\"physicalLocation\":"
+			"{\"artifactLocation\":{\"uri\":\"a.c\"},\"region\":{\"startLine\":3,\"startColumn\":5}}"));
+	ASSERT_NE(std::string::npos, log.find("}},\n{\"ruleId\":\"coflo-reachability\",\"kind\":\"pass\""));
+	ASSERT_EQ(log.size() - 6, log.rfind("\n]}]}\n"));
+}
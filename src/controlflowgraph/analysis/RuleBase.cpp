@@ -28,12 +28,3 @@ RuleBase::RuleBase(const RuleBase& orig)
 RuleBase::~RuleBase()
 {
 }
-
-void RuleBase::indent(long i)
-{
-	while (i > 0)
-	{
-		std::cout << "    ";
-		i--;
-	};
-}
@@ -20,6 +20,8 @@
 
 #include "../ControlFlowGraph.h"
 
+struct RuleResult;
+
 /**
  * Abstract base class for all rules.
  */
@@ -31,12 +33,16 @@ public:
 	RuleBase(const RuleBase& orig);
 	virtual ~RuleBase();
 	
-	virtual bool RunRule() = 0;
+	/**
+	 * Check the rule.
+	 *
+	 * @param[out] result  The outcome.  Everything but the constraint text and the timing is filled in.
+	 * @return true if the rule could be checked.
+	 */
+	virtual bool RunRule(RuleResult *result) = 0;
 	
 protected:
 
-	static void indent(long i);
-
 private:
 
 };
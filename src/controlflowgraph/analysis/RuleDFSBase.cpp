@@ -36,7 +36,7 @@ RuleDFSBase::~RuleDFSBase()
 }
 
 
-bool RuleDFSBase::RunRule()
+bool RuleDFSBase::RunRule(RuleResult */*result*/)
 {
 	return true;
 }
@@ -37,7 +37,7 @@ public:
 	
 	void SetSinkVertex(T_CFG_VERTEX_DESC sink) { m_sink = sink; };
 	
-	bool RunRule();
+	bool RunRule(RuleResult *result);
 	
 protected:
 	
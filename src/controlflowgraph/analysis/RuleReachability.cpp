@@ -25,8 +25,8 @@
 #include <boost/foreach.hpp>
 
 #include "../ControlFlowGraph.h"
-#include "../ControlFlowGraphTraversalDFS.h"
-#include "../visitors/ReachabilityVisitor.h"
+#include "../algorithms/shortest_witness_path.h"
+#include "../algorithms/skeleton_witness_path.h"
 #include "../statements/Entry.h"
 #include "../edges/CFGEdgeTypeBase.h"
 #include "Function.h"
@@ -48,71 +48,51 @@ RuleReachability::~RuleReachability()
 {
 }
 
-/**
- * This is the predicate which will be called by the ReachabilityVisitor as it visits each vertex.
- * It will return true to indicate that the target vertex was discovered.
- */
-struct ReachabilityPredicateSpecificVertex
-{
-	ReachabilityPredicateSpecificVertex(ControlFlowGraph::vertex_descriptor sink) { m_sink = sink; };
-
-	bool operator()(ControlFlowGraph &cfg, ControlFlowGraph::vertex_descriptor v)
-	{
-		if(v == m_sink)
-		{
-			return true;
-		}
-
-		return false;
-	}
-
-	/// The vertex we're trying to find.
-	ControlFlowGraph::vertex_descriptor m_sink;
-};
-
-bool RuleReachability::RunRule()
+bool RuleReachability::RunRule(RuleResult *result)
 {
 	ControlFlowGraph::vertex_descriptor starting_vertex_desc;
 
 	// Get the starting vertex.
 	starting_vertex_desc = m_source->GetEntryVertexDescriptor();
 
-	// Push a fake edge onto the predecessor stack, since our last vertex will try to pop it.
+	// Push a fake edge onto the front of the witness path, so that the call chain starts in the source Function.
 	m_predecessors.push_back(m_source->GetEntrySelfEdgeDescriptor());
 
-	// Set up a visitor.
-	ReachabilityPredicateSpecificVertex pred(m_sink->GetEntryVertexDescriptor());
-	ReachabilityVisitor v(m_cfg, starting_vertex_desc, pred, &m_predecessors);
-
-	// Create a depth-first-search graph traversal object.
-	ControlFlowGraphTraversalDFS traversal(m_cfg);
-
-	// Traverse the CFG.
-	traversal.Traverse(starting_vertex_desc, &v);
+	// Search the Functions' reachability skeletons breadth-first for a path to the sink.  Most constraints aren't
+	// violated, and this answers those for a fraction of the cost of a search of the whole graph.  Only a violation
+	// needs the full search, to find the shortest witness to report.
+	std::deque<ControlFlowGraph::edge_descriptor> skeleton_witness;
+	if(!skeleton_witness_path(starting_vertex_desc, m_sink->GetEntryVertexDescriptor(), &skeleton_witness))
+	{
+		// No path, so no violation.
+		m_predecessors.clear();
+	}
+	else if(!shortest_witness_path(starting_vertex_desc, m_sink->GetEntryVertexDescriptor(), &m_predecessors))
+	{
+		// The skeleton path has the fewest calls rather than the fewest statements, but it's still a valid witness.
+		m_predecessors.insert(m_predecessors.end(), skeleton_witness.begin(), skeleton_witness.end());
+	}
 
 	if(!m_predecessors.empty())
 	{
 		//StatementBase *violating_statement = m_cfg.GetStatementPtr(m_predecessors.rbegin()->m_source);
 		StatementBase *violating_statement = (*(m_predecessors.rbegin()))->Source();
-		std::cout << m_source->GetDefinitionFilePath() << ": In function " << m_source->GetIdentifier() << ":" << std::endl;
-		std::cout << violating_statement->GetLocation().asGNUCompilerMessageLocation()
-				<< ": warning: constraint violation: path exists in control flow graph to " << violating_statement->GetIdentifierCFG() << std::endl;
-		std::cout << violating_statement->GetLocation().asGNUCompilerMessageLocation() << ": warning: violating path follows" << std::endl;
-		PrintCallChain();
+		result->m_status = RuleResult::VIOLATED;
+		result->m_function = m_source->GetIdentifier();
+		result->m_function_file_path = m_source->GetDefinitionFilePath();
+		result->m_location = violating_statement->GetLocation();
+		result->m_statement = violating_statement->GetIdentifierCFG();
+		CollectCallChain(&result->m_witness);
 	}
 	else
 	{
-		std::cout << "Couldn't find a violation of constraint: "
-				<< m_source->GetIdentifier()
-				<< "() -x "
-				<< m_sink->GetIdentifier() << "()"
-				<< std::endl;
+		result->m_status = RuleResult::NOT_VIOLATED;
 	}
 
 	return true;
 }
 
-void RuleReachability::PrintCallChain()
+void RuleReachability::CollectCallChain(std::vector<WitnessStep> *witness)
 {
 	long indent_level = 0;
 	long bypass_call_depth = 0;
@@ -128,7 +108,7 @@ void RuleReachability::PrintCallChain()
 		//StatementBase *sb = m_cfg.GetStatementPtr(pred.m_source);
 		StatementBase *sb = pred->Source();
 
-		if (sb->IsType<FunctionCallUnresolved>())
+		if (sb->IsType<FunctionCall>() && !dynamic_cast<FunctionCall*>(sb)->IsResolved())
 		{
 			// By definition, unresolved calls will never be in our call stack.
 			continue;
@@ -170,39 +150,36 @@ void RuleReachability::PrintCallChain()
 		StatementBase *sb = pred->Source();
 		if(sb->IsType<FunctionCall>())
 		{
-			PrintStatement(sb, indent_level);
+			AddWitnessStep(sb, NULL, indent_level, witness);
 		}
 		else if(sb->IsDecisionStatement())
 		{
 			// It's a decision statement
-			//PrintStatement(sb, m_cfg.GetEdgeTypePtr(pred), indent_level);
-			PrintStatement(sb, pred, indent_level);
-		}
-		else if(sb->IsType<Entry>())
-		{
-			indent_level++;
+			AddWitnessStep(sb, pred, indent_level, witness);
 		}
 		else if(sb->IsType<Exit>())
 		{
 			indent_level--;
 		}
-	}
-}
 
-void RuleReachability::PrintStatement(StatementBase *fc, long indent_level)
-{
-	std::cout << fc->GetLocation().asGNUCompilerMessageLocation() << ": warning: ";
-	indent(indent_level);
-	std::cout << fc->GetIdentifierCFG() << std::endl;
+		// Each edge into an Entry, starting with the fake one into the source Function, takes the chain a level deeper.
+		if(pred->Target()->IsType<Entry>())
+		{
+			indent_level++;
+		}
+	}
 }
 
-void RuleReachability::PrintStatement(StatementBase *sb, CFGEdgeTypeBase *eb, long  indent_level)
+void RuleReachability::AddWitnessStep(StatementBase *sb, CFGEdgeTypeBase *eb, long depth, std::vector<WitnessStep> *witness)
 {
-	std::cout << sb->GetLocation().asGNUCompilerMessageLocation() << ": warning: ";
-	indent(indent_level);
-	std::cout << sb->GetIdentifierCFG() << ", taking out edge \"" << eb->GetLabel() << "\"" << std::endl;
-}
-
-
-
+	WitnessStep step;
 
+	step.m_location = sb->GetLocation();
+	step.m_text = sb->GetIdentifierCFG();
+	if(eb != NULL)
+	{
+		step.m_text += ", taking out edge \"" + eb->GetLabel() + "\"";
+	}
+	step.m_depth = depth;
+	witness->push_back(step);
+}
@@ -21,8 +21,10 @@
 #define	RULEREACHABILITY_H
 
 #include <deque>
+#include <vector>
 
 #include "RuleDFSBase.h"
+#include "ResultsSink.h"
 
 class CFGEdgeTypeBase;
 //class ControlFlowGraph;
@@ -35,14 +37,18 @@ public:
 	RuleReachability(const RuleReachability& orig);
 	virtual ~RuleReachability();
 	
-	virtual bool RunRule();
-	
-	void PrintCallChain();
+	virtual bool RunRule(RuleResult *result);
 	
 private:
 	
-	void PrintStatement(StatementBase *fc, long indent_level);
-	void PrintStatement(StatementBase *sb, CFGEdgeTypeBase *eb, long indent_level);
+	/**
+	 * Reduce m_predecessors to the call chain of the violation, and append its function calls and decisions to
+	 * @a witness.
+	 */
+	void CollectCallChain(std::vector<WitnessStep> *witness);
+
+	/// Append @a sb to @a witness, with the out edge @a eb taken if it's a decision.
+	void AddWitnessStep(StatementBase *sb, CFGEdgeTypeBase *eb, long depth, std::vector<WitnessStep> *witness);
 
 	/// Flag which we'll set when we find m_sink to stop the search.
 	bool m_found_sink;
@@ -53,7 +59,7 @@ private:
 	/// The function which must not be called from m_sink.
 	const Function *m_sink;
 	
-	/// Array to store predecessor of each visited vertex.
+	/// The shortest violating path found, as a list of edges starting at m_source's Entry vertex.
 	std::deque<ControlFlowGraph::edge_descriptor> m_predecessors;
 };
 
@@ -20,12 +20,12 @@
 #include "../ControlFlowGraph.h"
 #include "../../Function.h"
 
-CFGEdgeTypeFunctionCall::CFGEdgeTypeFunctionCall(FunctionCallResolved *function_call) : CFGEdgeTypeBase()
+CFGEdgeTypeFunctionCall::CFGEdgeTypeFunctionCall(FunctionCall *function_call) : CFGEdgeTypeBase()
 {
 	m_function_call = function_call;
 
 	// We need to know the ControlFlowGraph the target vertex is in.  Get it from the Function
-	// that the FunctionCallResolved vertex is calling.
+	// that the resolved FunctionCall vertex is calling.
 	m_target_cfg = m_function_call->GetCalledFunction()->GetCFGPointer();
 }
 
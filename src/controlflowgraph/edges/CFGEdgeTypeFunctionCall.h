@@ -23,7 +23,7 @@
 #include "CFGEdgeTypeBase.h"
 
 class ControlFlowGraph;
-class FunctionCallResolved;
+class FunctionCall;
 
 /**
  * A function call edge.
@@ -33,7 +33,7 @@ class FunctionCallResolved;
 class CFGEdgeTypeFunctionCall : public CFGEdgeTypeBase
 {
 public:
-	CFGEdgeTypeFunctionCall(FunctionCallResolved *function_call);
+	CFGEdgeTypeFunctionCall(FunctionCall *function_call);
 	CFGEdgeTypeFunctionCall(const CFGEdgeTypeFunctionCall& orig);
 	virtual ~CFGEdgeTypeFunctionCall();
 	
@@ -42,7 +42,7 @@ public:
 //private:
 	/// The FunctionCall Vertex instance which resulted in this edge.
 	/// We need this to determine e.g. what parameters were passed.
-	FunctionCallResolved *m_function_call;
+	FunctionCall *m_function_call;
 
 	/// The ControlFlowGraph which contains the target vertex of this edge.
 	ControlFlowGraph *m_target_cfg;
@@ -17,7 +17,7 @@
 
 #include "CFGEdgeTypeReturn.h"
 
-CFGEdgeTypeReturn::CFGEdgeTypeReturn(FunctionCallResolved *function_call)
+CFGEdgeTypeReturn::CFGEdgeTypeReturn(FunctionCall *function_call)
 {
 	m_function_call = function_call;
 }
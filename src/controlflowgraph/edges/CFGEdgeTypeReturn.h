@@ -20,12 +20,12 @@
 
 #include "CFGEdgeTypeBase.h"
 
-class FunctionCallResolved;
+class FunctionCall;
 
 class CFGEdgeTypeReturn : public CFGEdgeTypeBase
 {
 public:
-	CFGEdgeTypeReturn(FunctionCallResolved *function_call);
+	CFGEdgeTypeReturn(FunctionCall *function_call);
 	CFGEdgeTypeReturn(const CFGEdgeTypeReturn& orig);
 	virtual ~CFGEdgeTypeReturn();
 	
@@ -33,9 +33,9 @@ public:
 
 //private:
 	
-	/// The FunctionCallResolved statement which resulted in this edge.
+	/// The FunctionCall statement which resulted in this edge.
 	/// We need this to determine the point to return to.
-	FunctionCallResolved *m_function_call;
+	FunctionCall *m_function_call;
 
 };
 
@@ -19,14 +19,14 @@
 
 #include "FlowControlBase.h"
 
-FlowControlBase::FlowControlBase(const Location &location) : StatementBase(location)
+FlowControlBase::FlowControlBase(const Location &location, bool is_linked) : StatementBase(location)
 {
-
+	m_is_linked = is_linked;
 }
 
 FlowControlBase::FlowControlBase(const FlowControlBase& orig) : StatementBase(orig)
 {
-
+	m_is_linked = orig.m_is_linked;
 }
 
 FlowControlBase::~FlowControlBase()
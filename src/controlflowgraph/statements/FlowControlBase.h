@@ -22,15 +22,44 @@
 
 #include "StatementBase.h"
 
+class ControlFlowGraph;
+class LabelMap;
+
 /**
  * Base class for any statements which modify the control flow.
+ *
+ * The parser creates these statements unlinked, knowing only the labels they jump to.  ResolveLinks() then adds the
+ * out edges to the labelled statements and marks the statement linked, in place.
  */
 class FlowControlBase: public StatementBase
 {
 public:
-	explicit FlowControlBase(const Location &location);
+	/**
+	 * @param location  The Location of the statement.
+	 * @param is_linked  false if the statement's out edges have yet to be added by ResolveLinks().
+	 */
+	explicit FlowControlBase(const Location &location, bool is_linked = true);
 	FlowControlBase(const FlowControlBase& orig);
 	virtual ~FlowControlBase();
+
+	/**
+	 * Add the out edges from this statement, which must be a vertex of @a cfg, to the statements it jumps to.
+	 *
+	 * @param cfg  The ControlFlowGraph to add the edges to.
+	 * @param label_map  The labels of @a cfg.
+	 * @return true if all the links could be resolved, in which case the statement is now linked.
+	 */
+	virtual bool ResolveLinks(ControlFlowGraph &cfg, LabelMap &label_map) = 0;
+
+	/**
+	 * @return true if this statement's out edges have been added.
+	 */
+	bool IsLinked() const { return m_is_linked; };
+
+protected:
+
+	/// Set by the derived classes' ResolveLinks() once they've added their out edges.
+	bool m_is_linked;
 };
 
 #endif /* FLOWCONTROLBASE_H */
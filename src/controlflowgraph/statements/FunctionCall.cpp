@@ -1,5 +1,5 @@
 /*
- * Copyright 2011 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ * Copyright 2011, 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
  *
  * This file is part of CoFlo.
  *
@@ -17,22 +17,50 @@
 
 #include "FunctionCall.h"
 
+#include "../../Function.h"
 
-FunctionCall::FunctionCall(const Location &location, const std::string &params) : StatementBase(location)
+
+FunctionCall::FunctionCall(const std::string &identifier, const Location &location, const std::string &params)
+	: StatementBase(location)
 {
+	m_identifier = identifier;
 	m_params = params;
+	m_target_function = NULL;
 }
 
 FunctionCall::FunctionCall(const FunctionCall& orig) : StatementBase(orig)
 {
+	m_identifier = orig.m_identifier;
 	m_params = orig.m_params;
+	m_target_function = orig.m_target_function;
 }
 
 FunctionCall::~FunctionCall()
 {
+	// We don't own m_target_function, so don't delete it.
+}
+
+std::string FunctionCall::GetIdentifier() const
+{
+	if(IsResolved())
+	{
+		return m_target_function->GetIdentifier();
+	}
+
+	return m_identifier;
 }
 
 std::string FunctionCall::GetIdentifierCFG() const
 {
 	return GetIdentifier() + "( " + m_params + " )";
 }
+
+std::string FunctionCall::GetStatementTextDOT() const
+{
+	if(IsResolved())
+	{
+		return m_target_function->GetIdentifier()+"()";
+	}
+
+	return GetIdentifier() + "(" + EscapeifyForUseInDotLabel(m_params) + ")";
+}
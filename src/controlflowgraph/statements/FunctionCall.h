@@ -1,5 +1,5 @@
 /*
- * Copyright 2011 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ * Copyright 2011, 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
  *
  * This file is part of CoFlo.
  *
@@ -27,19 +27,33 @@ class Location;
 
 /**
  * Class representing a function call statement.
+ *
+ * The parser creates function calls unresolved, knowing only the identifier of the function being called.  Linking
+ * resolves them in place by pointing them at the called Function, so the statement keeps its vertex and edges in the
+ * ControlFlowGraph throughout.
  */
 class FunctionCall : public StatementBase
 {
 public:
-	FunctionCall(const Location &location, const std::string &params);
+	FunctionCall(const std::string &identifier, const Location &location, const std::string &params);
 	FunctionCall(const FunctionCall& orig);
 	virtual ~FunctionCall();
-	
+
 	/// Returns the name of the function being called.
-	virtual std::string GetIdentifier() const = 0;
-	
+	std::string GetIdentifier() const;
+
 	virtual std::string GetIdentifierCFG() const;
 
+	/**
+	 * Get text suitable for setting the statement's attributes in a dot file.
+	 */
+	virtual std::string GetStatementTextDOT() const;
+
+	/**
+	 * Draw unresolved calls with a red border.
+	 */
+	virtual std::string GetDotSVGColor() const { return IsResolved() ? "black" : "red"; };
+
 	/**
 	 * Anything derived from this class is a function call of some sort.
 	 *
@@ -47,13 +61,34 @@ public:
 	 */
 	virtual bool IsFunctionCall() const { return true; };
 
+	/**
+	 * Resolve this call to @a target_function.
+	 *
+	 * @param target_function The Function being called.
+	 */
+	void Resolve(Function *target_function) { m_target_function = target_function; };
+
+	/**
+	 * @return true if this call has been resolved to the Function it calls.
+	 */
+	bool IsResolved() const { return m_target_function != NULL; };
+
+	/**
+	 * @return The Function being called, or NULL if the call hasn't been resolved.
+	 */
+	Function* GetCalledFunction() const { return m_target_function; };
+
 	/// The parameters passed to the function.
 	/// @todo We need to handle this better in many ways.
 	std::string m_params;
 
 private:
 
+	/// Identifier of the function we're calling.
+	std::string m_identifier;
 
+	/// Pointer to the function we're calling, NULL until the call is resolved.  We don't own it.
+	Function *m_target_function;
 };
 
 #endif	/* FUNCTIONCALL_H */
@@ -19,14 +19,27 @@
 
 #include "Goto.h"
 
+#include <iostream>
+
+#include <boost/functional/hash.hpp>
+
+#include "LabelMap.h"
+#include "../ControlFlowGraph.h"
+#include "../edges/edge_types.h"
+
 Goto::Goto(const Location &location) : FlowControlBase(location)
 {
 
 }
 
-Goto::Goto(const Goto& orig) : FlowControlBase(orig)
+Goto::Goto(const Location &location, const std::string &link_target_name) : FlowControlBase(location, false)
 {
+	m_link_target_name = link_target_name;
+}
 
+Goto::Goto(const Goto& orig) : FlowControlBase(orig)
+{
+	m_link_target_name = orig.m_link_target_name;
 }
 
 Goto::~Goto()
@@ -34,3 +47,29 @@ Goto::~Goto()
 	// TODO Auto-generated destructor stub
 }
 
+bool Goto::ResolveLinks(ControlFlowGraph &cfg, LabelMap &label_map)
+{
+	// Look up our target.
+	LabelMap::iterator it;
+	it = label_map.find(m_link_target_name);
+
+	if(it == label_map.end())
+	{
+		// Couldn't find it.
+		std::cerr << "ERROR: Can't find goto target label \"" << m_link_target_name << "\"" << std::endl;
+		return false;
+	}
+
+	// Found it.  Add an edge.
+	cfg.AddEdge(this, (*it).second, new CFGEdgeTypeFallthrough());
+	m_is_linked = true;
+
+	return true;
+}
+
+std::size_t Goto::GetStructuralHash(CompilerNameMap *names) const
+{
+	std::size_t seed = FlowControlBase::GetStructuralHash(names);
+	boost::hash_combine(seed, names->Canonicalize(m_link_target_name));
+	return seed;
+}
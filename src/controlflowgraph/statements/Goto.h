@@ -20,6 +20,8 @@
 #ifndef GOTO_H_
 #define GOTO_H_
 
+#include <string>
+
 #include "FlowControlBase.h"
 
 /*
@@ -28,13 +30,33 @@
 class Goto: public FlowControlBase
 {
 public:
+	/**
+	 * Create a linked Goto, whose out edge will be added by the caller.
+	 */
 	Goto(const Location &location);
+
+	/**
+	 * Create an unlinked Goto to the statement labelled @a link_target_name.
+	 */
+	Goto(const Location &location, const std::string &link_target_name);
 	Goto(const Goto& orig);
 	virtual ~Goto();
 
-	virtual std::string GetStatementTextDOT() const { return "GOTO"; };
+	virtual std::string GetStatementTextDOT() const { return IsLinked() ? "GOTO" : "GOTO_UNLINKED"; };
+
+	virtual std::string GetIdentifierCFG() const { return IsLinked() ? "GOTO" : "GOTO_UNLINKED"; };
+
+	virtual bool ResolveLinks(ControlFlowGraph &cfg, LabelMap &label_map);
+
+	/// Includes the labels jumped to.
+	virtual std::size_t GetStructuralHash(CompilerNameMap *names) const;
+
+	/// @return The identifier of the label this Goto jumps to.
+	std::string GetTarget() const { return m_link_target_name; };
+
+private:
 
-	virtual std::string GetIdentifierCFG() const { return "GOTO"; };
+	std::string m_link_target_name;
 };
 
 #endif /* GOTO_H_ */
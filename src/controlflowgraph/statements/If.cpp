@@ -17,16 +17,66 @@
 
 #include "If.h"
 
-If::If(const Location &location, const std::string &condition) : FlowControlBase(location)
+#include <iostream>
+
+#include <boost/functional/hash.hpp>
+
+#include "LabelMap.h"
+#include "../ControlFlowGraph.h"
+#include "../edges/edge_types.h"
+
+If::If(const Location &location, const std::string &condition,
+		const std::string &true_target_name, const std::string &false_target_name) : FlowControlBase(location, false)
 {
 	m_condition = condition;
+	m_true_target_name = true_target_name;
+	m_false_target_name = false_target_name;
 }
 
 If::If(const If& orig) : FlowControlBase(orig)
 {
+	m_condition = orig.m_condition;
+	m_true_target_name = orig.m_true_target_name;
+	m_false_target_name = orig.m_false_target_name;
 }
 
 If::~ If() 
 {
 }
 
+bool If::ResolveLinks(ControlFlowGraph &cfg, LabelMap &label_map)
+{
+	// Look up our targets.
+	LabelMap::iterator it_true, it_false;
+	it_true = label_map.find(m_true_target_name);
+	it_false = label_map.find(m_false_target_name);
+
+	if(it_true == label_map.end())
+	{
+		// Couldn't find it.
+		std::cerr << "ERROR: Can't find if-true target label \"" << m_true_target_name << "\"" << std::endl;
+		return false;
+	}
+	else if(it_false == label_map.end())
+	{
+		// Couldn't find it.
+		std::cerr << "ERROR: Can't find if-false target label \"" << m_false_target_name << "\"" << std::endl;
+		return false;
+	}
+
+	// Found both targets.  Add edges.
+	cfg.AddEdge(this, (*it_true).second, new CFGEdgeTypeIfTrue());
+	cfg.AddEdge(this, (*it_false).second, new CFGEdgeTypeIfFalse());
+	m_is_linked = true;
+
+	return true;
+}
+
+std::size_t If::GetStructuralHash(CompilerNameMap *names) const
+{
+	std::size_t seed = FlowControlBase::GetStructuralHash(names);
+	boost::hash_combine(seed, names->Canonicalize(m_condition));
+	boost::hash_combine(seed, names->Canonicalize(m_true_target_name));
+	boost::hash_combine(seed, names->Canonicalize(m_false_target_name));
+	return seed;
+}
@@ -30,21 +30,38 @@
 class If : public FlowControlBase
 {
 public:
-	If(const Location &location, const std::string &condition);
+	/**
+	 * Create an unlinked If.
+	 *
+	 * @param location  The Location of the statement.
+	 * @param condition  The text of the condition.
+	 * @param true_target_name  The label to jump to if @a condition is true.
+	 * @param false_target_name  The label to jump to if @a condition is false.
+	 */
+	If(const Location &location, const std::string &condition,
+			const std::string &true_target_name, const std::string &false_target_name);
 	If(const If& orig);
 	virtual ~If();
 	
-	virtual std::string GetStatementTextDOT() const { return "if(" + m_condition + ")"; };
+	virtual std::string GetStatementTextDOT() const { return IsLinked() ? "if(" + m_condition + ")" : "IF_UNLINKED"; };
 	
-	virtual std::string GetIdentifierCFG() const { return "if(" + m_condition + ")"; };
+	virtual std::string GetIdentifierCFG() const { return IsLinked() ? "if(" + m_condition + ")" : "IF_UNLINKED"; };
 	
 	virtual std::string GetShapeTextDOT() const { return "diamond"; };
 	
 	virtual bool IsDecisionStatement() const { return true; };
 
+	virtual bool ResolveLinks(ControlFlowGraph &cfg, LabelMap &label_map);
+
+	/// Includes the condition and the labels jumped to.
+	virtual std::size_t GetStructuralHash(CompilerNameMap *names) const;
+
 private:
 
 	std::string m_condition;
+
+	std::string m_true_target_name;
+	std::string m_false_target_name;
 };
 
 #endif	/* IF_H */
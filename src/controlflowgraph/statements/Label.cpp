@@ -19,15 +19,18 @@
 
 #include "Label.h"
 
-Label::Label(const Location &location, const std::string &identifier) : PseudoStatement(location)
+Label::Label(const Location &location, const std::string &identifier, bool is_compiler_generated)
+	: PseudoStatement(location)
 {
 	m_identifier = identifier;
+	m_is_compiler_generated = is_compiler_generated;
 
 }
 
 Label::Label(const Label& orig) : PseudoStatement(orig)
 {
 	m_identifier = orig.m_identifier;
+	m_is_compiler_generated = orig.m_is_compiler_generated;
 }
 
 Label::~Label()
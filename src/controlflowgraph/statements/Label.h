@@ -29,7 +29,12 @@
 class Label: public PseudoStatement
 {
 public:
-	Label(const Location &location, const std::string &identifier);
+	/**
+	 * @param location
+	 * @param identifier The label's text.
+	 * @param is_compiler_generated true if the parser found this to be a compiler-generated label (i.e. "<D.1234>").
+	 */
+	Label(const Location &location, const std::string &identifier, bool is_compiler_generated = false);
 	Label(const Label& orig);
 	virtual ~Label();
 
@@ -37,10 +42,19 @@ public:
 	virtual std::string GetStatementTextDOT() const { return m_identifier; };
 	virtual std::string GetIdentifierCFG() const { return m_identifier; };
 
+	/**
+	 * @return true if this label was generated by the compiler rather than written in the source.  Such labels
+	 * can be removed from the ControlFlowGraph once they've been linked to.
+	 */
+	bool IsCompilerGenerated() const { return m_is_compiler_generated; };
+
 private:
 
 	/// The label's text.
 	std::string m_identifier;
+
+	/// Whether this is a compiler-generated label, as determined at parse time.
+	bool m_is_compiler_generated;
 };
 
 #endif /* LABEL_H_ */
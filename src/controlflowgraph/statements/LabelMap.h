@@ -0,0 +1,36 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#ifndef LABELMAP_H
+#define LABELMAP_H
+
+#include <string>
+#include <map>
+
+class StatementBase;
+
+/**
+ * Map of label identifiers to the statements they label, used by FlowControlBase::ResolveLinks() to find jump targets.
+ */
+class LabelMap : public std::map< std::string, StatementBase* >
+{
+
+};
+
+#endif /* LABELMAP_H */
@@ -21,9 +21,7 @@
 #define PARSEHELPERS_H
 
 #include <string>
-#include <map>
 
-#include "../ControlFlowGraph.h"
 #include "FlowControlBase.h"
 
 /**
@@ -31,112 +29,20 @@
  * The classes in this group exist for the purpose of assisting in the conversion between the parser's
  * actions and the ultimate ControlFlowGraph we want.  Instances of these classes will not show up in the
  * completed ControlFlowGraph.
+ *
+ * The flow control statements themselves (Goto, If, Switch) are created unlinked by the parser and are
+ * linked in place by FlowControlBase::ResolveLinks(), so they don't need helpers here.
  * @{
  */
 
-
-class LabelMap;
-
-
-#define M_DEFINE_FLOW_CONTROL_VIRTUALS(name) \
-	virtual std::string GetStatementTextDOT() const { return #name "_UNLINKED"; }; \
-	virtual std::string GetIdentifierCFG() const { return #name "_UNLINKED"; };
-
-#define M_DECLARE_FLOW_CONTROL_VIRTUALS(name) \
-		virtual FlowControlBase* ResolveLinks(ControlFlowGraph &cfg, StatementBase* this_vertex, LabelMap &label_map);
-
-class FlowControlUnlinked : public FlowControlBase
-{
-public:
-	FlowControlUnlinked() : FlowControlBase(Location()) {};
-	FlowControlUnlinked(const Location &loc) : FlowControlBase(loc)	{ };
-	virtual ~FlowControlUnlinked() {};
-
-	/**
-	 *
-	 * @param cfg
-	 * @param this_vertex
-	 * @param label_map
-	 * @return Pointer to a FlowControlBase-derived object which the caller is to use to replace this object with in the
-	 * 		vertex's CFGVertexProperties.  NULL if all links could not be resolved.
-	 */
-	virtual FlowControlBase* ResolveLinks(ControlFlowGraph &cfg, StatementBase* this_vertex, LabelMap &label_map) = 0;
-
-};
-
-class GotoUnlinked : public FlowControlUnlinked
-{
-public:
-	GotoUnlinked() : FlowControlUnlinked(Location())
-	{
-	}
-	GotoUnlinked(const Location &loc, const std::string &link_target_name) : FlowControlUnlinked(loc)
-	{
-		m_link_target_name = link_target_name;
-	}
-	virtual ~GotoUnlinked() {};
-
-	std::string GetTarget() { return m_link_target_name; };
-
-	M_DEFINE_FLOW_CONTROL_VIRTUALS(GOTO)
-
-	M_DECLARE_FLOW_CONTROL_VIRTUALS(Goto)
-
-private:
-
-	std::string m_link_target_name;
-};
-
-class ReturnUnlinked : public FlowControlUnlinked
-{
-public:
-	ReturnUnlinked() : FlowControlUnlinked(Location())
-	{
-
-	}
-	ReturnUnlinked(const Location &loc, const std::string &return_var_name) : FlowControlUnlinked(loc)
-	{
-		m_return_var_name = return_var_name;
-	}
-	virtual ~ReturnUnlinked() {};
-
-	M_DEFINE_FLOW_CONTROL_VIRTUALS(RETURN)
-
-	M_DECLARE_FLOW_CONTROL_VIRTUALS(Return)
-
-private:
-
-	std::string m_return_var_name;
-};
-
-class IfUnlinked : public FlowControlUnlinked
-{
-public:
-	IfUnlinked() : FlowControlUnlinked(), m_true(NULL), m_false(NULL) {};
-	IfUnlinked(const Location &loc, const std::string &condition,
-			GotoUnlinked *goto_true, GotoUnlinked *goto_false) : FlowControlUnlinked(loc)
-	{
-		m_condition = condition;
-		m_true = goto_true;
-		m_false = goto_false;
-	}
-	virtual ~IfUnlinked() {};
-
-	M_DEFINE_FLOW_CONTROL_VIRTUALS(IF)
-
-	M_DECLARE_FLOW_CONTROL_VIRTUALS(If)
-
-private:
-	std::string m_condition;
-	GotoUnlinked *m_true;
-	GotoUnlinked *m_false;
-};
-
-class CaseUnlinked : public FlowControlUnlinked
+/**
+ * One case of a switch statement.  The parser collects these and passes their targets to Switch::InsertCase().
+ */
+class CaseUnlinked : public FlowControlBase
 {
 public:
-	CaseUnlinked() : FlowControlUnlinked(Location()) {};
-	CaseUnlinked(const Location &loc, /* condition,*/ const std::string &link_target_name) : FlowControlUnlinked(loc)
+	CaseUnlinked() : FlowControlBase(Location(), false) {};
+	CaseUnlinked(const Location &loc, /* condition,*/ const std::string &link_target_name) : FlowControlBase(loc, false)
 	{
 		m_link_target_name = link_target_name;
 	}
@@ -144,35 +50,15 @@ public:
 
 	std::string GetTarget() { return m_link_target_name; };
 
-	M_DEFINE_FLOW_CONTROL_VIRTUALS(CASE);
+	virtual std::string GetStatementTextDOT() const { return "CASE_UNLINKED"; };
+	virtual std::string GetIdentifierCFG() const { return "CASE_UNLINKED"; };
 
-	M_DECLARE_FLOW_CONTROL_VIRTUALS(Case)
+	virtual bool ResolveLinks(ControlFlowGraph &cfg, LabelMap &label_map);
 
 private:
 	std::string m_link_target_name;
 };
 
-class SwitchUnlinked : public FlowControlUnlinked
-{
-public:
-	SwitchUnlinked() : FlowControlUnlinked(Location()) {};
-	SwitchUnlinked(const Location &loc) : FlowControlUnlinked(loc) {};
-	virtual ~SwitchUnlinked() {};
-
-	void InsertCase(CaseUnlinked *the_case)
-	{
-		m_case_list.push_back(the_case);
-	};
-
-	M_DEFINE_FLOW_CONTROL_VIRTUALS(SWITCH)
-
-	M_DECLARE_FLOW_CONTROL_VIRTUALS(Switch)
-
-private:
-
-	std::vector<CaseUnlinked *> m_case_list;
-};
-
 ///@} // Closing the @parsegroup.
 
 #endif /* PARSEHELPERS_H_ */
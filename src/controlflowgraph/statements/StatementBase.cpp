@@ -15,14 +15,18 @@
  * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cctype>
+#include <sstream>
 #include <string>
 #include <utility>
+#include <typeinfo>
 #include <boost/regex.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "StatementBase.h"
 #include "If.h"
 #include "Switch.h"
-#include "FunctionCallUnresolved.h"
+#include "FunctionCall.h"
 #include "../../Location.h"
 
 StatementBase::StatementBase(const Location &location) : m_location(location)
@@ -62,6 +66,70 @@ void StatementBase::InEdges(StatementBase::in_edge_iterator* ibegin,
 	*iend = boost::make_transform_iterator< CFGEdgeDescriptorConv, Vertex::base_edge_list_iterator >(m_in_edges.end());
 }
 
+/// @return true if @a c can be part of an identifier.
+static bool is_identifier_char(char c)
+{
+	return std::isalnum(static_cast<unsigned char>(c)) || (c == '_');
+}
+
+std::string StatementBase::CompilerNameMap::Canonicalize(const std::string &text)
+{
+	std::string retval;
+	std::string::size_type copied_to = 0;
+
+	for(std::string::size_type dot = text.find('.'); dot != std::string::npos; dot = text.find('.', dot+1))
+	{
+		// Look for an identifier right before the dot and a number right after it.
+		std::string::size_type begin = dot, end = dot+1;
+		while((begin > copied_to) && is_identifier_char(text[begin-1]))
+		{
+			--begin;
+		}
+		while((end < text.size()) && std::isdigit(static_cast<unsigned char>(text[end])))
+		{
+			++end;
+		}
+		if((begin == dot) || std::isdigit(static_cast<unsigned char>(text[begin])) || (end == dot+1)
+				|| ((end < text.size()) && is_identifier_char(text[end])))
+		{
+			// Not a compiler-generated name, e.g. a floating point number.
+			continue;
+		}
+
+		std::string name = text.substr(begin, end-begin);
+		std::map<std::string, long>::iterator it = m_names.find(name);
+		if(it == m_names.end())
+		{
+			long index = m_names.size();
+			it = m_names.insert(std::make_pair(name, index)).first;
+		}
+
+		std::ostringstream canonical_name;
+		canonical_name << text.substr(begin, dot-begin) << ".#" << it->second;
+		retval += text.substr(copied_to, begin-copied_to);
+		retval += canonical_name.str();
+		copied_to = end;
+		dot = end-1;
+	}
+
+	retval += text.substr(copied_to);
+
+	return retval;
+}
+
+std::size_t StatementBase::GetStructuralHash(CompilerNameMap *names) const
+{
+	std::size_t seed = 0;
+
+	boost::hash_combine(seed, std::string(typeid(*this).name()));
+	boost::hash_combine(seed, names->Canonicalize(GetIdentifierCFG()));
+	boost::hash_combine(seed, m_location.GetAbsoluteFilePath());
+	boost::hash_combine(seed, m_location.GetLineNumber());
+	boost::hash_combine(seed, m_location.GetColumn());
+
+	return seed;
+}
+
 std::string StatementBase::EscapeifyForUseInDotLabel(const std::string & str)
 {
 	static const boost::regex expr("(\\\"|\\\\n)");
@@ -20,6 +20,7 @@
 #ifndef STATEMENTBASE_H
 #define	STATEMENTBASE_H
 
+#include <map>
 #include <string>
 #include <utility>
 
@@ -160,6 +161,39 @@ public:
 	template<typename DerivedType>
 	bool IsType() const { return NULL != dynamic_cast<const DerivedType*>(this); };
 
+	/**
+	 * Renames the compiler-generated names in a function body, such as the "D.1234" of GCC's labels and temporaries
+	 * or its "iftmp.0"s, by order of first appearance.  GCC numbers these per translation unit, so the copies of
+	 * the same inline function in different translation units would otherwise have different names in them.
+	 */
+	class CompilerNameMap
+	{
+	public:
+		/**
+		 * @return @a text with each compiler-generated name, i.e. each identifier followed by a '.' and a number,
+		 * replaced by its prefix and the order in which it was first seen by this map.
+		 */
+		std::string Canonicalize(const std::string &text);
+
+	private:
+		std::map<std::string, long> m_names;
+	};
+
+	/**
+	 * Hash of everything about this statement which matters to the shape of the ControlFlowGraph it ends up in:
+	 * its type, its text, and its Location.  Two definitions of the same function compiled from the same source
+	 * will have statements with identical hashes, as long as the statements of each are hashed in order with the
+	 * same @a names.
+	 *
+	 * Derived classes which carry more than this, such as the labels a jump goes to, should override this and
+	 * combine it into the base class's hash.
+	 *
+	 * @param names  The compiler-generated names seen so far in the function body.  All the text hashed is
+	 *        canonicalized through this.
+	 * @return The structural hash of this statement.
+	 */
+	virtual std::size_t GetStructuralHash(CompilerNameMap *names) const;
+
 	//@}
 
 	/**
@@ -17,15 +17,66 @@
 
 #include "Switch.h"
 
-Switch::Switch(const Location &location) : FlowControlBase(location)
+#include <iostream>
+
+#include <boost/foreach.hpp>
+#include <boost/functional/hash.hpp>
+
+#include "LabelMap.h"
+#include "../ControlFlowGraph.h"
+#include "../edges/edge_types.h"
+
+Switch::Switch(const Location &location) : FlowControlBase(location, false)
 {
 }
 
 Switch::Switch(const Switch& orig) : FlowControlBase(orig)
 {
+	m_case_target_names = orig.m_case_target_names;
 }
 
 Switch::~Switch()
 {
 }
 
+bool Switch::ResolveLinks(ControlFlowGraph &cfg, LabelMap &label_map)
+{
+	bool resolved_any_links = false;
+
+	BOOST_FOREACH(const std::string &target_name, m_case_target_names)
+	{
+		// Look up our target.
+		LabelMap::iterator it;
+		it = label_map.find(target_name);
+
+		if(it == label_map.end())
+		{
+			// Couldn't find it.
+			std::cerr << "ERROR: Can't find switch case target label \"" << target_name << "\"" << std::endl;
+		}
+		else
+		{
+			// Found it.  Add an edge.
+			cfg.AddEdge(this, (*it).second, new CFGEdgeTypeFallthrough());
+
+			resolved_any_links = true;
+		}
+	}
+
+	if(resolved_any_links)
+	{
+		m_is_linked = true;
+	}
+
+	return resolved_any_links;
+}
+
+std::size_t Switch::GetStructuralHash(CompilerNameMap *names) const
+{
+	std::size_t seed = FlowControlBase::GetStructuralHash(names);
+	BOOST_FOREACH(const std::string &case_target_name, m_case_target_names)
+	{
+		boost::hash_combine(seed, names->Canonicalize(case_target_name));
+	}
+	return seed;
+}
@@ -18,25 +18,48 @@
 #ifndef SWITCH_H
 #define	SWITCH_H
 
+#include <string>
+#include <vector>
+
 #include "FlowControlBase.h"
 
 class Switch : public FlowControlBase
 {
 public:
+	/**
+	 * Create an unlinked Switch.  Add its cases with InsertCase().
+	 */
 	Switch(const Location &location);
 	Switch(const Switch& orig);
 	virtual ~Switch();
 	
-	virtual std::string GetStatementTextDOT() const { return "switch()"; };
+	virtual std::string GetStatementTextDOT() const { return IsLinked() ? "switch()" : "SWITCH_UNLINKED"; };
 	
-	virtual std::string GetIdentifierCFG() const { return "switch()"; };
+	virtual std::string GetIdentifierCFG() const { return IsLinked() ? "switch()" : "SWITCH_UNLINKED"; };
 	
 	virtual std::string GetShapeTextDOT() const { return "diamond"; };
 	
 	virtual bool IsDecisionStatement() const { return true; };
 
+	/**
+	 * Add a case which jumps to the statement labelled @a link_target_name.
+	 */
+	void InsertCase(const std::string &link_target_name) { m_case_target_names.push_back(link_target_name); };
+
+	/**
+	 * Add an edge to each case's target.  Cases whose targets can't be found are reported and skipped.
+	 *
+	 * @return true if at least one case could be linked.
+	 */
+	virtual bool ResolveLinks(ControlFlowGraph &cfg, LabelMap &label_map);
+
+	/// Includes the labels jumped to.
+	virtual std::size_t GetStructuralHash(CompilerNameMap *names) const;
+
 private:
 
+	/// The labels the cases jump to.
+	std::vector<std::string> m_case_target_names;
 };
 
 #endif	/* SWITCH_H */
@@ -27,8 +27,6 @@
 #include "Exit.h"
 #include "FlowControlBase.h"
 #include "FunctionCall.h"
-#include "FunctionCallResolved.h"
-#include "FunctionCallUnresolved.h"
 #include "Goto.h"
 #include "If.h"
 #include "Label.h"
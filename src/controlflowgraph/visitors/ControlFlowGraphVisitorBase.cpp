@@ -80,7 +80,7 @@ vertex_return_value_t ControlFlowGraphVisitorBase::finish_vertex(ControlFlowGrap
 };
 
 #if 0
-void ControlFlowGraphVisitorBase::PushCallStack(FunctionCallResolved* pushing_function_call)
+void ControlFlowGraphVisitorBase::PushCallStack(FunctionCall* pushing_function_call)
 {
 	m_call_stack.push(pushing_function_call);
 }
@@ -88,13 +88,13 @@ void ControlFlowGraphVisitorBase::PushCallStack(FunctionCallResolved* pushing_fu
 void ControlFlowGraphVisitorBase::PopCallStack()
 {
 	// Remove the function we're returning from from the functions-on-the-call-stack set.
-	m_call_set.erase(m_call_stack.top()->m_target_function);
+	m_call_set.erase(m_call_stack.top()->GetCalledFunction());
 
 	// Pop the call stack.
 	m_call_stack.pop();
 }
 
-FunctionCallResolved *ControlFlowGraphVisitorBase::TopCallStack()
+FunctionCall *ControlFlowGraphVisitorBase::TopCallStack()
 {
 	return m_call_stack.top();
 }
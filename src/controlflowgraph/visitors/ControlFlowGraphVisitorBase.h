@@ -28,7 +28,7 @@
 
 /// @todo This should probably be a template parameter.
 #include "../DFSCallStack.h"
-class FunctionCallResolved;
+class FunctionCall;
 class Function;
 
 /**
@@ -59,9 +59,9 @@ protected:
 
 	/// @todo Replace this with an instance of DFSCallStack
 #if 0
-	void PushCallStack(FunctionCallResolved* pushing_function_call);
+	void PushCallStack(FunctionCall* pushing_function_call);
 	void PopCallStack();
-	FunctionCallResolved* TopCallStack();
+	FunctionCall* TopCallStack();
 	bool IsCallStackEmpty() const;
 	bool AreWeRecursing(Function* function);
 #endif
@@ -74,7 +74,7 @@ protected:
 private:
 #if 0
 	/// The FunctionCall call stack.
-	std::stack<FunctionCallResolved*> m_call_stack;
+	std::stack<FunctionCall*> m_call_stack;
 
 	/// Typedef for an unordered collection of Function pointers.
 	/// Used to efficiently track which functions are on the call stack, for checking if we're going recursive.
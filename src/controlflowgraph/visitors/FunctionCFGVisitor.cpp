@@ -19,58 +19,26 @@
 
 #include "FunctionCFGVisitor.h"
 
-#include <iostream>
+#include <ostream>
 
 #include "../edges/edge_types.h"
 #include "../../Function.h"
 
-static void indent(long i)
+static void indent(std::ostream &out, long i)
 {
 	while (i > 0)
 	{
-		std::cout << "    ";
+		out << "    ";
 		i--;
 	};
 }
 
-static long filtered_in_degree(ControlFlowGraph::vertex_descriptor v)
+/**
+ * Look up the filtered in degree of @a v in its owning Function's FilteredDegreeCache.
+ */
+static long cached_filtered_in_degree(ControlFlowGraph::vertex_descriptor v)
 {
-	StatementBase::in_edge_iterator ieit, ieend;
-
-	v->InEdges(&ieit, &ieend);
-
-	long i = 0;
-	bool saw_function_call_already = false;
-	for (; ieit != ieend; ++ieit)
-	{
-		if ((*ieit)->IsBackEdge())
-		{
-			// Always skip anything marked as a back edge.
-			continue;
-		}
-
-		// Count up all the incoming edges, with two exceptions:
-		// - Ignore Return edges.  They will always have exactly one matching Fallthrough in edge from a FunctionCallResolved,
-		//   which is what we'll count instead.
-		// - Ignore all but the first CFGEdgeTypeFunctionCall.  The situation here is that we'd be
-		//   looking at a vertex v that's an ENTRY statement, with a predecessor of type FunctionCallResolved.
-		//   Any particular instance of an ENTRY has at most only one valid FunctionCall edge.
-		//   For our current purposes, we only care about this one.
-		if ((dynamic_cast<CFGEdgeTypeReturn*>(*ieit) == NULL)
-				&& (saw_function_call_already == false))
-		{
-			i++;
-		}
-
-		if (dynamic_cast<CFGEdgeTypeFunctionCall*>(*ieit)
-				!= NULL)
-		{
-			// Multiple incoming function calls only count as one for convergence purposes.
-			saw_function_call_already = true;
-		}
-	}
-
-	return i;
+	return v->GetOwningFunction()->GetFilteredDegreeCache().InDegree(v);
 }
 
 
@@ -101,14 +69,14 @@ vertex_return_value_t FunctionCFGVisitor::discover_vertex(ControlFlowGraph::vert
 		// We're visiting a function entry point.
 		// Push a new call stack frame.
 
-		indent(m_indent_level);
-		std::cout << "[" << std::endl;
+		indent(m_out_stream, m_indent_level);
+		m_out_stream << "[\n";
 		//PushCallStack(m_next_function_call_resolved);
 		m_indent_level++;
 	}
 
 	// Check if this vertex is the first vertex of a new branch of the control flow graph.
-	long fid = filtered_in_degree(u);
+	long fid = cached_filtered_in_degree(u);
 	if(fid==1)
 	{
 		ControlFlowGraph::vertex_descriptor predecessor;
@@ -117,8 +85,8 @@ vertex_return_value_t FunctionCFGVisitor::discover_vertex(ControlFlowGraph::vert
 		{
 			// Predecessor was a decision statement, so this vertex starts a new branch.
 			// Print a block start marker at the current indent level minus one.
-			indent(m_indent_level);
-			std::cout << "{" <<std::endl;
+			indent(m_out_stream, m_indent_level);
+			m_out_stream << "{\n";
 			m_indent_level++;
 		}
 	}
@@ -128,8 +96,8 @@ vertex_return_value_t FunctionCFGVisitor::discover_vertex(ControlFlowGraph::vert
 		for(long i=fid-2; i>0; --i)
 		{
 			m_indent_level--;
-			indent(m_indent_level);
-			std::cout << "}" << std::endl;
+			indent(m_out_stream, m_indent_level);
+			m_out_stream << "}\n";
 		}
 	}
 
@@ -137,14 +105,14 @@ vertex_return_value_t FunctionCFGVisitor::discover_vertex(ControlFlowGraph::vert
 	if(m_cfg_verbose || (p->IsDecisionStatement() || (p->IsFunctionCall())))
 	{
 		// Indent and print the statement corresponding to this vertex.
-		indent(m_indent_level);
-		std::cout << p->GetIdentifierCFG();
+		indent(m_out_stream, m_indent_level);
+		m_out_stream << p->GetIdentifierCFG();
 		if(m_cfg_vertex_ids)
 		{
 			// Print the vertex ID.
-			std::cout << " [" << u << "]";
+			m_out_stream << " [" << u << "]";
 		}
-		std::cout << " <" << p->GetLocation() << ">" << std::endl;
+		m_out_stream << " <" << p->GetLocation() << ">\n";
 	}
 
 	if (u == m_last_statement)
@@ -156,28 +124,26 @@ vertex_return_value_t FunctionCFGVisitor::discover_vertex(ControlFlowGraph::vert
 		//return terminate_search;
 	}
 
-	if (p->IsType<FunctionCallResolved>())
+	FunctionCall *fcr = dynamic_cast<FunctionCall*>(p);
+	if ((fcr != NULL) && fcr->IsResolved())
 	{
 		// This is a function call which has been resolved (i.e. has a link to the
 		// actual Function that's being called).  Track the call context, and
 		// check if we're going recursive.
-		FunctionCallResolved *fcr;
-
-		fcr = dynamic_cast<FunctionCallResolved*>(p);
 
 		// Assume we're not.
 		m_last_discovered_vertex_is_recursive = false;
 
-		if(m_call_stack->AreWeRecursing(fcr->m_target_function))
+		if(m_call_stack->AreWeRecursing(fcr->GetCalledFunction()))
 		{
-			// We're recursing, we need to treat this vertex as if it were a FunctionCallUnresolved.
-			std::cout << "RECURSION DETECTED: Function \"" << fcr->m_target_function << "\"" << std::endl;
+			// We're recursing, we need to treat this vertex as if it were an unresolved FunctionCall.
+			m_out_stream << "RECURSION DETECTED: Function \"" << fcr->GetCalledFunction() << "\"\n";
 			m_last_discovered_vertex_is_recursive = true;
 		}
 		else
 		{
 			// We're not recursing, push a normal stack frame and do the call.
-			m_call_stack->PushCallStack(new CallStackFrameBase(fcr, fcr->m_target_function->GetCFGPointer()));
+			m_call_stack->PushCallStack(new CallStackFrameBase(fcr, fcr->GetCalledFunction()->GetCFGPointer()));
 		}
 	}
 
@@ -220,12 +186,12 @@ edge_return_value_t FunctionCFGVisitor::examine_edge(ControlFlowGraph::edge_desc
 		if(m_call_stack->IsCallStackEmpty())
 		{
 			// Should never get here.
-			std::cout << "EMPTY" <<std::endl;
+			m_out_stream << "EMPTY\n";
 		}
 		else if(m_call_stack->TopCallStack()->GetPushingCall() == NULL)
 		{
 			// We're at the top of the call stack, and we're trying to return.
-			std::cout << "NULL" <<std::endl;
+			m_out_stream << "NULL\n";
 			return edge_return_value_t::terminate_branch;
 		}
 		else if(ret->m_function_call != m_call_stack->TopCallStack()->GetPushingCall())
@@ -242,15 +208,16 @@ edge_return_value_t FunctionCFGVisitor::examine_edge(ControlFlowGraph::edge_desc
 	}
 
 	// Handle recursion.
-	// We deal with recursion by deciding here which path to take out of a FunctionCallResolved vertex.
+	// We deal with recursion by deciding here which path to take out of a resolved FunctionCall vertex.
 	// Note that this is currently the only vertex type which can result in recursion.
-	if(ed->Source()->IsType<FunctionCallResolved>())
+	FunctionCall *source_call = dynamic_cast<FunctionCall*>(ed->Source());
+	if((source_call != NULL) && source_call->IsResolved())
 	{
 		if(m_last_discovered_vertex_is_recursive && (fc != NULL))
 		{
 			// We are in danger of infinite recursion.
 			// Skip this function call.
-			std::cout << "t3" <<std::endl;
+			m_out_stream << "t3\n";
 			return edge_return_value_t::terminate_branch;
 		}
 		else if(!m_last_discovered_vertex_is_recursive && (ed->IsType<CFGEdgeTypeFallthrough>()))
@@ -274,8 +241,8 @@ void FunctionCFGVisitor::vertex_visit_complete(ControlFlowGraph::vertex_descript
 
 		// Outdent.
 		m_indent_level--;
-		indent(m_indent_level);
-		std::cout << "]" << std::endl;
+		indent(m_out_stream, m_indent_level);
+		m_out_stream << "]\n";
 
 		if(m_last_statement == u)
 		{
@@ -291,17 +258,17 @@ void FunctionCFGVisitor::vertex_visit_complete(ControlFlowGraph::vertex_descript
 		// No target vertices pushed by this vertex.  That means that some other vertex did push our target vertex,
 		// or that we have no out edges.  Either way we terminate the branch.
 		m_indent_level--;
-		indent(m_indent_level);
+		indent(m_out_stream, m_indent_level);
 
 		// We're leaving a branch indent context.
-		std::cout << "}" << std::endl;
+		m_out_stream << "}\n";
 	}
 
-	if	((num_vertices_pushed == 1) && (filtered_in_degree(e->Target()) > 1))
+	if	((num_vertices_pushed == 1) && (cached_filtered_in_degree(e->Target()) > 1))
 	{
 		// The edge will end on a merge vertex.  Outdent.
 		m_indent_level--;
-		indent(m_indent_level);
-		std::cout << "}" << std::endl;
+		indent(m_out_stream, m_indent_level);
+		m_out_stream << "}\n";
 	}
 }
@@ -20,12 +20,14 @@
 #ifndef FUNCTIONCFGVISITOR_H_
 #define FUNCTIONCFGVISITOR_H_
 
+#include <iosfwd>
+
 #include "ControlFlowGraphVisitorBase.h"
 
 #include "../CallStackFrameBase.h"
 
 /**
- * Visitor which, when passed to topological_visit_kahn, prints out the control flow graph.
+ * Visitor which, when passed to topological_visit_kahn, prints out the control flow graph to the given stream.
  */
 class FunctionCFGVisitor: public ControlFlowGraphVisitorBase
 {
@@ -33,8 +35,9 @@ public:
 	FunctionCFGVisitor(ControlFlowGraph &g,
 			ControlFlowGraph::vertex_descriptor last_statement,
 			bool cfg_verbose,
-			bool cfg_vertex_ids) :
-			ControlFlowGraphVisitorBase(g)
+			bool cfg_vertex_ids,
+			std::ostream &out) :
+			ControlFlowGraphVisitorBase(g), m_out_stream(out)
 	{
 		m_last_statement = last_statement;
 		m_cfg_verbose = cfg_verbose;
@@ -43,7 +46,7 @@ public:
 		m_indent_level = 0;
 	};
 	FunctionCFGVisitor(const FunctionCFGVisitor &original) :
-			ControlFlowGraphVisitorBase(original)
+			ControlFlowGraphVisitorBase(original), m_out_stream(original.m_out_stream)
 	{
 	};
 	virtual ~FunctionCFGVisitor();
@@ -74,6 +77,9 @@ private:
 	long m_indent_level;
 
 	bool m_last_discovered_vertex_is_recursive;
+
+	/// The stream we print the graph to.
+	std::ostream &m_out_stream;
 };
 
 #endif /* FUNCTIONCFGVISITOR_H_ */
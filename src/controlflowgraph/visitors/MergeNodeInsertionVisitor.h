@@ -262,7 +262,7 @@ private:
 			// - Ignore Return edges.  They will always have exactly one matching FunctionCallBypass, which
 			//   is what we'll count instead.
 			// - Ignore all but the first CFGEdgeTypeFunctionCall.  The situation here is that we'd be
-			//   looking at a vertex v that's an ENTRY statement, with a predecessor of type FunctionCallResolved.
+			//   looking at a vertex v that's an ENTRY statement, with a predecessor which is a resolved FunctionCall.
 			//   Any particular instance of an ENTRY has at most only one valid FunctionCall edge.
 			//   For our current purposes, we only care about this one.
 			if ((dynamic_cast<CFGEdgeTypeReturn*>(cfg[*ieit].m_edge_type) == NULL)
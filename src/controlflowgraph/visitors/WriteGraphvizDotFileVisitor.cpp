@@ -52,7 +52,7 @@ node [shape=rectangle fontname=\"Helvetica\"]\n\
 edge [style=solid]\n\
 { rank = source; 0; }\n\
 { rank = sink; 1; }\n\
-" << std::endl;
+\n";
 
 	return vertex_return_value_t::ok;
 }
@@ -125,7 +125,7 @@ vertex_return_value_t WriteGraphvizDotFileVisitor::discover_vertex(
 	}
 	m_out_stream  << "\", color=" << u->GetDotSVGColor();
 	m_out_stream << ", shape=" << u->GetShapeTextDOT();
-	m_out_stream << "];" << std::endl;
+	m_out_stream << "];\n";
 
 	return vertex_return_value_t::ok;
 }
@@ -138,5 +138,5 @@ void WriteGraphvizDotFileVisitor::StreamOutEdgeAttributes(
 	m_out_stream << "label=\"" << u->GetDotLabel() << "\"";
 	m_out_stream << ", color=" << u->GetDotSVGColor();
 	m_out_stream << ", style=" << u->GetDotStyle();
-	m_out_stream << "];" << std::endl;
+	m_out_stream << "];\n";
 }
@@ -42,4 +42,9 @@ struct not_implemented: virtual coflo_exception_base { };
 
 struct duplicate_add: virtual coflo_exception_base {};
 
+/**
+ * Exception to throw when a vertex passed to a lookup function isn't in the data structure being searched.
+ */
+struct vertex_not_found: virtual coflo_exception_base {};
+
 #endif /* COFLO_EXCEPTIONS_HPP */
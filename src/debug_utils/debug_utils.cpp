@@ -19,32 +19,40 @@
 
 #include "debug_utils.hpp"
 
-#include <iostream>
-
 /// @name Definitions of the standard debug streams.
 //@{
-debug_ostream dout(std::cout);
-debug_ostream derr(std::cerr);
-debug_ostream dlog(std::clog);
+debug_ostream dout(output_sink::standard_output());
+debug_ostream derr(output_sink::standard_error());
+debug_ostream dlog(output_sink::standard_log());
 //@}
 
 /// @name Definitions of the application-specific debug streams.
 //@{
 
 /// Our debug output stream for messages generated by the Function class.
-debug_ostream dlog_function(std::clog);
+debug_ostream dlog_function(output_sink::standard_log());
 
 /// Debug output stream for messages generated during parsing of gcc's GIMPLE output.
-debug_ostream dlog_parse_gimple(std::clog);
+debug_ostream dlog_parse_gimple(output_sink::standard_log());
 
 /// Debug output stream for messages related to control flow graph construction.
-debug_ostream dlog_cfg(std::clog);
+debug_ostream dlog_cfg(output_sink::standard_log());
 
 //@}
 
-debug_ostream::debug_ostream(std::ostream &default_ostream) : m_default_ostream(default_ostream)
+debug_ostream::debug_ostream(output_sink &sink) : m_sink(sink)
 {
 	// Always start off enabled.
 	m_enabled = true;
 }
 
+output_buffer& debug_ostream::line_buffer()
+{
+	if(m_line_buffer.get() == NULL)
+	{
+		m_line_buffer.reset(new output_buffer(m_sink, false));
+	}
+
+	return *m_line_buffer;
+}
+
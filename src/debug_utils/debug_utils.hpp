@@ -22,11 +22,21 @@
 
 #include <iosfwd>
 
+#include <boost/thread/tss.hpp>
 
+#include "output_sink.hpp"
+
+/**
+ * An ostream-like debug output stream which can be switched on and off.
+ *
+ * Debug messages are written a piece at a time with chained inserters, so to keep messages from different threads
+ * from being interleaved, each thread's output is collected in its own unordered output_buffer.  The buffer is
+ * committed to the output_sink in one locked write when a manipulator such as std::endl is inserted.
+ */
 class debug_ostream
 {
 public:
-	debug_ostream(std::ostream &default_ostream);
+	debug_ostream(output_sink &sink);
 	~debug_ostream() {};
 
 	/// Typedef for ostream manipulators, which take ostream references as the input parameter.
@@ -43,7 +53,7 @@ public:
 	{
 		if(m_enabled)
 		{
-			m_default_ostream << value;
+			line_buffer() << value;
 		}
 		return *this;
 	};
@@ -58,8 +68,10 @@ public:
 	{
 		if(m_enabled)
 		{
-			// Apply the manipulator to the stream.
-			manipulator(m_default_ostream);
+			// Apply the manipulator to the stream, and send the message on its way.
+			output_buffer &buffer = line_buffer();
+			manipulator(buffer);
+			buffer.commit();
 		}
 		return *this;
 	};
@@ -68,8 +80,15 @@ public:
 	void disable() { enable(false); };
 
 private:
-	std::ostream &m_default_ostream;
+
+	/// @return This thread's line buffer.
+	output_buffer& line_buffer();
+
+	output_sink &m_sink;
 	bool m_enabled;
+
+	/// The line buffer of each thread.  Deleting it at thread exit commits what's left in it.
+	boost::thread_specific_ptr<output_buffer> m_line_buffer;
 };
 
 /// @name Our three standard debug output streams.
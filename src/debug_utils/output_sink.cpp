@@ -0,0 +1,188 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "output_sink.hpp"
+
+#include <cstring>
+#include <iostream>
+
+output_sink::output_sink(std::ostream &out) : m_out(out), m_next_ticket(0), m_next_to_write(0)
+{
+}
+
+output_sink::~output_sink()
+{
+	boost::mutex::scoped_lock lock(m_mutex);
+
+	for(std::map<ticket_type, pending_text>::iterator it = m_pending.begin(); it != m_pending.end(); ++it)
+	{
+		m_out.write(it->second.m_text.data(), it->second.m_text.size());
+	}
+	m_pending.clear();
+	m_out.flush();
+}
+
+output_sink& output_sink::standard_output()
+{
+	static output_sink sink(std::cout);
+	return sink;
+}
+
+output_sink& output_sink::standard_error()
+{
+	static output_sink sink(std::cerr);
+	return sink;
+}
+
+output_sink& output_sink::standard_log()
+{
+	static output_sink sink(std::clog);
+	return sink;
+}
+
+output_sink::ticket_type output_sink::reserve()
+{
+	boost::mutex::scoped_lock lock(m_mutex);
+
+	return m_next_ticket++;
+}
+
+void output_sink::commit(ticket_type ticket, const char *text, std::size_t length, bool last)
+{
+	boost::mutex::scoped_lock lock(m_mutex);
+
+	if(ticket == m_next_to_write)
+	{
+		// It's this ticket's turn, so its text can go straight out.
+		m_out.write(text, length);
+		if(last)
+		{
+			++m_next_to_write;
+			write_released();
+		}
+		m_out.flush();
+	}
+	else
+	{
+		// Hold on to the text until the tickets before it are done.
+		pending_text &pending = m_pending[ticket];
+		pending.m_text.append(text, length);
+		pending.m_complete = last;
+	}
+}
+
+void output_sink::write(const char *text, std::size_t length)
+{
+	boost::mutex::scoped_lock lock(m_mutex);
+
+	m_out.write(text, length);
+	m_out.flush();
+}
+
+void output_sink::write_released()
+{
+	std::map<ticket_type, pending_text>::iterator it;
+
+	while((it = m_pending.find(m_next_to_write)) != m_pending.end())
+	{
+		bool complete = it->second.m_complete;
+
+		m_out.write(it->second.m_text.data(), it->second.m_text.size());
+		m_pending.erase(it);
+		if(!complete)
+		{
+			// The rest of this ticket's text will go straight out when it's committed.
+			break;
+		}
+		++m_next_to_write;
+	}
+}
+
+output_buffer::output_buffer(output_sink &sink, bool ordered, std::size_t capacity)
+	: std::ostream(NULL), m_buffer(sink, ordered, capacity)
+{
+	rdbuf(&m_buffer);
+}
+
+output_buffer::~output_buffer()
+{
+	m_buffer.commit(true, true);
+}
+
+void output_buffer::commit()
+{
+	m_buffer.commit(true, false);
+}
+
+output_buffer::buffer::buffer(output_sink &sink, bool ordered, std::size_t capacity)
+	: m_sink(sink), m_ordered(ordered), m_ticket(0), m_storage(capacity > 0 ? capacity : 1)
+{
+	if(m_ordered)
+	{
+		m_ticket = m_sink.reserve();
+	}
+	setp(&m_storage[0], &m_storage[0] + m_storage.size());
+}
+
+void output_buffer::buffer::commit(bool all, bool last)
+{
+	char *end = pptr();
+
+	if(!m_ordered && !all)
+	{
+		// Keep any partial line, so that lines from different buffers don't get mixed together.
+		while((end != pbase()) && (end[-1] != '\n'))
+		{
+			--end;
+		}
+	}
+
+	if(m_ordered)
+	{
+		m_sink.commit(m_ticket, pbase(), end - pbase(), last);
+	}
+	else if(end != pbase())
+	{
+		m_sink.write(pbase(), end - pbase());
+	}
+
+	// Move whatever wasn't committed to the front of the buffer.
+	std::size_t remaining = pptr() - end;
+	std::memmove(&m_storage[0], end, remaining);
+	setp(&m_storage[0], &m_storage[0] + m_storage.size());
+	pbump(static_cast<int>(remaining));
+}
+
+output_buffer::buffer::int_type output_buffer::buffer::overflow(int_type c)
+{
+	commit(false, false);
+	if(pptr() == epptr())
+	{
+		// The buffer is one partial line, so there's nothing for it but to commit that.
+		commit(true, false);
+	}
+
+	if(!traits_type::eq_int_type(c, traits_type::eof()))
+	{
+		*pptr() = traits_type::to_char_type(c);
+		pbump(1);
+	}
+
+	return traits_type::not_eof(c);
+}
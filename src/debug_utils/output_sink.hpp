@@ -0,0 +1,164 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ * Buffered output which can be shared between threads.
+ */
+
+#ifndef OUTPUT_SINK_HPP
+#define OUTPUT_SINK_HPP
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+/**
+ * The destination of one or more output_buffers: a std::ostream, and the order in which the buffers' text is to be
+ * written to it.
+ *
+ * The text of the output_buffers is handed to the sink a buffer-full at a time, and each hand-off is written to the
+ * stream in a single write, under the sink's lock.  An ordered output_buffer reserves its place in the output when
+ * it's created, and its text is held back until all the text of the ordered buffers created before it has been
+ * written, so the buffers' output never interleaves even when they're filled by different threads.  Unordered text,
+ * such as a debug message, is written as soon as it's handed off.
+ */
+class output_sink
+{
+public:
+	/// A place in the order of the sink's output.
+	typedef unsigned long ticket_type;
+
+	explicit output_sink(std::ostream &out);
+
+	/**
+	 * Writes out any text still held back, in order, whether or not the text before it has all been committed.
+	 */
+	~output_sink();
+
+	/// @name The sinks of the standard output streams.
+	//@{
+	static output_sink& standard_output();
+	static output_sink& standard_error();
+	static output_sink& standard_log();
+	//@}
+
+	/**
+	 * Reserve the next place in the order of the output.
+	 */
+	ticket_type reserve();
+
+	/**
+	 * Commit the next piece of the text for @a ticket.  It's written out as soon as the text for all the earlier
+	 * tickets has been.
+	 *
+	 * @param last  true if this is the ticket's last piece of text, which releases the text of the tickets after it.
+	 */
+	void commit(ticket_type ticket, const char *text, std::size_t length, bool last);
+
+	/**
+	 * Write @a text straight away, regardless of the order of any reserved output.
+	 */
+	void write(const char *text, std::size_t length);
+
+private:
+
+	/// The text committed for a ticket which can't be written yet.
+	struct pending_text
+	{
+		pending_text() : m_complete(false) {};
+		std::string m_text;
+		bool m_complete;
+	};
+
+	/// Write out the held-back text which the tickets up to m_next_to_write have released.  Must hold m_mutex.
+	void write_released();
+
+	boost::mutex m_mutex;
+
+	std::ostream &m_out;
+
+	/// The next ticket reserve() will hand out.
+	ticket_type m_next_ticket;
+
+	/// The ticket whose text is being written.  Its text goes straight out, that of the tickets after it waits.
+	ticket_type m_next_to_write;
+
+	/// The text of the tickets after m_next_to_write.
+	std::map<ticket_type, pending_text> m_pending;
+};
+
+/**
+ * A std::ostream which collects its text in a large buffer, and commits it to an output_sink each time the buffer
+ * fills and when it's destroyed.
+ *
+ * Flushing the stream, e.g. by inserting std::endl, doesn't commit the buffer, so printers can end their lines
+ * however they like without forcing a write per line.  An output_buffer is meant to be filled by one thread; give
+ * each thread or each printer its own.
+ */
+class output_buffer : public std::ostream
+{
+public:
+	/// The default buffer size.
+	static const std::size_t default_capacity = 64 * 1024;
+
+	/**
+	 * @param sink  The sink to commit the text to.
+	 * @param ordered  If true, the buffer reserves its place in @a sink's output now, and all of its text is written
+	 *        out together in that place.  If false, its text is written out whenever it's committed, a whole number
+	 *        of lines at a time.
+	 * @param capacity  The size of the buffer.
+	 */
+	explicit output_buffer(output_sink &sink, bool ordered = true, std::size_t capacity = default_capacity);
+
+	/// Commits the rest of the text.
+	virtual ~output_buffer();
+
+	/**
+	 * Commit the text buffered so far.
+	 */
+	void commit();
+
+private:
+
+	/// The stream buffer which does the work.
+	class buffer : public std::streambuf
+	{
+	public:
+		buffer(output_sink &sink, bool ordered, std::size_t capacity);
+
+		/// Commit the buffered text.  For unordered buffers, only the complete lines are committed unless @a all.
+		void commit(bool all, bool last);
+
+	protected:
+		virtual int_type overflow(int_type c);
+
+	private:
+		output_sink &m_sink;
+		bool m_ordered;
+		output_sink::ticket_type m_ticket;
+		std::vector<char> m_storage;
+	};
+
+	buffer m_buffer;
+};
+
+#endif /* OUTPUT_SINK_HPP */
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+
+#include "output_sink.hpp"
+
+TEST(OutputSinkTest, OrderedBuffersCommitInOrder)
+{
+	std::ostringstream out;
+	output_sink sink(out);
+
+	{
+		output_buffer first(sink, true, 4);
+		{
+			output_buffer second(sink, true, 4);
+
+			// The second buffer fills and finishes first, but its text waits for the first buffer's.
+			second << "second\n";
+			first << "fir";
+			ASSERT_EQ("", out.str());
+		}
+		ASSERT_EQ("", out.str());
+
+		// Overflowing the first buffer writes its text straight out, since it's first in line.
+		first << "st\n";
+		ASSERT_EQ("firs", out.str());
+	}
+	ASSERT_EQ("first\nsecond\n", out.str());
+
+	// A buffer created after all the others are done goes straight out too.
+	output_buffer third(sink, true, 4);
+	third << "third\n";
+	ASSERT_EQ("first\nsecond\nthir", out.str());
+}
+
+TEST(OutputSinkTest, UnorderedBuffersCommitWholeLines)
+{
+	std::ostringstream out;
+	output_sink sink(out);
+	output_buffer buffer(sink, false, 8);
+
+	// Flushing doesn't commit.
+	buffer << "one\ntwo" << std::endl;
+	ASSERT_EQ("", out.str());
+
+	// Overflowing commits only up to the last complete line.
+	buffer << "three";
+	ASSERT_EQ("one\ntwo\n", out.str());
+
+	// A line longer than the buffer has to be committed in pieces.
+	buffer << "four";
+	ASSERT_EQ("one\ntwo\nthreefou", out.str());
+
+	buffer.commit();
+	ASSERT_EQ("one\ntwo\nthreefour", out.str());
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2011, 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "GraphvizLibrary.h"
+
+#include <cstddef>
+
+#include <boost/thread/mutex.hpp>
+
+#include <graphviz/gvc.h>
+
+/// Serializes the calls into Graphviz.
+static boost::mutex f_graphviz_mutex;
+
+/**
+ * Holder for the one GVC context all renders share, which frees it at exit.
+ */
+class GraphvizContext
+{
+public:
+	GraphvizContext() { m_gvc = NULL; };
+	~GraphvizContext()
+	{
+		if(m_gvc != NULL)
+		{
+			gvFreeContext(m_gvc);
+		}
+	};
+
+	/// The context, created the first time it's needed.  Only touched with f_graphviz_mutex held.
+	GVC_t *m_gvc;
+};
+
+static GraphvizContext f_context;
+
+/**
+ * Call gvRenderData(), whose length parameter is an unsigned int in older Graphviz releases and a size_t in newer
+ * ones.  Passing gvRenderData as @a render lets the compiler work out which.
+ */
+template <typename LengthType>
+static int render_data(int (*render)(GVC_t*, Agraph_t*, const char*, char**, LengthType*),
+		GVC_t *gvc, Agraph_t *graph, const char *format, char **result, std::size_t *length)
+{
+	LengthType render_length = 0;
+	int retval = render(gvc, graph, format, result, &render_length);
+	*length = render_length;
+	return retval;
+}
+
+bool GraphvizLibrary::RenderDot(const std::string &dot_source, std::string *output,
+		ToolDot::OUTPUT_FORMAT_DOT output_format)
+{
+	boost::mutex::scoped_lock lock(f_graphviz_mutex);
+
+	if(f_context.m_gvc == NULL)
+	{
+		f_context.m_gvc = gvContext();
+		if(f_context.m_gvc == NULL)
+		{
+			return false;
+		}
+	}
+	GVC_t *gvc = f_context.m_gvc;
+
+	// Older cgraphs take a non-const char*, but don't modify it.
+	Agraph_t *graph = agmemread(const_cast<char*>(dot_source.c_str()));
+	if(graph == NULL)
+	{
+		return false;
+	}
+
+	bool succeeded = false;
+	if(gvLayout(gvc, graph, "dot") == 0)
+	{
+		char *result = NULL;
+		std::size_t length = 0;
+
+		if(render_data(gvRenderData, gvc, graph, ToolDot::format_strings[output_format], &result, &length) == 0)
+		{
+			output->assign(result, length);
+			succeeded = true;
+		}
+		if(result != NULL)
+		{
+			gvFreeRenderData(result);
+		}
+		gvFreeLayout(gvc, graph);
+	}
+	agclose(graph);
+
+	return succeeded;
+}
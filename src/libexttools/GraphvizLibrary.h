@@ -0,0 +1,59 @@
+/*
+ * Copyright 2011, 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#ifndef GRAPHVIZLIBRARY_H
+#define	GRAPHVIZLIBRARY_H
+
+#include <string>
+
+#include "ToolDot.h"
+
+/**
+ * Facade for the [Graphviz] libgvc and libcgraph libraries, for rendering graphs in-process instead of running dot.
+ * Only built when CoFlo was configured --with-libgvc, which defines HAVE_LIBGVC.
+ *
+ * Graphviz's parser and layout engines keep some of their state in globals, so the library calls are serialized,
+ * and all renders share one GVC context, created by the first of them.  What does run in parallel is everything
+ * around them: generating the dot text, and writing out the result.
+ *
+ * [Graphviz]: http://www.graphviz.org/ "Graphviz"
+ */
+class GraphvizLibrary
+{
+public:
+
+	/**
+	 * Lay out the graph described by @a dot_source with the dot layout engine and render it, all in memory.
+	 *
+	 * @param dot_source     The graph, in the dot language.
+	 * @param output         The rendered graph.
+	 * @param output_format  The output format to be generated.
+	 *
+	 * @return true on success, false if the graph couldn't be parsed, laid out, or rendered.  Graphviz will have
+	 * reported why on stderr.
+	 */
+	static bool RenderDot(const std::string &dot_source, std::string *output,
+			ToolDot::OUTPUT_FORMAT_DOT output_format = ToolDot::SVG);
+
+private:
+	/// Not instantiable.
+	GraphvizLibrary();
+};
+
+#endif	/* GRAPHVIZLIBRARY_H */
@@ -17,13 +17,43 @@
 
 /** @file */
 
+#include <sys/wait.h>
+
 #include <iostream>
 #include <sstream>
 
+#include <boost/foreach.hpp>
+
 #include "ToolDot.h"
 
 const char* ToolDot::format_strings[] = { "svg", "png" };
 
+/**
+ * Check the status returned by ToolBase::System() for a dot run, reporting any failure.
+ *
+ * @return true if dot ran and exited with 0.
+ */
+static bool check_dot_status(int status, const std::string &what)
+{
+	if(status == -1)
+	{
+		std::cerr << "ERROR: Couldn't run dot for " << what << "." << std::endl;
+		return false;
+	}
+	else if(!WIFEXITED(status))
+	{
+		std::cerr << "ERROR: dot was terminated abnormally while compiling " << what << "." << std::endl;
+		return false;
+	}
+	else if(WEXITSTATUS(status) != 0)
+	{
+		std::cerr << "ERROR: dot returned " << WEXITSTATUS(status) << " while compiling " << what << "." << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
 ToolDot::ToolDot(const std::string &cmd)
 {
 	SetCommand(cmd);
@@ -36,8 +66,26 @@ ToolDot::~ToolDot() { }
 bool ToolDot::CompileDotToPNG(const std::string &dot_filename, const std::string &output_filename,
 		OUTPUT_FORMAT_DOT output_format) const
 {
-	System((" -o" + output_filename + " -T" + format_strings[output_format] + " "+ dot_filename).c_str());
-	
-	/// @todo Handle errors.
-	return true;
+	int status = System((" -o" + output_filename + " -T" + format_strings[output_format] + " "+ dot_filename).c_str());
+
+	return check_dot_status(status, dot_filename);
+}
+
+bool ToolDot::CompileDotFiles(const std::vector< std::string > &dot_filenames, OUTPUT_FORMAT_DOT output_format) const
+{
+	if(dot_filenames.empty())
+	{
+		return true;
+	}
+
+	std::string params = std::string(" -T") + format_strings[output_format] + " -O";
+	BOOST_FOREACH(const std::string &dot_filename, dot_filenames)
+	{
+		params += " \"" + dot_filename + "\"";
+	}
+
+	std::ostringstream what;
+	what << dot_filenames.size() << " files starting with " << dot_filenames.front();
+
+	return check_dot_status(System(params), what.str());
 }
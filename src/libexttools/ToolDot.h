@@ -23,6 +23,7 @@
 #include "ToolBase.h"
 
 #include <string>
+#include <vector>
 
 /**
  * Facade for the [Graphviz] dot tool.
@@ -55,10 +56,33 @@ public:
 	 * @param output_filename Path to the output file.
 	 * @param output_format   The output format to be generated.
 	 *
-	 * @return
+	 * @return true if dot succeeded.
 	 */
 	bool CompileDotToPNG(const std::string &dot_filename, const std::string &output_filename,
 			OUTPUT_FORMAT_DOT output_format = ToolDot::SVG) const;
+
+	/**
+	 * Generates a graphic file from each of the given *.dot files with a single invocation of dot, using its -O
+	 * option.  Each output file is named after its input file with the format appended, e.g. "foo.dot" becomes
+	 * "foo.dot.svg".  This saves starting a dot process per graph when there are a lot of them.
+	 *
+	 * This only runs the dot process, so it can be called from several threads at once.
+	 *
+	 * @param dot_filenames  Paths to the input dot files.
+	 * @param output_format  The output format to be generated.
+	 *
+	 * @return true if dot succeeded on all the files.  If it didn't, some of the outputs may still have been generated.
+	 */
+	bool CompileDotFiles(const std::vector< std::string > &dot_filenames,
+			OUTPUT_FORMAT_DOT output_format = ToolDot::SVG) const;
+
+	/**
+	 * @return The name of the file CompileDotFiles() generates from @a dot_filename.
+	 */
+	static std::string GetCompiledFilename(const std::string &dot_filename, OUTPUT_FORMAT_DOT output_format = ToolDot::SVG)
+	{
+		return dot_filename + "." + format_strings[output_format];
+	};
 	
 protected:
 	
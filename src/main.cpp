@@ -19,11 +19,15 @@
 #include <vector>
 #include <iostream>
 #include <fstream>
+#include <set>
+#include <sstream>
 
 #include <boost/version.hpp>
 #include <boost/config.hpp>
 #include <boost/program_options.hpp>
 #include <boost/exception/all.hpp>
+#include <boost/foreach.hpp>
+#include <boost/scoped_ptr.hpp>
 
 // Include the config.h file generated by configure.
 #include "../config.h"
@@ -35,9 +39,43 @@
 
 #include "Function.h"
 #include "Program.h"
+#include "ProgramImage.h"
 #include "libexttools/ToolCompiler.h"
 #include "libexttools/ToolDot.h"
 #include "controlflowgraph/analysis/Analyzer.h"
+#include "controlflowgraph/analysis/ResultsSink.h"
+
+/**
+ * Create the ResultsSink for the results format and file given on the command line.
+ *
+ * @return The sink, or NULL if it couldn't be created.
+ */
+static ResultsSink* create_results_sink(const boost::program_options::variables_map &vm)
+{
+	std::string path;
+
+	if(vm.count(CLP_RESULTS_FILE) > 0)
+	{
+		path = vm[CLP_RESULTS_FILE].as<std::string>();
+	}
+
+	return ResultsSink::Create(vm[CLP_RESULTS_FORMAT].as<std::string>(), path);
+}
+
+/**
+ * Parse a shard specification of the form "I/N".
+ *
+ * @return true if @a spec was valid, i.e. 1 <= I <= N.
+ */
+static bool parse_shard_spec(const std::string &spec, long *shard_index, long *num_shards)
+{
+	std::istringstream iss(spec);
+	char slash = 0;
+
+	iss >> *shard_index >> slash >> *num_shards;
+
+	return !iss.fail() && iss.eof() && (slash == '/') && (*shard_index >= 1) && (*shard_index <= *num_shards);
+}
 
 /**
  * CoFlo entry point.
@@ -51,9 +89,13 @@ int main(int argc, char* argv[])
 	// Wrap the whole program in a try/catch block.
 	try
 	{
-		Program *the_program;
+		Program *the_program = NULL;
 		Analyzer *the_analyzer;
 
+		// Owns the_program, so that however we leave main(), its worker threads are stopped and joined, and their
+		// last debug output is written.
+		boost::scoped_ptr<Program> program_owner;
+
 		// Subprograms we'll need.
 		std::string the_filter;
 		std::string the_gcc;
@@ -79,6 +121,10 @@ int main(int argc, char* argv[])
 		bool cfg_verbose = false;
 		// Enable or disable outputting vertex IDs.
 		bool cfg_vertex_ids = false;
+
+		// If this is one shard of a sharded analysis, which one, 1-based, and how many there are.
+		long shard_index = 0;
+		long num_shards = 0;
 	
 		// Declare a variables_map to take the command line options we're passed.
 		boost::program_options::variables_map vm;
@@ -107,6 +153,64 @@ int main(int argc, char* argv[])
 			debug_cfg = vm[CLP_DEBUG_CFG].as<bool>();
 			cfg_fmt = vm[CLP_CFG_FMT].as<std::string>();
 
+			// Is this the merge step of a sharded analysis?
+			if(vm.count(CLP_MERGE) > 0)
+			{
+				// Yes.  Everything we need is in the shard images, so there's nothing to parse.
+				if((vm.count(CLP_INPUT_FILE) > 0) || (vm.count(CLP_SHARD) > 0) || vm.count(CLP_PRINT_FUNCTION_CFG)
+						|| (vm.count(CLP_OUTPUT_DIR) > 0))
+				{
+					std::cerr << "ERROR: --" CLP_MERGE " can't be combined with input files, --" CLP_SHARD ", --"
+							CLP_PRINT_FUNCTION_CFG ", or --" CLP_OUTPUT_DIR "." << std::endl;
+					return 1;
+				}
+
+				ProgramImage image;
+				BOOST_FOREACH(const std::string &image_path, vm[CLP_MERGE].as< std::vector<std::string> >())
+				{
+					std::cout << "Reading image \"" << image_path << "\"..." << std::endl;
+					if(!image.Read(image_path))
+					{
+						return 1;
+					}
+				}
+				if(image.GetNumDuplicateFunctions() > 0)
+				{
+					std::cout << "Skipped " << image.GetNumDuplicateFunctions() << " duplicate function definitions." << std::endl;
+				}
+
+				std::cout << "Linking function calls..." << std::endl;
+				std::set<std::string> unresolved_identifiers;
+				image.Link(&unresolved_identifiers);
+				if(!unresolved_identifiers.empty())
+				{
+					std::cout << "WARNING: Unresolved function calls:" << std::endl;
+					BOOST_FOREACH(const std::string &identifier, unresolved_identifiers)
+					{
+						std::cout << "WARNING: Unresolved function call to: " << identifier << std::endl;
+					}
+				}
+
+				if(vm.count(CLP_CONSTRAINT) > 0)
+				{
+					ResultsSink *results_sink = create_results_sink(vm);
+					if(results_sink == NULL)
+					{
+						return 1;
+					}
+					Analyzer image_analyzer;
+					bool checked_all = image_analyzer.AnalyzeImage(image,
+							vm[CLP_CONSTRAINT].as< std::vector<std::string> >(), results_sink);
+					delete results_sink;
+					if(!checked_all)
+					{
+						return 1;
+					}
+				}
+
+				return 0;
+			}
+
 			// Were any source files given on the command line?
 			if(vm.count(CLP_INPUT_FILE)>0)
 			{
@@ -120,8 +224,11 @@ int main(int argc, char* argv[])
 					dlog_cfg.enable(debug_cfg);
 
 					the_program = new Program();
+					program_owner.reset(the_program);
 					the_analyzer = new Analyzer();
 
+					the_program->SetNumberOfJobs(vm[CLP_JOBS].as<unsigned int>());
+
 					const std::vector<std::string> *defines, *includes;
 					if(vm.count(CLP_DEFINE)>0)
 					{
@@ -154,7 +261,32 @@ int main(int argc, char* argv[])
 					std::cerr << "Setting GCC..." << std::endl;
 					the_program->SetTheGcc(tool_compiler);
 					std::cerr << "Adding source files..." << std::endl;
-					the_program->AddSourceFiles(vm[CLP_INPUT_FILE].as< std::vector<std::string> >());
+					std::vector<std::string> input_files = vm[CLP_INPUT_FILE].as< std::vector<std::string> >();
+					if(vm.count(CLP_SHARD) > 0)
+					{
+						// Only take every N'th file, starting with the I'th.
+						if(!parse_shard_spec(vm[CLP_SHARD].as<std::string>(), &shard_index, &num_shards))
+						{
+							std::cerr << "ERROR: Invalid shard \"" << vm[CLP_SHARD].as<std::string>()
+									<< "\", expected \"I/N\" with 1 <= I <= N." << std::endl;
+							return 1;
+						}
+						if((vm.count(CLP_CONSTRAINT) > 0) || vm.count(CLP_PRINT_FUNCTION_CFG) || (vm.count(CLP_OUTPUT_DIR) > 0))
+						{
+							std::cerr << "ERROR: A shard only writes an image.  Give --" CLP_CONSTRAINT " to --" CLP_MERGE
+									" instead, and --" CLP_PRINT_FUNCTION_CFG " and --" CLP_OUTPUT_DIR " to an unsharded run." << std::endl;
+							return 1;
+						}
+						std::vector<std::string> shard_files;
+						for(long i = shard_index-1; i < static_cast<long>(input_files.size()); i += num_shards)
+						{
+							shard_files.push_back(input_files[i]);
+						}
+						input_files.swap(shard_files);
+						std::cout << "Shard " << shard_index << " of " << num_shards << ": " << input_files.size()
+								<< " source files." << std::endl;
+					}
+					the_program->AddSourceFiles(input_files);
 
 					// Parse the program.
 					T_ID_TO_FUNCTION_CALL_UNRESOLVED_MAP unresolved_function_calls;
@@ -169,6 +301,24 @@ int main(int argc, char* argv[])
 						return 1;
 					}
 
+					if(num_shards > 0)
+					{
+						// This is one shard of a sharded analysis.  Calls into other shards can't be resolved
+						// until the merge, so don't complain about them.  Just write our image.
+						std::string image_path;
+						if(vm.count(CLP_IMAGE_FILE) > 0)
+						{
+							image_path = vm[CLP_IMAGE_FILE].as<std::string>();
+						}
+						else
+						{
+							std::ostringstream oss;
+							oss << "coflo-shard-" << shard_index << "-of-" << num_shards << ".img";
+							image_path = oss.str();
+						}
+						return the_program->WriteImage(image_path) ? 0 : 1;
+					}
+
 					// Print any function calls that we couldn't link.
 					the_program->PrintUnresolvedFunctionCalls(&unresolved_function_calls);
 				}
@@ -207,7 +357,10 @@ int main(int argc, char* argv[])
 						std::cerr << "ERROR: Must specify output filename with img format." << std::endl;
 					}
 					ToolDot *tool_dot = new ToolDot(the_dot);
-					fp->PrintControlFlowGraphBitmap(tool_dot, output_filename);
+					if(!fp->PrintControlFlowGraphBitmap(tool_dot, output_filename))
+					{
+						return 1;
+					}
 				}
 				else if (cfg_fmt == "dot")
 				{
@@ -230,6 +383,11 @@ int main(int argc, char* argv[])
 			if(vm.count(CLP_CONSTRAINT) > 0)
 			{
 				// User wants to run some analysis.
+				ResultsSink *results_sink = create_results_sink(vm);
+				if(results_sink == NULL)
+				{
+					return 1;
+				}
 
 				the_analyzer->AttachToProgram(the_program);
 
@@ -237,7 +395,8 @@ int main(int argc, char* argv[])
 				the_analyzer->AddConstraints(vm[CLP_CONSTRAINT].as< std::vector<std::string> >());
 
 				// Perform the analysis.
-				the_analyzer->Analyze();
+				the_analyzer->Analyze(results_sink);
+				delete results_sink;
 			}
 
 			// Does the user want a report generated?
@@ -245,10 +404,23 @@ int main(int argc, char* argv[])
 			{
 				// User wants HTML output of the CFGs of all the functions.
 				report_output_directory = vm[CLP_OUTPUT_DIR].as<std::string>();
-				ToolDot *tool_dot = new ToolDot(the_dot);
-				the_program->SetTheDot(tool_dot);
-				std::cout << "Using Dot version: " << tool_dot->GetVersion() << std::endl;
-				the_program->Print(report_output_directory);
+				if(vm[CLP_REPORT_USE_DOT].as<bool>())
+				{
+					// Otherwise the Program lays out the graphs itself.
+#if HAVE_LIBGVC
+					// We have the Graphviz libraries, so we don't need to run dot.
+					the_program->SetUseGraphvizLibrary(true);
+					std::cout << "Using the Graphviz libraries" << std::endl;
+#else
+					ToolDot *tool_dot = new ToolDot(the_dot);
+					the_program->SetTheDot(tool_dot);
+					std::cout << "Using Dot version: " << tool_dot->GetVersion() << std::endl;
+#endif
+				}
+				if(!the_program->Print(report_output_directory))
+				{
+					return 1;
+				}
 			}
 
 		}
@@ -288,11 +288,12 @@ statement_one_line
 return_statement
 	: location 'return' var_id
 		{
-			$$.m_statement = new ReturnUnlinked(*($0.m_location), *($2.m_str));
+			/// @todo Create a real Return class.
+			$$.m_statement = new Goto(*($0.m_location), "EXIT");
 		}
 	| location 'return'
 		{
-			$$.m_statement = new ReturnUnlinked(*($0.m_location), "");
+			$$.m_statement = new Goto(*($0.m_location), "EXIT");
 		}
 	;
 	
@@ -364,10 +365,10 @@ if
 	: location 'if' '(' condition ')' goto_statement ';' 'else' goto_statement ';'
 		{
 			$$.m_str = new M_TO_STR($n3);
-			$$.m_statement = new IfUnlinked(*($0.m_location),
+			$$.m_statement = new If(*($0.m_location),
 					*($$.m_str),
-					dynamic_cast<GotoUnlinked*>($5.m_statement),
-					dynamic_cast<GotoUnlinked*>($8.m_statement));
+					dynamic_cast<Goto*>($5.m_statement)->GetTarget(),
+					dynamic_cast<Goto*>($8.m_statement)->GetTarget());
 			delete $$.m_str;
 		}
 	;
@@ -420,31 +421,31 @@ comparison_operator
 function_call
 	: location identifier '(' argument_expression_list ')'
 		{
-			$$.m_statement = new FunctionCallUnresolved(M_TO_STR($n1), *($0.m_location), M_TO_STR($n3));
+			$$.m_statement = new FunctionCall(M_TO_STR($n1), *($0.m_location), M_TO_STR($n3));
 		}
 	| location identifier_ssa '(' argument_expression_list ')'
 		{
 			// This should pretty much always be a function call through a compiler-generated function
 			// pointer.
-			$$.m_statement = new FunctionCallUnresolved(M_TO_STR($n1), *($0.m_location), M_TO_STR($n3));
+			$$.m_statement = new FunctionCall(M_TO_STR($n1), *($0.m_location), M_TO_STR($n3));
 		}
 	;
 
 goto_statement
 	: location 'goto' synthetic_label_id
 		{
-			$$.m_statement = new GotoUnlinked(*($0.m_location), *($2.m_str));
+			$$.m_statement = new Goto(*($0.m_location), *($2.m_str));
 		}
 	| location 'goto' identifier
 		{
-			$$.m_statement = new GotoUnlinked(*($0.m_location), *($2.m_str));
+			$$.m_statement = new Goto(*($0.m_location), *($2.m_str));
 		}
 	;
 	
 label_statement
 	: location synthetic_label_id ':'
 		{
-			$$.m_statement = new Label(*($0.m_location), *($1.m_str));
+			$$.m_statement = new Label(*($0.m_location), *($1.m_str), true);
 		}
 	| location identifier ':'
 		{
@@ -455,13 +456,13 @@ label_statement
 switch
 	: location 'switch' '(' var_or_constant ')' switch_case_list
 		{
-			$$.m_statement = new SwitchUnlinked(*($0.m_location));
+			$$.m_statement = new Switch(*($0.m_location));
 			$0.m_location = NULL;
 			
 			StatementList::iterator it;
 			for(it=$5.m_statement_list->begin(); it != $5.m_statement_list->end(); ++it)
 			{
-				dynamic_cast<SwitchUnlinked*>($$.m_statement)->InsertCase(dynamic_cast<CaseUnlinked*>(*it));
+				dynamic_cast<Switch*>($$.m_statement)->InsertCase(dynamic_cast<CaseUnlinked*>(*it)->GetTarget());
 			}
 		}
 	;
@@ -0,0 +1,216 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "StreamingTemplate.h"
+
+#include <ostream>
+
+/// The start and end of an insertion point.
+static const char f_insertion_point_start[] = "<!-- ";
+static const char f_insertion_point_end[] = " -->";
+
+/// The insertion points marking the start and end of a development-only section, and what replaces it.
+static const char f_remove_start_name[] = "REMOVE_START";
+static const char f_remove_end[] = "<!-- REMOVE_END -->";
+static const char f_removed_text[] = "<!-- REMOVED DEV TEXT -->";
+
+/**
+ * @return true if [@a begin, @a end) is a valid placeholder or insertion point name.
+ */
+static bool is_name(std::string::const_iterator begin, std::string::const_iterator end)
+{
+	if(begin == end)
+	{
+		return false;
+	}
+
+	for(; begin != end; ++begin)
+	{
+		char c = *begin;
+		if(!((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_'))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+StreamingTemplate::StreamingTemplate(const std::string &text)
+{
+	const std::string insertion_point_start(f_insertion_point_start);
+	const std::string insertion_point_end(f_insertion_point_end);
+	const std::string remove_end(f_remove_end);
+	const std::string removed_text(f_removed_text);
+
+	std::string::const_iterator text_start = text.begin();
+	std::string::size_type i = 0;
+
+	while(i < text.size())
+	{
+		if(text[i] == '@')
+		{
+			std::string::size_type name_end = text.find('@', i + 1);
+
+			if(name_end != std::string::npos && is_name(text.begin() + i + 1, text.begin() + name_end))
+			{
+				// It's a placeholder.
+				AppendText(text_start, text.begin() + i);
+
+				Piece p;
+				p.m_kind = Piece::PLACEHOLDER;
+				p.m_text.assign(text.begin() + i + 1, text.begin() + name_end);
+				m_pieces.push_back(p);
+
+				i = name_end + 1;
+				text_start = text.begin() + i;
+				continue;
+			}
+		}
+		else if(text.compare(i, insertion_point_start.size(), insertion_point_start) == 0)
+		{
+			std::string::size_type name_start = i + insertion_point_start.size();
+			std::string::size_type name_end = text.find(insertion_point_end, name_start);
+
+			std::string::size_type section_end;
+			if(name_end != std::string::npos && text.compare(name_start, name_end - name_start, f_remove_start_name) == 0
+					&& (section_end = text.find(remove_end, name_end)) != std::string::npos)
+			{
+				// It's the start of a development-only section.  Drop everything up to and including its end.
+				AppendText(text_start, text.begin() + i);
+				AppendText(removed_text.begin(), removed_text.end());
+
+				i = section_end + remove_end.size();
+				text_start = text.begin() + i;
+				continue;
+			}
+			else if(name_end != std::string::npos && is_name(text.begin() + name_start, text.begin() + name_end))
+			{
+				// It's an insertion point.
+				AppendText(text_start, text.begin() + i);
+
+				Piece p;
+				p.m_kind = Piece::INSERTION_POINT;
+				p.m_text.assign(text.begin() + i, text.begin() + name_end + insertion_point_end.size());
+				m_insertion_points[std::string(text.begin() + name_start, text.begin() + name_end)] = m_pieces.size();
+				m_pieces.push_back(p);
+
+				i = name_end + insertion_point_end.size();
+				text_start = text.begin() + i;
+				continue;
+			}
+		}
+
+		++i;
+	}
+
+	AppendText(text_start, text.end());
+}
+
+StreamingTemplate::~StreamingTemplate()
+{
+}
+
+void StreamingTemplate::Write(std::ostream &out, const values_type &values) const
+{
+	WritePieces(out, values, 0, m_pieces.size());
+}
+
+bool StreamingTemplate::WriteSection(std::ostream &out, const values_type &values, const std::string &from,
+		const std::string &to) const
+{
+	std::size_t begin, end;
+
+	if(!FindInsertionPoint(from, 0, &begin) || !FindInsertionPoint(to, m_pieces.size(), &end) || end < begin)
+	{
+		return false;
+	}
+
+	WritePieces(out, values, begin, end);
+
+	return true;
+}
+
+bool StreamingTemplate::HasInsertionPoint(const std::string &name) const
+{
+	return m_insertion_points.count(name) > 0;
+}
+
+void StreamingTemplate::AppendText(std::string::const_iterator begin, std::string::const_iterator end)
+{
+	if(begin == end)
+	{
+		return;
+	}
+
+	if(m_pieces.empty() || m_pieces.back().m_kind != Piece::TEXT)
+	{
+		Piece p;
+		p.m_kind = Piece::TEXT;
+		m_pieces.push_back(p);
+	}
+
+	m_pieces.back().m_text.append(begin, end);
+}
+
+void StreamingTemplate::WritePieces(std::ostream &out, const values_type &values, std::size_t begin,
+		std::size_t end) const
+{
+	for(std::size_t i = begin; i < end; ++i)
+	{
+		const Piece &p = m_pieces[i];
+
+		if(p.m_kind == Piece::PLACEHOLDER)
+		{
+			values_type::const_iterator value = values.find(p.m_text);
+			if(value != values.end())
+			{
+				out << value->second;
+			}
+			else
+			{
+				// No value, leave it as it was.
+				out << '@' << p.m_text << '@';
+			}
+		}
+		else
+		{
+			out << p.m_text;
+		}
+	}
+}
+
+bool StreamingTemplate::FindInsertionPoint(const std::string &name, std::size_t default_index,
+		std::size_t *index) const
+{
+	if(name.empty())
+	{
+		*index = default_index;
+		return true;
+	}
+
+	std::map<std::string, std::size_t>::const_iterator it = m_insertion_points.find(name);
+	if(it == m_insertion_points.end())
+	{
+		return false;
+	}
+
+	*index = it->second;
+	return true;
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#ifndef STREAMINGTEMPLATE_H_
+#define STREAMINGTEMPLATE_H_
+
+#include <cstddef>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * A template which is parsed once, and can then be written out to a stream any number of times, a section at a time,
+ * with its placeholders filled in.
+ *
+ * Unlike FileTemplate, which rewrites its whole contents with a regex for every change, nothing is ever accumulated
+ * in memory.  To build a large file, the caller writes the template up to an insertion point, writes whatever goes
+ * there directly to the same stream, and then carries on with the next section.  The cost is linear in the size of
+ * the output.
+ *
+ * The template text can contain:
+ * - Placeholders, "@NAME@", which are replaced with the value given for NAME when the template is written out.  A
+ *   placeholder without a value is written out unchanged.
+ * - Insertion points, "<!-- NAME -->" on their own, which split the template into sections.  They're written out
+ *   unchanged.
+ *
+ * In both cases NAME consists of upper case letters, digits and underscores.  Any other '@' or comment is just text.
+ *
+ * Everything from "<!-- REMOVE_START -->" up to and including the next "<!-- REMOVE_END -->" is sample content for
+ * viewing the template itself during development.  It's dropped when the template is parsed, and replaced with the
+ * comment "<!-- REMOVED DEV TEXT -->".
+ */
+class StreamingTemplate
+{
+public:
+	/// @name Member types.
+	///@{
+
+	/// Map of placeholder names, without the '@'s, to their values.
+	typedef std::map<std::string, std::string> values_type;
+
+	///@}
+
+public:
+	/**
+	 * Parse @a text into a template.
+	 */
+	explicit StreamingTemplate(const std::string &text);
+	~StreamingTemplate();
+
+	/**
+	 * Write the whole template to @a out.
+	 *
+	 * @param out     The stream to write to.
+	 * @param values  The values of the placeholders.
+	 */
+	void Write(std::ostream &out, const values_type &values) const;
+
+	/**
+	 * Write the section of the template from insertion point @a from up to, but not including, insertion point @a to.
+	 * Anything written to @a out before the next section is written ends up immediately before insertion point @a to,
+	 * just like FileTemplate::regex_insert_before().
+	 *
+	 * @param out     The stream to write to.
+	 * @param values  The values of the placeholders.
+	 * @param from    The name of the insertion point to start at, or the empty string for the start of the template.
+	 * @param to      The name of the insertion point to stop at, or the empty string for the end of the template.
+	 *
+	 * @return false if either insertion point isn't in the template, or @a to comes before @a from.
+	 */
+	bool WriteSection(std::ostream &out, const values_type &values, const std::string &from,
+			const std::string &to) const;
+
+	/**
+	 * @return true if the template has an insertion point named @a name.
+	 */
+	bool HasInsertionPoint(const std::string &name) const;
+
+private:
+
+	/// A piece of the parsed template.
+	struct Piece
+	{
+		enum Kind { TEXT, PLACEHOLDER, INSERTION_POINT };
+
+		Kind m_kind;
+
+		/// The text to write out for TEXT and INSERTION_POINT pieces, and the name of a PLACEHOLDER.
+		std::string m_text;
+	};
+
+	/// Append the text from @a begin to @a end to m_pieces, merging it with the previous piece if that's text too.
+	void AppendText(std::string::const_iterator begin, std::string::const_iterator end);
+
+	/// Write m_pieces[@a begin] to m_pieces[@a end - 1] to @a out.
+	void WritePieces(std::ostream &out, const values_type &values, std::size_t begin, std::size_t end) const;
+
+	/**
+	 * Find the piece index of the insertion point named @a name, with the empty string meaning @a default_index.
+	 *
+	 * @return true if it was found.
+	 */
+	bool FindInsertionPoint(const std::string &name, std::size_t default_index, std::size_t *index) const;
+
+	/// The parsed template.
+	std::vector<Piece> m_pieces;
+
+	/// Map of the insertion point names to their indices in m_pieces.
+	std::map<std::string, std::size_t> m_insertion_points;
+};
+
+#endif /* STREAMINGTEMPLATE_H_ */
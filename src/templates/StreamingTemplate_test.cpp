@@ -0,0 +1,75 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+
+#include "StreamingTemplate.h"
+
+TEST(StreamingTemplateTest, ReplacesPlaceholders)
+{
+	StreamingTemplate t("<a href=\"#@ID@\">@ID@()</a> @UNSET@ mail@example.com @lower@");
+	StreamingTemplate::values_type values;
+	std::ostringstream out;
+
+	values["ID"] = "main";
+	t.Write(out, values);
+
+	ASSERT_EQ("<a href=\"#main\">main()</a> @UNSET@ mail@example.com @lower@", out.str());
+}
+
+TEST(StreamingTemplateTest, WritesSectionsAroundInsertionPoints)
+{
+	StreamingTemplate t("<h1>@TITLE@</h1>\n<!-- LIST_START -->\n<!-- LIST_END -->\n<!-- not a point -->\n");
+	StreamingTemplate::values_type values;
+	std::ostringstream out;
+
+	values["TITLE"] = "Report";
+	ASSERT_TRUE(t.HasInsertionPoint("LIST_END"));
+	ASSERT_FALSE(t.HasInsertionPoint("not a point"));
+
+	ASSERT_TRUE(t.WriteSection(out, values, "", "LIST_END"));
+	out << "item 1\n" << "item 2\n";
+	ASSERT_TRUE(t.WriteSection(out, values, "LIST_END", ""));
+
+	ASSERT_EQ("<h1>Report</h1>\n<!-- LIST_START -->\nitem 1\nitem 2\n<!-- LIST_END -->\n<!-- not a point -->\n",
+			out.str());
+
+	// Sections have to run forwards, between insertion points which exist.
+	ASSERT_FALSE(t.WriteSection(out, values, "LIST_END", "LIST_START"));
+	ASSERT_FALSE(t.WriteSection(out, values, "", "NO_SUCH_POINT"));
+}
+
+TEST(StreamingTemplateTest, DropsDevelopmentOnlySections)
+{
+	StreamingTemplate t("<ul>\n<!-- REMOVE_START -->\n<li>@SAMPLE@</li>\n<!-- LIST_END -->\n<!-- REMOVE_END -->\n"
+			"<!-- LIST_END -->\n</ul>\n");
+	StreamingTemplate::values_type values;
+	std::ostringstream out;
+
+	// Insertion points in the dropped section are dropped with it.
+	ASSERT_TRUE(t.WriteSection(out, values, "", "LIST_END"));
+	out << "<li>item</li>\n";
+	ASSERT_TRUE(t.WriteSection(out, values, "LIST_END", ""));
+	ASSERT_FALSE(t.HasInsertionPoint("REMOVE_START"));
+
+	ASSERT_EQ("<ul>\n<!-- REMOVED DEV TEXT -->\n<li>item</li>\n<!-- LIST_END -->\n</ul>\n", out.str());
+}
@@ -0,0 +1,339 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "TarArchive.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/foreach.hpp>
+
+/// Size of a tar block.  Headers take one block, and file contents are padded to a whole number of blocks.
+static const std::size_t f_block_size = 512;
+
+/// @name Offsets and sizes of the header fields we use.
+//@{
+static const std::size_t f_name_offset = 0, f_name_size = 100;
+static const std::size_t f_size_offset = 124, f_size_size = 12;
+static const std::size_t f_checksum_offset = 148, f_checksum_size = 8;
+static const std::size_t f_typeflag_offset = 156;
+static const std::size_t f_magic_offset = 257;
+static const std::size_t f_prefix_offset = 345, f_prefix_size = 155;
+//@}
+
+/**
+ * @return The NUL-terminated or @a size-character string at @a field.
+ */
+static std::string header_string(const unsigned char *field, std::size_t size)
+{
+	const unsigned char *end = std::find(field, field + size, '\0');
+	return std::string(field, end);
+}
+
+/**
+ * Parse the octal number in the header field at @a field.
+ *
+ * @return false if it isn't one.
+ */
+static bool header_number(const unsigned char *field, std::size_t size, std::size_t *value)
+{
+	std::size_t i = 0;
+	bool have_digit = false;
+
+	*value = 0;
+
+	// Skip leading spaces.
+	while(i < size && field[i] == ' ')
+	{
+		++i;
+	}
+
+	for(; i < size && field[i] >= '0' && field[i] <= '7'; ++i)
+	{
+		*value = (*value << 3) + (field[i] - '0');
+		have_digit = true;
+	}
+
+	// The rest must be terminators.
+	for(; i < size; ++i)
+	{
+		if(field[i] != ' ' && field[i] != '\0')
+		{
+			return false;
+		}
+	}
+
+	return have_digit;
+}
+
+/**
+ * @return true if @a header's checksum is right.
+ */
+static bool header_checksum_ok(const unsigned char *header)
+{
+	std::size_t stored_checksum;
+	if(!header_number(header + f_checksum_offset, f_checksum_size, &stored_checksum))
+	{
+		return false;
+	}
+
+	// The checksum is the sum of all the header bytes, with the checksum field itself taken as spaces.
+	std::size_t checksum = 0;
+	for(std::size_t i = 0; i < f_block_size; ++i)
+	{
+		if(i >= f_checksum_offset && i < f_checksum_offset + f_checksum_size)
+		{
+			checksum += ' ';
+		}
+		else
+		{
+			checksum += header[i];
+		}
+	}
+
+	return checksum == stored_checksum;
+}
+
+/**
+ * Find the "path" record in the POSIX pax extended header records @a records.
+ *
+ * @return The path, or the empty string if there isn't one.
+ */
+static std::string pax_path(const std::string &records)
+{
+	std::string::size_type pos = 0;
+	std::string path;
+
+	// Each record is "<length> <keyword>=<value>\n", with the length counting the whole record.
+	while(pos < records.size())
+	{
+		std::string::size_type space = records.find(' ', pos);
+		if(space == std::string::npos)
+		{
+			break;
+		}
+
+		std::size_t length = 0;
+		for(std::string::size_type i = pos; i < space; ++i)
+		{
+			if(records[i] < '0' || records[i] > '9')
+			{
+				return path;
+			}
+			length = length * 10 + (records[i] - '0');
+		}
+		if(length <= space - pos + 1 || pos + length > records.size())
+		{
+			break;
+		}
+
+		// Strip the newline at the end.
+		std::string record = records.substr(space + 1, pos + length - space - 2);
+		if(record.compare(0, 5, "path=") == 0)
+		{
+			path = record.substr(5);
+		}
+
+		pos += length;
+	}
+
+	return path;
+}
+
+/**
+ * @return true if @a name is a relative path which doesn't go up out of the directory it's extracted to.
+ */
+static bool is_safe_path(const std::string &name)
+{
+	boost::filesystem::path path(name);
+
+	if(name.empty() || path.has_root_path())
+	{
+		return false;
+	}
+
+	BOOST_FOREACH(const boost::filesystem::path &component, path)
+	{
+		if(component == "..")
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+TarArchive::TarArchive(const unsigned char *data, std::size_t size)
+{
+	m_data = data;
+	m_size = size;
+}
+
+TarArchive::~TarArchive()
+{
+}
+
+bool TarArchive::ExtractTo(const boost::filesystem::path &output_dir, long *num_files_written,
+		long *num_files_skipped) const
+{
+	std::size_t offset = 0;
+
+	// Set by GNU long name and pax extended headers, to override the name in the next header.
+	std::string long_name;
+
+	*num_files_written = 0;
+	*num_files_skipped = 0;
+
+	while(offset + f_block_size <= m_size)
+	{
+		const unsigned char *header = m_data + offset;
+		offset += f_block_size;
+
+		// The archive ends with zero blocks.  Concatenated archives can have some in the middle too, so skip them.
+		if(std::count(header, header + f_block_size, 0) == static_cast<std::ptrdiff_t>(f_block_size))
+		{
+			continue;
+		}
+
+		std::size_t size;
+		if(!header_checksum_ok(header) || !header_number(header + f_size_offset, f_size_size, &size)
+				|| size > m_size - offset)
+		{
+			std::cerr << "ERROR: Corrupt tar archive header at offset " << offset - f_block_size << std::endl;
+			return false;
+		}
+		const unsigned char *contents = m_data + offset;
+		offset += (size + f_block_size - 1) / f_block_size * f_block_size;
+
+		char typeflag = header[f_typeflag_offset];
+
+		if(typeflag == 'L')
+		{
+			// GNU long name.  The contents are the name of the next entry.
+			long_name = header_string(contents, size);
+			continue;
+		}
+		else if(typeflag == 'x')
+		{
+			// POSIX extended header.  The only record we care about is the name.
+			long_name = pax_path(std::string(contents, contents + size));
+			continue;
+		}
+
+		// Work out the name of this entry.
+		std::string name = long_name;
+		long_name.clear();
+		if(name.empty())
+		{
+			name = header_string(header + f_name_offset, f_name_size);
+			if(header_string(header + f_magic_offset, 5) == "ustar")
+			{
+				std::string prefix = header_string(header + f_prefix_offset, f_prefix_size);
+				if(!prefix.empty())
+				{
+					name = prefix + "/" + name;
+				}
+			}
+		}
+
+		if(typeflag != '0' && typeflag != '\0' && typeflag != '5')
+		{
+			// Not a regular file or a directory.
+			continue;
+		}
+
+		if(!is_safe_path(name))
+		{
+			std::cerr << "ERROR: Refusing to extract \"" << name << "\" outside of " << output_dir << std::endl;
+			return false;
+		}
+
+		boost::filesystem::path path = output_dir / name;
+		boost::system::error_code ec;
+
+		if(typeflag == '5')
+		{
+			boost::filesystem::create_directories(path, ec);
+			if(ec)
+			{
+				std::cerr << "ERROR: Couldn't create directory " << path << ": " << ec.message() << std::endl;
+				return false;
+			}
+			continue;
+		}
+
+		if(path.has_parent_path())
+		{
+			boost::filesystem::create_directories(path.parent_path(), ec);
+		}
+
+		bool skipped;
+		if(!WriteFileIfChanged(path, contents, size, &skipped))
+		{
+			std::cerr << "ERROR: Couldn't write " << path << std::endl;
+			return false;
+		}
+		++(skipped ? *num_files_skipped : *num_files_written);
+	}
+
+	return true;
+}
+
+bool TarArchive::WriteFileIfChanged(const boost::filesystem::path &path, const unsigned char *contents,
+		std::size_t size, bool *skipped)
+{
+	*skipped = false;
+
+	// Compare with what's already there, if anything.  Checking the size first means we only have to read files
+	// which are likely to match.
+	boost::system::error_code ec;
+	if(boost::filesystem::is_regular_file(path, ec) && boost::filesystem::file_size(path, ec) == size && !ec)
+	{
+		std::ifstream existing(path.string().c_str(), std::ios::binary);
+		std::vector<char> buffer(64 * 1024);
+		std::size_t compared = 0;
+
+		while(compared < size && existing)
+		{
+			existing.read(&buffer[0], std::min(buffer.size(), size - compared));
+			std::size_t num_read = existing.gcount();
+			if(num_read == 0 || !std::equal(buffer.begin(), buffer.begin() + num_read,
+					reinterpret_cast<const char*>(contents) + compared))
+			{
+				break;
+			}
+			compared += num_read;
+		}
+
+		if(compared == size)
+		{
+			*skipped = true;
+			return true;
+		}
+	}
+
+	std::ofstream outfile(path.string().c_str(), std::ios::binary | std::ios::trunc);
+	outfile.write(reinterpret_cast<const char*>(contents), size);
+	outfile.close();
+
+	return !outfile.fail();
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#ifndef TARARCHIVE_H_
+#define TARARCHIVE_H_
+
+#include <cstddef>
+#include <string>
+
+#include <boost/filesystem/path.hpp>
+
+/**
+ * Reader for a tar archive held in memory, such as the report boilerplate files compiled into the binary.
+ *
+ * Handles the ustar format, and the GNU and POSIX pax extensions for long names, which covers anything GNU tar
+ * creates.  Only regular files and directories are extracted.  Links, devices and so on are skipped, as are
+ * owners, permissions and timestamps.
+ */
+class TarArchive
+{
+public:
+	/**
+	 * @param data  The archive.  It isn't copied, so it must outlive this object.
+	 * @param size  The size of the archive in bytes.
+	 */
+	TarArchive(const unsigned char *data, std::size_t size);
+	~TarArchive();
+
+	/**
+	 * Extract the archive into @a output_dir, creating any directories needed.  Files which already exist with
+	 * identical contents aren't rewritten.
+	 *
+	 * @param output_dir  The directory to extract into.
+	 * @param[out] num_files_written  Set to the number of files written.
+	 * @param[out] num_files_skipped  Set to the number of files which were already up to date.
+	 *
+	 * @return true on success, false if the archive is corrupt, contains a path which would end up outside
+	 *         @a output_dir, or a file couldn't be written.  The reason is reported on stderr.
+	 */
+	bool ExtractTo(const boost::filesystem::path &output_dir, long *num_files_written, long *num_files_skipped) const;
+
+private:
+
+	/**
+	 * Write @a size bytes at @a contents to @a path, unless it already holds exactly that.
+	 *
+	 * @param[out] skipped  Set to true if the file was already up to date.
+	 * @return true on success.
+	 */
+	static bool WriteFileIfChanged(const boost::filesystem::path &path, const unsigned char *contents,
+			std::size_t size, bool *skipped);
+
+	/// The archive.
+	const unsigned char *m_data;
+
+	/// Its size.
+	std::size_t m_size;
+};
+
+#endif /* TARARCHIVE_H_ */
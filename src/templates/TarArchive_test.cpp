@@ -0,0 +1,133 @@
+/*
+ * Copyright 2012 Gary R. Van Sickle (grvs@users.sourceforge.net).
+ *
+ * This file is part of CoFlo.
+ *
+ * CoFlo is free software: you can redistribute it and/or modify it under the
+ * terms of version 3 of the GNU General Public License as published by the Free
+ * Software Foundation.
+ *
+ * CoFlo is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * CoFlo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file */
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "TarArchive.h"
+
+/// Scratch directory the tests extract into.
+static const char f_test_dir[] = "TarArchive_test.dir";
+
+/**
+ * Append a tar entry named @a name with contents @a contents to @a archive.
+ */
+static void append_entry(std::vector<unsigned char> *archive, const std::string &name, char typeflag,
+		const std::string &contents)
+{
+	std::vector<unsigned char> header(512, 0);
+
+	std::memcpy(&header[0], name.c_str(), name.size());
+	std::sprintf(reinterpret_cast<char*>(&header[100]), "%07o", 0644);
+	std::sprintf(reinterpret_cast<char*>(&header[124]), "%011lo", static_cast<unsigned long>(contents.size()));
+	header[156] = typeflag;
+	std::memcpy(&header[257], "ustar", 6);
+	std::memcpy(&header[263], "00", 2);
+
+	unsigned long checksum = 8 * ' ';
+	for(std::size_t i = 0; i < header.size(); ++i)
+	{
+		checksum += header[i];
+	}
+	std::sprintf(reinterpret_cast<char*>(&header[148]), "%06lo", checksum);
+	header[155] = ' ';
+
+	archive->insert(archive->end(), header.begin(), header.end());
+	archive->insert(archive->end(), contents.begin(), contents.end());
+	archive->resize((archive->size() + 511) / 512 * 512, 0);
+}
+
+static std::string read_file(const boost::filesystem::path &path)
+{
+	std::ifstream infile(path.string().c_str());
+	std::stringstream ss;
+	ss << infile.rdbuf();
+	return ss.str();
+}
+
+TEST(TarArchiveTest, ExtractsAndSkipsUnchangedFiles)
+{
+	std::vector<unsigned char> archive;
+	std::string long_name = std::string(120, 'x') + ".js";
+	long num_written, num_skipped;
+
+	append_entry(&archive, "css/", '5', "");
+	append_entry(&archive, "css/index.css", '0', "body { }\n");
+	append_entry(&archive, "././@LongLink", 'L', "js/" + long_name);
+	append_entry(&archive, "js/truncated", '0', std::string(1000, 'j'));
+	// Two zero blocks at the end of the first archive, then a concatenated one.
+	archive.resize(archive.size() + 1024, 0);
+	append_entry(&archive, "README", '0', "");
+	archive.resize(archive.size() + 1024, 0);
+
+	boost::filesystem::remove_all(f_test_dir);
+	TarArchive tar(&archive[0], archive.size());
+	ASSERT_TRUE(tar.ExtractTo(f_test_dir, &num_written, &num_skipped));
+	ASSERT_EQ(3, num_written);
+	ASSERT_EQ(0, num_skipped);
+	ASSERT_EQ("body { }\n", read_file(boost::filesystem::path(f_test_dir) / "css/index.css"));
+	ASSERT_EQ(std::string(1000, 'j'), read_file(boost::filesystem::path(f_test_dir) / "js" / long_name));
+	ASSERT_TRUE(boost::filesystem::exists(boost::filesystem::path(f_test_dir) / "README"));
+
+	// Change one file.  Only it gets rewritten.
+	{
+		std::ofstream changed((boost::filesystem::path(f_test_dir) / "css/index.css").string().c_str());
+		changed << "body { color: red; }\n";
+	}
+	ASSERT_TRUE(tar.ExtractTo(f_test_dir, &num_written, &num_skipped));
+	ASSERT_EQ(1, num_written);
+	ASSERT_EQ(2, num_skipped);
+	ASSERT_EQ("body { }\n", read_file(boost::filesystem::path(f_test_dir) / "css/index.css"));
+
+	boost::filesystem::remove_all(f_test_dir);
+}
+
+TEST(TarArchiveTest, RejectsBadArchives)
+{
+	std::vector<unsigned char> archive;
+	long num_written, num_skipped;
+
+	boost::filesystem::remove_all(f_test_dir);
+
+	// Escapes the output directory.
+	append_entry(&archive, "../escaped", '0', "x");
+	ASSERT_FALSE(TarArchive(&archive[0], archive.size()).ExtractTo(f_test_dir, &num_written, &num_skipped));
+	ASSERT_FALSE(boost::filesystem::exists("escaped"));
+
+	// Bad checksum.
+	archive.clear();
+	append_entry(&archive, "file", '0', "x");
+	archive[0] = 'g';
+	ASSERT_FALSE(TarArchive(&archive[0], archive.size()).ExtractTo(f_test_dir, &num_written, &num_skipped));
+
+	// Truncated.
+	archive.clear();
+	append_entry(&archive, "file", '0', std::string(1000, 'x'));
+	ASSERT_FALSE(TarArchive(&archive[0], 1024).ExtractTo(f_test_dir, &num_written, &num_skipped));
+
+	boost::filesystem::remove_all(f_test_dir);
+}